@@ -3,8 +3,15 @@
 #include "version.h"
 #include "burnint.h"
 #include "burn_sound.h"
+#include "burn_band.h"
+#include "burn_sched.h"
+#include "burn_trace.h"
 #include "driverlist.h"
 
+#if !defined (_WIN32)
+ #include <sys/time.h>
+#endif
+
 // filler function, used if the application is not printing debug messages
 static INT32 __cdecl BurnbprintfFiller(INT32, TCHAR* , ...) { return 0; }
 // pointer to burner printing function
@@ -615,6 +622,7 @@ extern "C" INT32 BurnDrvInit()
 	HiscoreInit();
 	BurnStateInit();	
 	BurnInitMemoryManager();
+	BurnRomRegionReset();
 
 	nReturnValue = pDriver[nBurnDrvActive]->Init();	// Forward to drivers function
 
@@ -661,8 +669,12 @@ extern "C" INT32 BurnDrvExit()
 	pBurnDrvPalette = NULL;	
 	
 	INT32 nRet = pDriver[nBurnDrvActive]->Exit();			// Forward to drivers function
+
+	BurnBandExit();
+	BurnSchedExit();
 	
 	BurnExitMemoryManager();
+	BurnRomRegionReset();
 #if defined FBA_DEBUG
 	DebugTrackerExit();
 #endif
@@ -706,6 +718,8 @@ INT32 BurnDrvCartridgeSetup(BurnCartrigeCommand nCommand)
 // Do one frame of game emulation
 extern "C" INT32 BurnDrvFrame()
 {
+	BURN_TRACE_SCOPE("BurnDrvFrame", "frame");
+
 	CheatApply();									// Apply cheats (if any)
 	HiscoreApply();
 	return pDriver[nBurnDrvActive]->Frame();		// Forward to drivers function
@@ -763,6 +777,21 @@ INT32 BurnUpdateProgress(double fProgress, const TCHAR* pszText, bool bAbs)
 
 // ----------------------------------------------------------------------------
 
+// Wall clock in microseconds, for timing stats (only differences are meaningful)
+UINT64 BurnGetTicks()
+{
+#if !defined (_WIN32)
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+
+	return (UINT64)tv.tv_sec * 1000000 + tv.tv_usec;
+#else
+	return (UINT64)clock() * 1000000 / CLOCKS_PER_SEC;
+#endif
+}
+
+// ----------------------------------------------------------------------------
+
 INT32 BurnSetRefreshRate(double dFrameRate)
 {
 	if (!bForce60Hz) {
@@ -204,6 +204,9 @@ struct BurnDIPInfo {
 
 extern bool bBurnUseMMX;
 extern bool bBurnUseASMCPUEmulation;
+extern INT32 nSh2BlockCacheMode;			// SH-2 block cache: 0 = off, 1 = on, 2 = on and checked against the interpreter's fetch
+extern INT32 nZetDecodeCacheMode;			// Z80 decode cache: 0 = off, 1 = on, 2 = on and checked against a fresh fetch
+extern INT32 nArm7DecodeCacheMode;			// ARM7 decode cache: 0 = off, 1 = on, 2 = on and checked against a fresh fetch
 
 extern UINT32 nFramesEmulated;
 extern UINT32 nFramesRendered;
@@ -211,6 +214,10 @@ extern clock_t starttime;					// system time when emulation started and after ro
 
 extern bool bForce60Hz;
 extern bool bBurnUseBlend;
+extern INT32 nBurnBandThreads;				// Threads used by band-parallel renderers (0/1 = serial)
+extern INT32 nBurnSchedMode;				// Cpu scheduler for converted drivers: 0 = fixed interleave, 1 = event driven
+extern INT32 nSnesSpcCatchUp;				// SNES sound cpu: 0 = run in lockstep with the 65816, 1 = catch up when the 65816 talks to it
+extern INT32 nSknsSpriteCacheSize;			// Super Kaneko Nova decoded sprite cache in KB (0 = off)
 
 extern INT32 nBurnFPS;
 extern INT32 nBurnCPUSpeedAdjust;
@@ -262,6 +269,8 @@ INT32 BurnDrvGetPaletteEntries();
 INT32 BurnSetProgressRange(double dProgressRange);
 INT32 BurnUpdateProgress(double dProgressStep, const TCHAR* pszText, bool bAbs);
 
+UINT64 BurnGetTicks();
+
 void BurnLocalisationSetName(char *szName, TCHAR *szLongName);
 
 // ---------------------------------------------------------------------------
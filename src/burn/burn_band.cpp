@@ -0,0 +1,197 @@
+// Band-parallel rendering helper
+
+#include "burnint.h"
+#include "burn_band.h"
+
+#if !defined (_WIN32)
+ #include <pthread.h>
+ #define BAND_THREADED
+#endif
+
+INT32 nBurnBandThreads = 0;					// Number of threads to render with (0/1 = serial)
+
+static BurnBandCallback pBandCallback = NULL;
+
+static INT32 nBandCount = 0;
+static INT32 nBandStart[BURN_BAND_MAX_THREADS];
+static INT32 nBandEnd[BURN_BAND_MAX_THREADS];
+
+static UINT32 nBandTime[BURN_BAND_MAX_THREADS];
+static UINT64 nBandTimeTotal[BURN_BAND_MAX_THREADS];
+static UINT32 nBandRuns[BURN_BAND_MAX_THREADS];
+
+static void BandRender(INT32 nBand)
+{
+	UINT64 nTicks = BurnGetTicks();
+
+	pBandCallback(nBand, nBandStart[nBand], nBandEnd[nBand]);
+
+	nBandTime[nBand] = (UINT32)(BurnGetTicks() - nTicks);
+	nBandTimeTotal[nBand] += nBandTime[nBand];
+	nBandRuns[nBand]++;
+}
+
+#if defined (BAND_THREADED)
+
+static pthread_t BandThread[BURN_BAND_MAX_THREADS];
+static INT32 nBandThreadCount = 0;
+
+static pthread_mutex_t BandMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t BandStartCond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t BandDoneCond = PTHREAD_COND_INITIALIZER;
+
+static INT32 nBandNext = 0;					// Next band waiting for a thread
+static INT32 nBandPending = 0;				// Bands that haven't finished yet
+static bool bBandQuit = false;
+
+// Claim and render bands until none are left; called with BandMutex held
+static void BandRenderQueued()
+{
+	while (nBandNext < nBandCount) {
+		INT32 nBand = nBandNext++;
+
+		pthread_mutex_unlock(&BandMutex);
+		BandRender(nBand);
+		pthread_mutex_lock(&BandMutex);
+
+		if (--nBandPending == 0) {
+			pthread_cond_signal(&BandDoneCond);
+		}
+	}
+}
+
+static void* BandWorker(void*)
+{
+	pthread_mutex_lock(&BandMutex);
+
+	while (1) {
+		while (!bBandQuit && nBandNext >= nBandCount) {
+			pthread_cond_wait(&BandStartCond, &BandMutex);
+		}
+
+		if (bBandQuit) {
+			break;
+		}
+
+		BandRenderQueued();
+	}
+
+	pthread_mutex_unlock(&BandMutex);
+
+	return NULL;
+}
+
+static void BandStartThreads(INT32 nThreads)
+{
+	while (nBandThreadCount < nThreads) {
+		if (pthread_create(&BandThread[nBandThreadCount], NULL, BandWorker, NULL)) {
+			bprintf(PRINT_ERROR, _T("BurnBand: couldn't create render thread %d.\n"), nBandThreadCount);
+			break;
+		}
+		nBandThreadCount++;
+	}
+}
+
+#endif
+
+INT32 BurnBandCount(INT32 nStart, INT32 nEnd)
+{
+#if defined (BAND_THREADED)
+	INT32 nCount = nBurnBandThreads;
+
+	if (nCount > BURN_BAND_MAX_THREADS) {
+		nCount = BURN_BAND_MAX_THREADS;
+	}
+
+	while (nCount > 1 && (nEnd - nStart) / nCount < BURN_BAND_MIN_LINES) {
+		nCount--;
+	}
+
+	return (nCount > 1) ? nCount : 1;
+#else
+	return 1;
+#endif
+}
+
+void BurnBandRun(BurnBandCallback pCallback, INT32 nStart, INT32 nEnd)
+{
+	INT32 nCount = BurnBandCount(nStart, nEnd);
+	INT32 nLines = nEnd - nStart;
+
+	pBandCallback = pCallback;
+
+	for (INT32 i = 0; i < nCount; i++) {
+		nBandStart[i] = nStart + nLines * i / nCount;
+		nBandEnd[i]   = nStart + nLines * (i + 1) / nCount;
+	}
+
+#if defined (BAND_THREADED)
+	if (nCount > 1) {
+		BandStartThreads(nCount - 1);
+
+		pthread_mutex_lock(&BandMutex);
+
+		nBandCount = nCount;
+		nBandNext = 0;
+		nBandPending = nCount;
+		pthread_cond_broadcast(&BandStartCond);
+
+		// The calling thread renders bands too, then waits for the stragglers
+		BandRenderQueued();
+
+		while (nBandPending) {
+			pthread_cond_wait(&BandDoneCond, &BandMutex);
+		}
+
+		pthread_mutex_unlock(&BandMutex);
+
+		return;
+	}
+#endif
+
+	nBandCount = nCount;
+	for (INT32 i = 0; i < nCount; i++) {
+		BandRender(i);
+	}
+}
+
+UINT32 BurnBandGetTime(INT32 nBand)
+{
+	if (nBand < 0 || nBand >= BURN_BAND_MAX_THREADS) {
+		return 0;
+	}
+
+	return nBandTime[nBand];
+}
+
+void BurnBandExit()
+{
+#if defined (BAND_THREADED)
+	if (nBandThreadCount) {
+		pthread_mutex_lock(&BandMutex);
+		bBandQuit = true;
+		pthread_cond_broadcast(&BandStartCond);
+		pthread_mutex_unlock(&BandMutex);
+
+		for (INT32 i = 0; i < nBandThreadCount; i++) {
+			pthread_join(BandThread[i], NULL);
+		}
+
+		nBandThreadCount = 0;
+		bBandQuit = false;
+	}
+#endif
+
+	for (INT32 i = 0; i < BURN_BAND_MAX_THREADS; i++) {
+		if (nBandRuns[i]) {
+			bprintf(PRINT_NORMAL, _T("    Band %d: %d runs, %d us average.\n"), i, nBandRuns[i], (INT32)(nBandTimeTotal[i] / nBandRuns[i]));
+		}
+
+		nBandTime[i] = 0;
+		nBandTimeTotal[i] = 0;
+		nBandRuns[i] = 0;
+	}
+
+	nBandCount = 0;
+	pBandCallback = NULL;
+}
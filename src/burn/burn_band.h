@@ -0,0 +1,26 @@
+// Band-parallel rendering helper
+//
+// Splits a range of screen lines into horizontal bands and renders them on a
+// small pool of worker threads. The caller's thread always renders one band
+// itself. With nBurnBandThreads <= 1 (or on platforms without pthreads) every
+// band runs serially on the calling thread, in order.
+
+#define BURN_BAND_MAX_THREADS	8
+#define BURN_BAND_MIN_LINES		8		// don't bother splitting bands smaller than this
+
+// Per-thread storage for renderer state that has to be private to a band
+#if defined (_MSC_VER)
+ #define BURN_BAND_TLS __declspec(thread)
+#else
+ #define BURN_BAND_TLS __thread
+#endif
+
+// nBand is 0-based, nStart/nEnd are a half-open line range
+typedef void (*BurnBandCallback)(INT32 nBand, INT32 nStart, INT32 nEnd);
+
+INT32 BurnBandCount(INT32 nStart, INT32 nEnd);
+void BurnBandRun(BurnBandCallback pCallback, INT32 nStart, INT32 nEnd);
+void BurnBandExit();
+
+// Time (in microseconds) the last run of each band took, for profiling
+UINT32 BurnBandGetTime(INT32 nBand);
@@ -9,6 +9,7 @@
 #define MAX_MEM_PTR	0x400 // more than 1024 malloc calls should be insane...
 
 static UINT8 *memptr[MAX_MEM_PTR]; // pointer to allocated memory
+static INT32 memsize[MAX_MEM_PTR];
 
 // this should be called early on... BurnDrvInit?
 
@@ -34,6 +35,7 @@ UINT8 *BurnMalloc(INT32 size)
 			}
 
 			memset (memptr[i], 0, size); // set contents to 0
+			memsize[i] = size;
 
 			return memptr[i];
 		}
@@ -52,6 +54,7 @@ void _BurnFree(void *ptr)
 	for (INT32 i = 0; i < MAX_MEM_PTR; i++)
 	{
 		if (memptr[i] == mptr) {
+			BurnRomRegionFree(memptr[i], memsize[i]);	// roms loaded here are gone
 			free (memptr[i]);
 			memptr[i] = NULL;
 
@@ -0,0 +1,308 @@
+// Event-driven cpu scheduler
+
+#include "burnint.h"
+#include "burn_sched.h"
+#include "m68000_intf.h"
+#include "z80_intf.h"
+#include "nec_intf.h"
+
+INT32 nBurnSchedMode = BURN_SCHED_EVENTS;
+
+struct SchedCpu {
+	void (*pOpen)(INT32);
+	void (*pClose)();
+	INT32 (*pRun)(INT32);					// also tells cores apart, a core can't be run inside itself
+	void (*pRunEnd)();
+	INT32 (*pTotalCycles)();
+
+	INT32 nCpu;
+	INT32 nCyclesTotal;						// per frame
+	INT32 nCyclesDone;						// this frame, not counting a slice that is running
+	INT32 nRunStart;						// pTotalCycles() when the running slice started
+	INT32 bRunning;
+	INT32 bHalted;
+};
+
+struct SchedEvent {
+	INT32 nTime;
+	BurnSchedEventCallback pCallback;
+	INT32 nParam;
+};
+
+static SchedCpu SchedCpus[BURN_SCHED_MAX_CPUS];
+static INT32 nSchedCpuCount = 0;
+
+static SchedEvent SchedEvents[BURN_SCHED_MAX_EVENTS];
+static INT32 nSchedEventCount = 0;
+static INT32 nSchedEventNext = 0;			// first event that hasn't fired yet
+
+static INT32 nSchedInterleave = 1;
+static INT32 nSchedMaxSlice = 0;
+static INT32 nSchedSyncGap = 0;
+
+static INT32 nSchedRunning = -1;			// outermost cpu running a slice
+static INT32 nSchedDepth = 0;
+static INT32 bSchedSliceEnded = 0;
+static INT32 nSchedLastSync = 0;
+
+static INT32 nSchedSwitches = 0;			// slices run this frame
+static UINT32 nStatFrames = 0;
+static UINT64 nStatSwitches = 0;
+static UINT64 nStatTicks = 0;
+
+void BurnSchedInit(INT32 nInterleave)
+{
+	memset(SchedCpus, 0, sizeof(SchedCpus));
+	nSchedCpuCount = 0;
+	nSchedEventCount = 0;
+	nSchedEventNext = 0;
+
+	nSchedInterleave = (nInterleave > 0) ? nInterleave : 1;
+	nSchedMaxSlice = 0;
+	nSchedSyncGap = 0;
+
+	nSchedRunning = -1;
+	nSchedDepth = 0;
+	bSchedSliceEnded = 0;
+
+	nStatFrames = 0;
+	nStatSwitches = 0;
+	nStatTicks = 0;
+}
+
+void BurnSchedExit()
+{
+	if (nStatFrames) {
+		bprintf(PRINT_NORMAL, _T("    Scheduler (%s): %d frames, %d.%02d slices per frame, %d us per frame.\n"), (nBurnSchedMode == BURN_SCHED_FIXED) ? _T("fixed") : _T("events"), nStatFrames, (INT32)(nStatSwitches / nStatFrames), (INT32)(nStatSwitches * 100 / nStatFrames % 100), (INT32)(nStatTicks / nStatFrames));
+	}
+
+	nSchedCpuCount = 0;
+	nSchedEventCount = 0;
+	nStatFrames = 0;
+}
+
+static INT32 SchedAttach(void (*pOpen)(INT32), void (*pClose)(), INT32 (*pRun)(INT32), void (*pRunEnd)(), INT32 (*pTotalCycles)(), INT32 nCpu)
+{
+	if (nSchedCpuCount >= BURN_SCHED_MAX_CPUS) {
+		bprintf(PRINT_ERROR, _T("BurnSched: too many cpus attached.\n"));
+		return BURN_SCHED_MAX_CPUS - 1;
+	}
+
+	SchedCpu *c = &SchedCpus[nSchedCpuCount];
+
+	c->pOpen = pOpen;
+	c->pClose = pClose;
+	c->pRun = pRun;
+	c->pRunEnd = pRunEnd;
+	c->pTotalCycles = pTotalCycles;
+	c->nCpu = nCpu;
+	c->nCyclesTotal = 1;
+
+	return nSchedCpuCount++;
+}
+
+INT32 BurnSchedAttachSek(INT32 nCpu)
+{
+	return SchedAttach(SekOpen, SekClose, SekRun, SekRunEnd, SekTotalCycles, nCpu);
+}
+
+INT32 BurnSchedAttachZet(INT32 nCpu)
+{
+	return SchedAttach(ZetOpen, ZetClose, ZetRun, ZetRunEnd, ZetTotalCycles, nCpu);
+}
+
+INT32 BurnSchedAttachVez(INT32 nCpu)
+{
+	return SchedAttach(VezOpen, VezClose, VezRun, VezRunEnd, VezTotalCycles, nCpu);
+}
+
+INT32 BurnSchedAttachCpu(cpu_core_config *pConfig, INT32 nCpu)
+{
+	return SchedAttach(pConfig->open, pConfig->close, pConfig->run, pConfig->runend, pConfig->totalcycles, nCpu);
+}
+
+void BurnSchedSetCycles(INT32 nIndex, INT32 nCyclesPerFrame)
+{
+	SchedCpus[nIndex].nCyclesTotal = (nCyclesPerFrame > 0) ? nCyclesPerFrame : 1;
+}
+
+void BurnSchedSetHalt(INT32 nIndex, INT32 bHalt)
+{
+	SchedCpus[nIndex].bHalted = bHalt;
+}
+
+void BurnSchedSetMaxSlice(INT32 nCycles)
+{
+	nSchedMaxSlice = nCycles;
+}
+
+void BurnSchedSetSyncGap(INT32 nCycles)
+{
+	nSchedSyncGap = nCycles;
+}
+
+void BurnSchedAddEvent(INT32 nTime, BurnSchedEventCallback pCallback, INT32 nParam)
+{
+	if (nSchedEventCount >= BURN_SCHED_MAX_EVENTS) {
+		bprintf(PRINT_ERROR, _T("BurnSched: too many events this frame.\n"));
+		return;
+	}
+
+	// keep the list sorted, events at the same time fire in the order they were added
+	INT32 i = nSchedEventCount++;
+	while (i > nSchedEventNext && SchedEvents[i - 1].nTime > nTime) {
+		SchedEvents[i] = SchedEvents[i - 1];
+		i--;
+	}
+
+	SchedEvents[i].nTime = nTime;
+	SchedEvents[i].pCallback = pCallback;
+	SchedEvents[i].nParam = nParam;
+}
+
+// Cpu cycles <-> lead cpu cycles
+static inline INT32 SchedToCpu(INT32 nIndex, INT32 nTime)
+{
+	return (INT64)nTime * SchedCpus[nIndex].nCyclesTotal / SchedCpus[0].nCyclesTotal;
+}
+
+static inline INT32 SchedFromCpu(INT32 nIndex, INT32 nCycles)
+{
+	return (INT64)nCycles * SchedCpus[0].nCyclesTotal / SchedCpus[nIndex].nCyclesTotal;
+}
+
+INT32 BurnSchedTotalCycles(INT32 nIndex)
+{
+	SchedCpu *c = &SchedCpus[nIndex];
+
+	if (c->bRunning) {
+		return c->nCyclesDone + c->pTotalCycles() - c->nRunStart;
+	}
+
+	return c->nCyclesDone;
+}
+
+static void SchedRunCpu(INT32 nIndex, INT32 nTime)
+{
+	SchedCpu *c = &SchedCpus[nIndex];
+	INT32 nCycles = SchedToCpu(nIndex, nTime) - c->nCyclesDone;
+
+	if (nCycles <= 0) return;
+
+	if (c->bHalted) {
+		c->nCyclesDone += nCycles;
+		return;
+	}
+
+	c->pOpen(c->nCpu);
+
+	c->bRunning = 1;
+	c->nRunStart = c->pTotalCycles();
+	c->pRun(nCycles);
+	c->nCyclesDone += c->pTotalCycles() - c->nRunStart;
+	c->bRunning = 0;
+
+	c->pClose();
+
+	nSchedSwitches++;
+}
+
+void BurnSchedSync()
+{
+	if (nBurnSchedMode == BURN_SCHED_FIXED || nSchedRunning < 0 || nSchedDepth > 1) return;
+
+	INT32 nRunning = nSchedRunning;
+	INT32 nNow = SchedFromCpu(nRunning, BurnSchedTotalCycles(nRunning));
+
+	if (nNow - nSchedLastSync < nSchedSyncGap) return;
+
+	nSchedLastSync = nNow;
+
+	// Only the cpus after this one are behind it. If one of them shares this cpu's core it
+	// can't be run from in here, so end this slice early and let the round catch them up.
+	for (INT32 i = nRunning + 1; i < nSchedCpuCount; i++) {
+		if (SchedCpus[i].pRun == SchedCpus[nRunning].pRun && !SchedCpus[i].bHalted) {
+			SchedCpus[nRunning].pRunEnd();
+			bSchedSliceEnded = 1;
+			return;
+		}
+	}
+
+	nSchedDepth++;
+	for (INT32 i = nRunning + 1; i < nSchedCpuCount; i++) {
+		SchedRunCpu(i, nNow);
+	}
+	nSchedDepth--;
+}
+
+void BurnSchedFrame()
+{
+	UINT64 nTicks = BurnGetTicks();
+	INT32 nFrame = SchedCpus[0].nCyclesTotal;
+	INT32 nNow = 0;
+	INT32 nSlice = 0;
+
+	for (INT32 i = 0; i < nSchedCpuCount; i++) {
+		SchedCpus[i].nCyclesDone = 0;
+	}
+
+	nSchedSwitches = 0;
+	nSchedEventNext = 0;
+
+	while (nNow < nFrame || nSchedEventNext < nSchedEventCount) {
+		INT32 nTarget = nFrame;
+
+		if (nBurnSchedMode == BURN_SCHED_FIXED) {
+			while (nSlice < nSchedInterleave && (INT64)(nSlice + 1) * nFrame / nSchedInterleave <= nNow) nSlice++;
+			nTarget = (INT64)(nSlice + 1) * nFrame / nSchedInterleave;
+		} else if (nSchedMaxSlice > 0 && nNow + nSchedMaxSlice < nTarget) {
+			nTarget = nNow + nSchedMaxSlice;
+		}
+
+		if (nTarget > nFrame) {
+			nTarget = nFrame;
+		}
+
+		if (nSchedEventNext < nSchedEventCount && SchedEvents[nSchedEventNext].nTime < nTarget) {
+			nTarget = SchedEvents[nSchedEventNext].nTime;
+		}
+
+		if (nTarget > nNow) {
+			nSchedLastSync = nNow;
+
+			for (INT32 i = 0; i < nSchedCpuCount; i++) {
+				bSchedSliceEnded = 0;
+				nSchedRunning = i;
+				nSchedDepth = 1;
+
+				SchedRunCpu(i, nTarget);
+
+				nSchedRunning = -1;
+				nSchedDepth = 0;
+
+				// a sync cut this slice short, the rest only need to get as far as it did
+				if (bSchedSliceEnded) {
+					INT32 nReached = SchedFromCpu(i, SchedCpus[i].nCyclesDone);
+					if (nReached < nTarget) {
+						nTarget = (nReached > nNow) ? nReached : nNow + 1;
+					}
+				}
+			}
+
+			nNow = nTarget;
+		}
+
+		// events at or past the end of the frame fire when it ends
+		while (nSchedEventNext < nSchedEventCount && (SchedEvents[nSchedEventNext].nTime <= nNow || nNow >= nFrame)) {
+			SchedEvent e = SchedEvents[nSchedEventNext++];
+			e.pCallback(e.nParam);
+		}
+	}
+
+	nSchedEventCount = 0;
+	nSchedEventNext = 0;
+
+	nStatFrames++;
+	nStatSwitches += nSchedSwitches;
+	nStatTicks += BurnGetTicks() - nTicks;
+}
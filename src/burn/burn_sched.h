@@ -0,0 +1,46 @@
+// Event-driven cpu scheduler
+//
+// Replaces a driver's hand-rolled nInterleave loop. Each cpu is run up to the
+// next point where something can pass between cpus (a scheduled event, or a
+// sync requested from a memory handler) instead of at fixed slices.
+//
+// The first cpu attached leads: every round it runs first, then the others
+// catch up to where it got to. Writes the lead cpu makes are seen by the others
+// at the right time; anything the others write is seen by the lead cpu at the
+// next sync, so attach the cpu that drives the rest first.
+//
+// Times given to the scheduler are in cycles of the lead cpu from the start of
+// the frame.
+
+#define BURN_SCHED_MAX_CPUS		8
+#define BURN_SCHED_MAX_EVENTS	64
+
+#define BURN_SCHED_FIXED		0		// old behaviour: nInterleave fixed slices, syncs ignored
+#define BURN_SCHED_EVENTS		1		// run between events and syncs only
+
+typedef void (*BurnSchedEventCallback)(INT32 nParam);
+
+void BurnSchedInit(INT32 nInterleave);	// nInterleave is only used by BURN_SCHED_FIXED
+void BurnSchedExit();
+
+// Attach a cpu, returns its scheduler index (the first one attached is 0)
+INT32 BurnSchedAttachSek(INT32 nCpu);
+INT32 BurnSchedAttachZet(INT32 nCpu);
+INT32 BurnSchedAttachVez(INT32 nCpu);
+INT32 BurnSchedAttachCpu(cpu_core_config *pConfig, INT32 nCpu);
+
+void BurnSchedSetCycles(INT32 nIndex, INT32 nCyclesPerFrame);
+void BurnSchedSetHalt(INT32 nIndex, INT32 bHalt);		// halted cpus only have their cycles counted
+void BurnSchedSetMaxSlice(INT32 nCycles);			// furthest the lead cpu may run ahead (0 = to the next event)
+void BurnSchedSetSyncGap(INT32 nCycles);				// syncs closer than this to the last one are skipped
+
+// Events fire once every cpu has reached nTime, with no cpu open
+void BurnSchedAddEvent(INT32 nTime, BurnSchedEventCallback pCallback, INT32 nParam);
+
+// Call from a memory handler before passing data between cpus
+void BurnSchedSync();
+
+// Cycles run this frame by a cpu, including the part of a slice that is running now
+INT32 BurnSchedTotalCycles(INT32 nIndex);
+
+void BurnSchedFrame();
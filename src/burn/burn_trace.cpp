@@ -0,0 +1,152 @@
+// Span tracing, see burn_trace.h
+
+#include "burnint.h"
+#include "burn_trace.h"
+
+#if defined (BURN_TRACE)
+
+#define TRACE_MAX_EVENTS	(1 << 20)
+
+struct TraceEvent {
+	const char *szName;						// NULL for the end of a span
+	const char *szCategory;
+	UINT64 nTime;							// us, from BurnGetTicks()
+};
+
+INT32 bBurnTraceRecording = 0;
+
+static TraceEvent *TraceEvents = NULL;
+static INT32 nTraceEventCount = 0;
+static INT32 nTraceDropDepth = 0;			// spans opened while the buffer was full
+
+static char szTraceFilename[MAX_PATH];
+static INT32 nTraceFirst = 0;
+static INT32 nTraceCount = 0;
+static INT32 nTraceFrame = -1;
+
+void BurnTraceBegin(const char *szName, const char *szCategory)
+{
+	// keep a little room so every span that was started can still be ended
+	if (nTraceDropDepth || nTraceEventCount >= TRACE_MAX_EVENTS - 256) {
+		nTraceDropDepth++;
+		return;
+	}
+
+	TraceEvent *e = &TraceEvents[nTraceEventCount++];
+	e->szName = szName;
+	e->szCategory = szCategory;
+	e->nTime = BurnGetTicks();
+}
+
+void BurnTraceEnd()
+{
+	if (nTraceDropDepth) {
+		nTraceDropDepth--;
+		return;
+	}
+
+	if (nTraceEventCount >= TRACE_MAX_EVENTS) return;
+
+	TraceEvent *e = &TraceEvents[nTraceEventCount++];
+	e->szName = NULL;
+	e->szCategory = NULL;
+	e->nTime = BurnGetTicks();
+}
+
+static void TraceWrite()
+{
+	char szFile[MAX_PATH];
+
+	// a %s in the name is the driver, so each driver of a -golden run gets its own file
+	const char *pDriver = strstr(szTraceFilename, "%s");
+	if (pDriver) {
+		snprintf(szFile, MAX_PATH, "%.*s%s%s", (INT32)(pDriver - szTraceFilename), szTraceFilename, BurnDrvGetTextA(DRV_NAME), pDriver + 2);
+	} else {
+		strcpy(szFile, szTraceFilename);
+	}
+
+	FILE *fp = fopen(szFile, "wt");
+	if (fp == NULL) {
+		bprintf(PRINT_ERROR, _T("Trace: can't write %hs\n"), szFile);
+		return;
+	}
+
+	UINT64 nStart = nTraceEventCount ? TraceEvents[0].nTime : 0;
+
+	fprintf(fp, "{\"traceEvents\":[\n");
+	for (INT32 i = 0; i < nTraceEventCount; i++) {
+		TraceEvent *e = &TraceEvents[i];
+		unsigned long long t = e->nTime - nStart;
+
+		if (e->szName) {
+			fprintf(fp, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"B\",\"pid\":1,\"tid\":1,\"ts\":%llu}", e->szName, e->szCategory, t);
+		} else {
+			fprintf(fp, "{\"ph\":\"E\",\"pid\":1,\"tid\":1,\"ts\":%llu}", t);
+		}
+		fprintf(fp, (i + 1 < nTraceEventCount) ? ",\n" : "\n");
+	}
+	fprintf(fp, "]}\n");
+
+	fclose(fp);
+
+	bprintf(PRINT_NORMAL, _T("Trace: wrote %d events to %hs\n"), nTraceEventCount, szFile);
+}
+
+INT32 BurnTraceStart(const char *szFilename, INT32 nFirst, INT32 nCount)
+{
+	BurnTraceStop();
+
+	if (nCount <= 0) {
+		return 1;
+	}
+
+	if (TraceEvents == NULL) {
+		TraceEvents = (TraceEvent*)malloc(TRACE_MAX_EVENTS * sizeof(TraceEvent));
+		if (TraceEvents == NULL) {
+			return 1;
+		}
+	}
+
+	strncpy(szTraceFilename, szFilename, MAX_PATH - 1);
+	szTraceFilename[MAX_PATH - 1] = 0;
+
+	nTraceFirst = (nFirst > 0) ? nFirst : 0;
+	nTraceCount = nCount;
+	nTraceFrame = -1;
+	nTraceEventCount = 0;
+	nTraceDropDepth = 0;
+
+	return 0;
+}
+
+void BurnTraceFrame()
+{
+	if (TraceEvents == NULL) return;
+
+	nTraceFrame++;
+
+	if (nTraceFrame == nTraceFirst) {
+		bBurnTraceRecording = 1;
+	}
+
+	if (nTraceFrame == nTraceFirst + nTraceCount) {
+		BurnTraceStop();
+	}
+}
+
+void BurnTraceStop()
+{
+	if (TraceEvents == NULL) return;
+
+	bBurnTraceRecording = 0;
+
+	if (nTraceEventCount) {
+		TraceWrite();
+	}
+
+	free(TraceEvents);
+	TraceEvents = NULL;
+	nTraceEventCount = 0;
+}
+
+#endif
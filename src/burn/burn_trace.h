@@ -0,0 +1,45 @@
+// Span tracing of where a frame's time goes
+//
+// Compiled in with BURN_TRACE defined (make TRACE=1), otherwise every macro
+// here expands to nothing. Spans are only recorded for a chosen range of
+// frames and written out as a Chrome trace-event JSON file, which can be
+// opened with chrome://tracing or ui.perfetto.dev. Spans are recorded on the
+// emulation thread only.
+
+#if defined (BURN_TRACE)
+
+extern INT32 bBurnTraceRecording;
+
+void BurnTraceBegin(const char *szName, const char *szCategory);
+void BurnTraceEnd();
+
+struct BurnTraceScope {
+	INT32 bActive;
+
+	BurnTraceScope(const char *szName, const char *szCategory)
+	{
+		bActive = bBurnTraceRecording;
+		if (bActive) BurnTraceBegin(szName, szCategory);
+	}
+
+	~BurnTraceScope()
+	{
+		if (bActive) BurnTraceEnd();
+	}
+};
+
+// Record frames nFirst to nFirst + nCount - 1 (counted in calls to BurnTraceFrame) to szFilename,
+// where a %s is replaced with the name of the driver
+INT32 BurnTraceStart(const char *szFilename, INT32 nFirst, INT32 nCount);
+// Call at the start of every emulated frame, outside any span
+void BurnTraceFrame();
+// Write out whatever has been recorded, if the range hasn't been finished
+void BurnTraceStop();
+
+#define BURN_TRACE_SCOPE(name, category)	BurnTraceScope BurnTraceScopeVar(name, category)
+
+#else
+
+#define BURN_TRACE_SCOPE(name, category)
+
+#endif
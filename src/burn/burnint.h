@@ -106,6 +106,9 @@ INT32 BurnLoadRomExt(UINT8 *Dest, INT32 i, INT32 nGap, INT32 nFlags);
 INT32 BurnLoadRom(UINT8* Dest, INT32 i, INT32 nGap);
 INT32 BurnXorRom(UINT8 *Dest, INT32 i, INT32 nGap);
 INT32 BurnLoadBitField(UINT8* pDest, UINT8* pSrc, INT32 nField, INT32 nSrcLen);
+void BurnRomRegionReset();
+void BurnRomRegionFree(UINT8* pStart, INT32 nLen);
+INT32 BurnRomRegionCheck(UINT8* pStart, INT32 nLen);
 
 // ---------------------------------------------------------------------------
 // Plotting pixels
@@ -144,6 +147,8 @@ struct cpu_core_config {
 
 	UINT64 nMemorySize;		// how large is our memory range?
 	UINT32 nAddressXor;		// fix endianness for some cpus
+
+	UINT8 * (*memmap)(UINT32);	// byte backed by plain ram (or NULL if it isn't), optional
 };
 
 void CpuCheatRegister(INT32 type, cpu_core_config *config);
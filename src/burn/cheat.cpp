@@ -21,6 +21,16 @@ static struct cheat_core cpus[CHEAT_MAXCPU];
 static cheat_core *cheat_ptr;
 static cpu_core_config *cheat_subptr;
 
+// Active cheats compiled into one list of writes per cpu, rebuilt by CheatUpdate()
+struct cheat_write {
+	UINT32 nAddress;
+	UINT8 nValue;
+};
+
+static cheat_write *pCheatProgram = NULL;
+static INT32 nCheatProgramStart[CHEAT_MAXCPU];
+static INT32 nCheatProgramCount[CHEAT_MAXCPU];
+
 void CpuCheatRegister(INT32 nCPU, cpu_core_config *config)
 {
 	cheat_core *s_ptr = &cpus[cheat_core_init_pointer];
@@ -31,6 +41,71 @@ void CpuCheatRegister(INT32 nCPU, cpu_core_config *config)
 	cheat_core_init_pointer++;
 }
 
+static void CheatProgramExit()
+{
+	if (pCheatProgram) {
+		free(pCheatProgram);
+		pCheatProgram = NULL;
+	}
+
+	memset(nCheatProgramStart, 0, sizeof(nCheatProgramStart));
+	memset(nCheatProgramCount, 0, sizeof(nCheatProgramCount));
+}
+
+static void CheatProgramCompile()
+{
+	INT32 nTotal = 0;
+
+	CheatProgramExit();
+
+	// Count the writes for each cpu, keeping them in cheat order so later cheats still win
+	for (INT32 nPass = 0; nPass < 2; nPass++) {
+		INT32 nPos[CHEAT_MAXCPU];
+
+		if (nPass == 1) {
+			pCheatProgram = (cheat_write*)malloc(nTotal * sizeof(cheat_write));
+			if (pCheatProgram == NULL) {
+				memset(nCheatProgramCount, 0, sizeof(nCheatProgramCount));
+				return;
+			}
+
+			for (INT32 i = 0, nStart = 0; i < CHEAT_MAXCPU; i++) {
+				nCheatProgramStart[i] = nPos[i] = nStart;
+				nStart += nCheatProgramCount[i];
+			}
+		}
+
+		CheatInfo* pCurrentCheat = pCheatInfo;
+		CheatAddressInfo* pAddressInfo;
+
+		while (pCurrentCheat) {
+			if (pCurrentCheat->nStatus > 1) {
+				pAddressInfo = pCurrentCheat->pOption[pCurrentCheat->nCurrent]->AddressInfo;
+				while (pAddressInfo->nAddress) {
+					INT32 nCPU = pAddressInfo->nCPU;
+
+					if (nCPU >= 0 && nCPU < cheat_core_init_pointer) {
+						if (nPass == 0) {
+							nCheatProgramCount[nCPU]++;
+							nTotal++;
+						} else {
+							pCheatProgram[nPos[nCPU]].nAddress = pAddressInfo->nAddress;
+							pCheatProgram[nPos[nCPU]].nValue = pAddressInfo->nValue;
+							nPos[nCPU]++;
+						}
+					}
+					pAddressInfo++;
+				}
+			}
+			pCurrentCheat = pCurrentCheat->pNext;
+		}
+
+		if (nTotal == 0) {
+			return;
+		}
+	}
+}
+
 INT32 CheatUpdate()
 {
 	bCheatsEnabled = false;
@@ -50,6 +125,8 @@ INT32 CheatUpdate()
 		}
 	}
 
+	CheatProgramCompile();
+
 	return 0;
 }
 
@@ -180,34 +257,39 @@ INT32 CheatApply()
 		return 0;
 	}
 
-	INT32 nOpenCPU = -1;
+	if (pCheatProgram == NULL) {
+		return 0;
+	}
 
-	CheatInfo* pCurrentCheat = pCheatInfo;
-	CheatAddressInfo* pAddressInfo;
-	while (pCurrentCheat) {
-		if (pCurrentCheat->nStatus > 1) {
-			pAddressInfo = pCurrentCheat->pOption[pCurrentCheat->nCurrent]->AddressInfo;
-			while (pAddressInfo->nAddress) {
+	for (INT32 nCPU = 0; nCPU < CHEAT_MAXCPU; nCPU++) {
+		if (nCheatProgramCount[nCPU] == 0) {
+			continue;
+		}
 
-				if (pAddressInfo->nCPU != nOpenCPU) {
-					if (nOpenCPU != -1) {
-						cheat_subptr->close();
-					}
+		cheat_write* pWrite = pCheatProgram + nCheatProgramStart[nCPU];
+		cheat_write* pEnd = pWrite + nCheatProgramCount[nCPU];
 
-					nOpenCPU = pAddressInfo->nCPU;
-					cheat_ptr = &cpus[nOpenCPU];
-					cheat_subptr = cheat_ptr->cpuconfig;
-					cheat_subptr->open(cheat_ptr->nCPU);
-				}
+		cheat_ptr = &cpus[nCPU];
+		cheat_subptr = cheat_ptr->cpuconfig;
+		cheat_subptr->open(cheat_ptr->nCPU);
 
-				cheat_subptr->write(pAddressInfo->nAddress, pAddressInfo->nValue);
-				pAddressInfo++;
+		if (cheat_subptr->memmap) {
+			// Poke ram directly, only handlers (and rom) go through the cpu interface
+			for (; pWrite < pEnd; pWrite++) {
+				UINT8* pDest = cheat_subptr->memmap(pWrite->nAddress);
+
+				if (pDest) {
+					*pDest = pWrite->nValue;
+				} else {
+					cheat_subptr->write(pWrite->nAddress, pWrite->nValue);
+				}
+			}
+		} else {
+			for (; pWrite < pEnd; pWrite++) {
+				cheat_subptr->write(pWrite->nAddress, pWrite->nValue);
 			}
 		}
-		pCurrentCheat = pCurrentCheat->pNext;
-	}
 
-	if (nOpenCPU != -1) {
 		cheat_subptr->close();
 	}
 
@@ -244,6 +326,8 @@ void CheatExit()
 
 	memset (cpus, 0, sizeof(cheat_core));
 
+	CheatProgramExit();
+
 	cheat_core_init_pointer = 0;
 
 	pCheatInfo = NULL;
@@ -252,17 +336,55 @@ void CheatExit()
 }
 
 // Cheat search
+//
+// Candidates are kept as a bitmap, one bit per value-sized position in a snapshot of the
+// first cpu's address space. Where that cpu maps the driver's ram areas (ACB_MEMORY_RAM)
+// as plain memory (see memmap() in cpu_core_config) the snapshot is copied straight from
+// them, in the cpu's byte order; otherwise every address is read through the cpu. Either
+// way positions are cpu addresses. Each filter takes a fresh snapshot and compares it with
+// the last one 32 positions at a time.
+
+#include "state.h"
+
+#define CHEATSEARCH_MAXAREAS	64
+#define CHEATSEARCH_MAXCPUSIZE	0x4000000	// don't read a larger address space through the cpu
+#define CHEATSEARCH_MAPBLOCK	0x100		// memmap() pages are at least this large
+
+#define CHEATSEARCH_NOCHANGE	0
+#define CHEATSEARCH_CHANGE		1
+#define CHEATSEARCH_DECREASED	2
+#define CHEATSEARCH_INCREASED	3
+
+struct cheat_search_area {
+	UINT8 *Data;				// NULL when the area is read through the cpu
+	UINT32 nLen;
+	UINT32 nAddress;			// cpu address of offset 0
+	UINT32 nOffset;				// where it starts in the snapshot
+	UINT32 nXor;				// byte swap between Data and the cpu's view of it
+	char *szName;
+};
 
-static UINT8 *MemoryValues = NULL;
-static UINT8 *MemoryStatus = NULL;
-static UINT32 nMemorySize = 0;
-CheatSearchInitCallback CheatSearchInitCallbackFunction = NULL;
+static struct cheat_search_area SearchArea[CHEATSEARCH_MAXAREAS];
+static INT32 nSearchAreas = 0;
+
+static struct BurnArea SearchRam[CHEATSEARCH_MAXAREAS];
+static INT32 nSearchRam = 0;
 
-#define NOT_IN_RESULTS	0
-#define IN_RESULTS	1
+static UINT8 *SearchValues = NULL;		// snapshot the candidates are compared against
+static UINT8 *SearchCurrent = NULL;		// fresh snapshot
+static UINT32 *SearchStatus = NULL;		// candidate bitmap
+static UINT32 nSearchSize = 0;			// bytes in a snapshot
+static UINT32 nSearchPositions = 0;
+
+static INT32 nSearchWidth = 1;
+static bool bSearchBigEndian = false;
+static INT32 nSearchCPU = -1;
+
+CheatSearchInitCallback CheatSearchInitCallbackFunction = NULL;
 
 UINT32 CheatSearchShowResultAddresses[CHEATSEARCH_SHOWRESULTS];
 UINT32 CheatSearchShowResultValues[CHEATSEARCH_SHOWRESULTS];
+char* CheatSearchShowResultAreas[CHEATSEARCH_SHOWRESULTS];
 
 INT32 CheatSearchInit()
 {
@@ -271,209 +393,444 @@ INT32 CheatSearchInit()
 
 void CheatSearchExit()
 {
-	if (MemoryValues) {
-		free(MemoryValues);
-		MemoryValues = NULL;
+	if (SearchValues) {
+		free(SearchValues);
+		SearchValues = NULL;
 	}
-	if (MemoryStatus) {
-		free(MemoryStatus);
-		MemoryStatus = NULL;
+	if (SearchCurrent) {
+		free(SearchCurrent);
+		SearchCurrent = NULL;
 	}
-	
-	nMemorySize = 0;
-	
-	memset(CheatSearchShowResultAddresses, 0, CHEATSEARCH_SHOWRESULTS);
-	memset(CheatSearchShowResultValues, 0, CHEATSEARCH_SHOWRESULTS);
+	if (SearchStatus) {
+		free(SearchStatus);
+		SearchStatus = NULL;
+	}
+
+	nSearchSize = 0;
+	nSearchPositions = 0;
+	nSearchAreas = 0;
+	nSearchCPU = -1;
+
+	memset(CheatSearchShowResultAddresses, 0, sizeof(CheatSearchShowResultAddresses));
+	memset(CheatSearchShowResultValues, 0, sizeof(CheatSearchShowResultValues));
+	memset(CheatSearchShowResultAreas, 0, sizeof(CheatSearchShowResultAreas));
 }
 
-void CheatSearchStart()
+void CheatSearchSetWidth(INT32 nBytes, bool bBigEndian)
 {
-	UINT32 nAddress;
-	
-	INT32 nActiveCPU = 0;
-	cheat_ptr = &cpus[nActiveCPU];
+	if (nBytes != 1 && nBytes != 2 && nBytes != 4) {
+		nBytes = 1;
+	}
+
+	nSearchWidth = nBytes;
+	bSearchBigEndian = bBigEndian;
+}
+
+static INT32 __cdecl CheatSearchAreaCallback(struct BurnArea* pba)
+{
+	if (nSearchRam >= CHEATSEARCH_MAXAREAS || pba->Data == NULL || pba->nLen == 0) {
+		return 0;
+	}
+
+	SearchRam[nSearchRam++] = *pba;
+
+	return 0;
+}
+
+// Find where the first cpu sees the driver's ram areas, in blocks small enough to lie in
+// one memmap() page each. The lowest of the first four bytes of a block is where it starts
+// in memory, how far the first byte is from it gives the byte swap.
+static void CheatSearchMapAreas()
+{
+	struct cheat_search_area *pa = NULL;
+
+	cheat_ptr = &cpus[0];
 	cheat_subptr = cheat_ptr->cpuconfig;
-	cheat_subptr->open(cheat_ptr->nCPU);
 
-	nActiveCPU = cheat_subptr->active();
+	INT32 nActiveCPU = cheat_subptr->active();
 	if (nActiveCPU >= 0) cheat_subptr->close();
 	cheat_subptr->open(cheat_ptr->nCPU);
-	nMemorySize = cheat_subptr->nMemorySize;
 
-	MemoryValues = (UINT8*)malloc(nMemorySize);
-	MemoryStatus = (UINT8*)malloc(nMemorySize);
-	
-	memset(MemoryStatus, IN_RESULTS, nMemorySize);
-	
-	if (CheatSearchInitCallbackFunction) CheatSearchInitCallbackFunction();
+	for (UINT64 nAddress = 0; nAddress < cheat_subptr->nMemorySize; nAddress += CHEATSEARCH_MAPBLOCK) {
+		UINT8 *pFirst = cheat_subptr->memmap((UINT32)nAddress);
+		UINT8 *pBlock = pFirst;
+		INT32 nRam = -1;
+
+		if (pFirst) {
+			for (INT32 i = 1; i < 4; i++) {
+				UINT8 *p = cheat_subptr->memmap((UINT32)nAddress + i);
+				if (p && p < pBlock) pBlock = p;
+			}
+
+			for (INT32 i = 0; i < nSearchRam; i++) {
+				UINT8 *pRam = (UINT8*)SearchRam[i].Data;
+
+				if (pBlock >= pRam && pBlock + CHEATSEARCH_MAPBLOCK <= pRam + SearchRam[i].nLen) {
+					nRam = i;
+					break;
+				}
+			}
+
+			// Mirrors are only searched the first time they're seen
+			for (INT32 i = 0; i < nSearchAreas && nRam >= 0; i++) {
+				if (pBlock >= SearchArea[i].Data && pBlock < SearchArea[i].Data + SearchArea[i].nLen) {
+					nRam = -1;
+				}
+			}
+		}
 
-	for (nAddress = 0; nAddress < nMemorySize; nAddress++) {
-		if (MemoryStatus[nAddress] == NOT_IN_RESULTS) continue;
-		MemoryValues[nAddress] = cheat_subptr->read(nAddress);
+		if (nRam < 0) {
+			pa = NULL;
+			continue;
+		}
+
+		UINT32 nXor = pFirst - pBlock;
+
+		if (pa && pa->Data + pa->nLen == pBlock && (UINT64)pa->nAddress + pa->nLen == nAddress && pa->nXor == nXor && pa->szName == SearchRam[nRam].szName) {
+			pa->nLen += CHEATSEARCH_MAPBLOCK;
+			continue;
+		}
+
+		if (nSearchAreas >= CHEATSEARCH_MAXAREAS) {
+			break;
+		}
+
+		pa = &SearchArea[nSearchAreas++];
+		pa->Data = pBlock;
+		pa->nLen = CHEATSEARCH_MAPBLOCK;
+		pa->nAddress = (UINT32)nAddress;
+		pa->nXor = nXor;
+		pa->szName = SearchRam[nRam].szName;
 	}
-	
+
 	cheat_subptr->close();
 	if (nActiveCPU >= 0) cheat_subptr->open(nActiveCPU);
+
+	for (INT32 i = 0; i < nSearchAreas; i++) {
+		SearchArea[i].nOffset = nSearchSize;
+		nSearchSize += SearchArea[i].nLen;
+	}
 }
 
-static void CheatSearchGetResults()
+static inline bool CheatSearchIsCandidate(UINT32 nPos)
 {
-	UINT32 nAddress;
-	UINT32 nResultsPos = 0;
-	
-	memset(CheatSearchShowResultAddresses, 0, CHEATSEARCH_SHOWRESULTS);
-	memset(CheatSearchShowResultValues, 0, CHEATSEARCH_SHOWRESULTS);
-	
-	for (nAddress = 0; nAddress < nMemorySize; nAddress++) {		
-		if (MemoryStatus[nAddress] == IN_RESULTS) {
-			CheatSearchShowResultAddresses[nResultsPos] = nAddress;
-			CheatSearchShowResultValues[nResultsPos] = MemoryValues[nAddress];
-			nResultsPos++;
-		}
-	}
+	return (SearchStatus[nPos >> 5] >> (nPos & 31)) & 1;
 }
 
-UINT32 CheatSearchValueNoChange()
+static void CheatSearchSnapshot(UINT8 *pDest)
 {
-	UINT32 nMatchedAddresses = 0;
-	UINT32 nAddress;
-	
-	INT32 nActiveCPU = 0;
-	
-	nActiveCPU = cheat_subptr->active();
+	if (nSearchCPU < 0) {
+		for (INT32 i = 0; i < nSearchAreas; i++) {
+			struct cheat_search_area *pa = &SearchArea[i];
+
+			if (pa->nXor == 0) {
+				memcpy(pDest + pa->nOffset, pa->Data, pa->nLen);
+			} else {
+				for (UINT32 j = 0; j < pa->nLen; j++) {
+					pDest[pa->nOffset + j] = pa->Data[j ^ pa->nXor];
+				}
+			}
+		}
+
+		return;
+	}
+
+	// Through the cpu, only touch addresses that are still candidates
+	cheat_ptr = &cpus[nSearchCPU];
+	cheat_subptr = cheat_ptr->cpuconfig;
+
+	INT32 nActiveCPU = cheat_subptr->active();
 	if (nActiveCPU >= 0) cheat_subptr->close();
-	cheat_subptr->open(0);
-	
-	for (nAddress = 0; nAddress < nMemorySize; nAddress++) {
-		if (MemoryStatus[nAddress] == NOT_IN_RESULTS) continue;
-		if (cheat_subptr->read(nAddress) == MemoryValues[nAddress]) {
-			MemoryValues[nAddress] = cheat_subptr->read(nAddress);
-			nMatchedAddresses++;
-		} else {
-			MemoryStatus[nAddress] = NOT_IN_RESULTS;
+	cheat_subptr->open(cheat_ptr->nCPU);
+
+	for (UINT32 nAddress = 0; nAddress < SearchArea[0].nLen; nAddress++) {
+		if (CheatSearchIsCandidate(nAddress / nSearchWidth)) {
+			pDest[nAddress] = cheat_subptr->read(nAddress);
 		}
 	}
 
 	cheat_subptr->close();
 	if (nActiveCPU >= 0) cheat_subptr->open(nActiveCPU);
-	
-	if (nMatchedAddresses <= CHEATSEARCH_SHOWRESULTS) CheatSearchGetResults();
-	
-	return nMatchedAddresses;
 }
 
-UINT32 CheatSearchValueChange()
+static inline UINT32 CheatSearchValue(UINT8 *pData, UINT32 nPos)
 {
-	UINT32 nMatchedAddresses = 0;
-	UINT32 nAddress;
-	
-	INT32 nActiveCPU = 0;
-	
-	nActiveCPU = cheat_subptr->active();
-	if (nActiveCPU >= 0) cheat_subptr->close();
-	cheat_subptr->open(0);
-	
-	for (nAddress = 0; nAddress < nMemorySize; nAddress++) {
-		if (MemoryStatus[nAddress] == NOT_IN_RESULTS) continue;
-		if (cheat_subptr->read(nAddress) != MemoryValues[nAddress]) {
-			MemoryValues[nAddress] = cheat_subptr->read(nAddress);
-			nMatchedAddresses++;
-		} else {
-			MemoryStatus[nAddress] = NOT_IN_RESULTS;
+	UINT8 *p = pData + nPos * nSearchWidth;
+
+	switch (nSearchWidth) {
+		case 2: return bSearchBigEndian ? ((p[0] << 8) | p[1]) : ((p[1] << 8) | p[0]);
+		case 4: return bSearchBigEndian ? ((p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3]) : ((p[3] << 24) | (p[2] << 16) | (p[1] << 8) | p[0]);
+	}
+
+	return p[0];
+}
+
+static void CheatSearchPosition(UINT32 nPos, UINT32 *pnAddress, char **pszArea)
+{
+	UINT32 nOffset = nPos * nSearchWidth;
+
+	for (INT32 i = nSearchAreas - 1; i >= 0; i--) {
+		if (nOffset >= SearchArea[i].nOffset) {
+			*pnAddress = SearchArea[i].nAddress + (nOffset - SearchArea[i].nOffset);
+			*pszArea = SearchArea[i].szName;
+			return;
 		}
 	}
-	
-	cheat_subptr->close();
-	if (nActiveCPU >= 0) cheat_subptr->open(nActiveCPU);
-	
-	if (nMatchedAddresses <= CHEATSEARCH_SHOWRESULTS) CheatSearchGetResults();
-	
-	return nMatchedAddresses;
+
+	*pnAddress = nOffset;
+	*pszArea = NULL;
 }
 
-UINT32 CheatSearchValueDecreased()
+void CheatSearchStart()
 {
-	UINT32 nMatchedAddresses = 0;
-	UINT32 nAddress;
-	
-	INT32 nActiveCPU = 0;
-	
-	nActiveCPU = cheat_subptr->active();
-	if (nActiveCPU >= 0) cheat_subptr->close();
-	cheat_subptr->open(0);
+	CheatSearchExit();
 
-	for (nAddress = 0; nAddress < nMemorySize; nAddress++) {
-		if (MemoryStatus[nAddress] == NOT_IN_RESULTS) continue;
-		if (cheat_subptr->read(nAddress) < MemoryValues[nAddress]) {
-			MemoryValues[nAddress] = cheat_subptr->read(nAddress);
-			nMatchedAddresses++;
-		} else {
-			MemoryStatus[nAddress] = NOT_IN_RESULTS;
+	if (cheat_core_init_pointer == 0) {
+		bprintf(PRINT_ERROR, _T("Cheat search: no memory to search.\n"));
+		return;
+	}
+
+	// Snapshot the driver's ram areas directly if the cpu can tell where they are
+	if (cpus[0].cpuconfig->memmap) {
+		INT32 (__cdecl *pOldAcb)(struct BurnArea* pba) = BurnAcb;
+		INT32 nMin = 0;
+
+		nSearchRam = 0;
+
+		BurnAcb = CheatSearchAreaCallback;
+		BurnAreaScan(ACB_MEMORY_RAM | ACB_READ, &nMin);
+		BurnAcb = pOldAcb;
+
+		CheatSearchMapAreas();
+	}
+
+	if (nSearchAreas == 0) {
+		if (cpus[0].cpuconfig->nMemorySize > CHEATSEARCH_MAXCPUSIZE) {
+			bprintf(PRINT_ERROR, _T("Cheat search: no memory to search.\n"));
+			return;
 		}
+
+		nSearchCPU = 0;
+		nSearchAreas = 1;
+		SearchArea[0].Data = NULL;
+		SearchArea[0].nLen = cpus[0].cpuconfig->nMemorySize;
+		SearchArea[0].nAddress = 0;
+		SearchArea[0].nOffset = 0;
+		SearchArea[0].nXor = 0;
+		SearchArea[0].szName = NULL;
+		nSearchSize = SearchArea[0].nLen;
 	}
 
-	cheat_subptr->close();
-	if (nActiveCPU >= 0) cheat_subptr->open(nActiveCPU);
-	
-	if (nMatchedAddresses <= CHEATSEARCH_SHOWRESULTS) CheatSearchGetResults();
-	
-	return nMatchedAddresses;
+	nSearchPositions = nSearchSize / nSearchWidth;
+
+	// Room for whole 32-position blocks, so the filters never need a tail loop
+	UINT32 nWords = (nSearchPositions + 31) >> 5;
+	UINT32 nPadded = nWords * 32 * nSearchWidth;
+
+	SearchValues = (UINT8*)malloc(nPadded);
+	SearchCurrent = (UINT8*)malloc(nPadded);
+	SearchStatus = (UINT32*)malloc(nWords * sizeof(UINT32));
+
+	if (SearchValues == NULL || SearchCurrent == NULL || SearchStatus == NULL) {
+		CheatSearchExit();
+		return;
+	}
+
+	memset(SearchValues, 0, nPadded);
+	memset(SearchCurrent, 0, nPadded);
+	memset(SearchStatus, 0, nWords * sizeof(UINT32));
+
+	// Every position that lies completely inside an area is a candidate
+	for (INT32 i = 0; i < nSearchAreas; i++) {
+		UINT32 nFirst = (SearchArea[i].nOffset + nSearchWidth - 1) / nSearchWidth;
+		UINT32 nLast = (SearchArea[i].nOffset + SearchArea[i].nLen) / nSearchWidth;
+
+		for (UINT32 nPos = nFirst; nPos < nLast; nPos++) {
+			SearchStatus[nPos >> 5] |= 1 << (nPos & 31);
+		}
+	}
+
+	if (CheatSearchInitCallbackFunction) CheatSearchInitCallbackFunction();
+
+	CheatSearchSnapshot(SearchValues);
 }
 
-UINT32 CheatSearchValueIncreased()
+static void CheatSearchGetResults()
+{
+	UINT32 nResultsPos = 0;
+
+	memset(CheatSearchShowResultAddresses, 0, sizeof(CheatSearchShowResultAddresses));
+	memset(CheatSearchShowResultValues, 0, sizeof(CheatSearchShowResultValues));
+	memset(CheatSearchShowResultAreas, 0, sizeof(CheatSearchShowResultAreas));
+
+	for (UINT32 nPos = 0; nPos < nSearchPositions && nResultsPos < CHEATSEARCH_SHOWRESULTS; nPos++) {
+		if (CheatSearchIsCandidate(nPos)) {
+			CheatSearchPosition(nPos, &CheatSearchShowResultAddresses[nResultsPos], &CheatSearchShowResultAreas[nResultsPos]);
+			CheatSearchShowResultValues[nResultsPos] = CheatSearchValue(SearchValues, nPos);
+			nResultsPos++;
+		}
+	}
+}
+
+// Compare 32 positions; fixed-length loops over plain arrays so the compiler can vectorise them
+#define CHEATSEARCH_BLOCK(name, type, read)											\
+static UINT32 name(UINT8 *pOld, UINT8 *pNew, INT32 nCompare)						\
+{																					\
+	type nOld[32], nNew[32];														\
+	UINT32 nMask = 0;																\
+																					\
+	for (INT32 j = 0; j < 32; j++) {												\
+		nOld[j] = read(pOld, j);													\
+		nNew[j] = read(pNew, j);													\
+	}																				\
+																					\
+	switch (nCompare) {																\
+		case CHEATSEARCH_NOCHANGE:  for (INT32 j = 0; j < 32; j++) nMask |= (UINT32)(nNew[j] == nOld[j]) << j; break;	\
+		case CHEATSEARCH_CHANGE:    for (INT32 j = 0; j < 32; j++) nMask |= (UINT32)(nNew[j] != nOld[j]) << j; break;	\
+		case CHEATSEARCH_DECREASED: for (INT32 j = 0; j < 32; j++) nMask |= (UINT32)(nNew[j] <  nOld[j]) << j; break;	\
+		case CHEATSEARCH_INCREASED: for (INT32 j = 0; j < 32; j++) nMask |= (UINT32)(nNew[j] >  nOld[j]) << j; break;	\
+	}																				\
+																					\
+	return nMask;																	\
+}
+
+#define READ_8(p, j)		(p)[j]
+#define READ_16LE(p, j)		(UINT16)((p)[(j) * 2] | ((p)[(j) * 2 + 1] << 8))
+#define READ_16BE(p, j)		(UINT16)(((p)[(j) * 2] << 8) | (p)[(j) * 2 + 1])
+#define READ_32LE(p, j)		(UINT32)((p)[(j) * 4] | ((p)[(j) * 4 + 1] << 8) | ((p)[(j) * 4 + 2] << 16) | ((UINT32)(p)[(j) * 4 + 3] << 24))
+#define READ_32BE(p, j)		(UINT32)(((UINT32)(p)[(j) * 4] << 24) | ((p)[(j) * 4 + 1] << 16) | ((p)[(j) * 4 + 2] << 8) | (p)[(j) * 4 + 3])
+
+CHEATSEARCH_BLOCK(CheatSearchBlock8, UINT8, READ_8)
+CHEATSEARCH_BLOCK(CheatSearchBlock16LE, UINT16, READ_16LE)
+CHEATSEARCH_BLOCK(CheatSearchBlock16BE, UINT16, READ_16BE)
+CHEATSEARCH_BLOCK(CheatSearchBlock32LE, UINT32, READ_32LE)
+CHEATSEARCH_BLOCK(CheatSearchBlock32BE, UINT32, READ_32BE)
+
+#undef READ_8
+#undef READ_16LE
+#undef READ_16BE
+#undef READ_32LE
+#undef READ_32BE
+#undef CHEATSEARCH_BLOCK
+
+static UINT32 CheatSearchFilter(INT32 nCompare)
 {
+	if (SearchStatus == NULL) {
+		return 0;
+	}
+
+	UINT32 (*pBlock)(UINT8*, UINT8*, INT32) = CheatSearchBlock8;
+	if (nSearchWidth == 2) pBlock = bSearchBigEndian ? CheatSearchBlock16BE : CheatSearchBlock16LE;
+	if (nSearchWidth == 4) pBlock = bSearchBigEndian ? CheatSearchBlock32BE : CheatSearchBlock32LE;
+
+	CheatSearchSnapshot(SearchCurrent);
+
 	UINT32 nMatchedAddresses = 0;
-	UINT32 nAddress;
-	
-	INT32 nActiveCPU = 0;
-	
-	nActiveCPU = cheat_subptr->active();
-	if (nActiveCPU >= 0) cheat_subptr->close();
-	cheat_subptr->open(0);
+	UINT32 nWords = (nSearchPositions + 31) >> 5;
+	INT32 nBlockSize = 32 * nSearchWidth;
 
-	for (nAddress = 0; nAddress < nMemorySize; nAddress++) {
-		if (MemoryStatus[nAddress] == NOT_IN_RESULTS) continue;
-		if (cheat_subptr->read(nAddress) > MemoryValues[nAddress]) {
-			MemoryValues[nAddress] = cheat_subptr->read(nAddress);
-			nMatchedAddresses++;
+	for (UINT32 i = 0; i < nWords; i++) {
+		UINT32 nStatus = SearchStatus[i];
+		if (nStatus == 0) {
+			continue;
+		}
+
+		UINT8 *pOld = SearchValues + i * nBlockSize;
+		UINT8 *pNew = SearchCurrent + i * nBlockSize;
+
+		// Most of ram doesn't change between searches
+		if (memcmp(pOld, pNew, nBlockSize) == 0) {
+			if (nCompare != CHEATSEARCH_NOCHANGE) {
+				SearchStatus[i] = 0;
+			}
 		} else {
-			MemoryStatus[nAddress] = NOT_IN_RESULTS;
+			SearchStatus[i] = nStatus & pBlock(pOld, pNew, nCompare);
+		}
+
+		for (nStatus = SearchStatus[i]; nStatus; nStatus &= nStatus - 1) {
+			nMatchedAddresses++;
 		}
 	}
-	
-	cheat_subptr->close();
-	if (nActiveCPU >= 0) cheat_subptr->open(nActiveCPU);
-	
+
+	// The fresh snapshot becomes the reference for the next search
+	UINT8 *pTemp = SearchValues;
+	SearchValues = SearchCurrent;
+	SearchCurrent = pTemp;
+
+	// Addresses read through the cpu are only refreshed while they're candidates
+	if (nSearchCPU >= 0) {
+		memcpy(SearchCurrent, SearchValues, nSearchSize);
+	}
+
 	if (nMatchedAddresses <= CHEATSEARCH_SHOWRESULTS) CheatSearchGetResults();
-	
+
 	return nMatchedAddresses;
 }
 
+UINT32 CheatSearchValueNoChange()
+{
+	return CheatSearchFilter(CHEATSEARCH_NOCHANGE);
+}
+
+UINT32 CheatSearchValueChange()
+{
+	return CheatSearchFilter(CHEATSEARCH_CHANGE);
+}
+
+UINT32 CheatSearchValueDecreased()
+{
+	return CheatSearchFilter(CHEATSEARCH_DECREASED);
+}
+
+UINT32 CheatSearchValueIncreased()
+{
+	return CheatSearchFilter(CHEATSEARCH_INCREASED);
+}
+
 void CheatSearchDumptoFile()
 {
 	FILE *fp = fopen("cheatsearchdump.txt", "wt");
-	UINT32 nAddress;
-	
-	if (fp) {
-		char Temp[256];
-		
-		for (nAddress = 0; nAddress < nMemorySize; nAddress++) {
-			if (MemoryStatus[nAddress] == IN_RESULTS) {
-				sprintf(Temp, "Address %08X Value %02X\n", nAddress, MemoryValues[nAddress]);
-				fwrite(Temp, 1, strlen(Temp), fp);
+
+	if (fp && SearchStatus) {
+		for (UINT32 nPos = 0; nPos < nSearchPositions; nPos++) {
+			if (CheatSearchIsCandidate(nPos)) {
+				UINT32 nAddress;
+				char *szArea;
+
+				CheatSearchPosition(nPos, &nAddress, &szArea);
+
+				if (szArea) {
+					fprintf(fp, "Area %s Address %08X Value %0*X\n", szArea, nAddress, nSearchWidth * 2, CheatSearchValue(SearchValues, nPos));
+				} else {
+					fprintf(fp, "Address %08X Value %0*X\n", nAddress, nSearchWidth * 2, CheatSearchValue(SearchValues, nPos));
+				}
 			}
 		}
-		
+	}
+
+	if (fp) {
 		fclose(fp);
 	}
 }
 
 void CheatSearchExcludeAddressRange(UINT32 nStart, UINT32 nEnd)
 {
-	for (UINT32 nAddress = nStart; nAddress <= nEnd; nAddress++) {
-		MemoryStatus[nAddress] = NOT_IN_RESULTS;
+	if (SearchStatus == NULL) {
+		return;
 	}
-}
 
-#undef NOT_IN_RESULTS
-#undef IN_RESULTS
+	for (INT32 i = 0; i < nSearchAreas; i++) {
+		struct cheat_search_area *pa = &SearchArea[i];
+
+		if (nEnd < pa->nAddress || nStart >= pa->nAddress + pa->nLen) {
+			continue;
+		}
+
+		UINT32 nFirst = ((nStart > pa->nAddress) ? nStart - pa->nAddress : 0) + pa->nOffset;
+		UINT32 nLast = ((nEnd < pa->nAddress + pa->nLen - 1) ? nEnd - pa->nAddress : pa->nLen - 1) + pa->nOffset;
+
+		for (UINT32 nPos = nFirst / nSearchWidth; nPos <= nLast / nSearchWidth; nPos++) {
+			SearchStatus[nPos >> 5] &= ~(1 << (nPos & 31));
+		}
+	}
+}
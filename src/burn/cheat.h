@@ -38,9 +38,11 @@ void CheatExit();
 #define CHEATSEARCH_SHOWRESULTS		3
 extern UINT32 CheatSearchShowResultAddresses[CHEATSEARCH_SHOWRESULTS];
 extern UINT32 CheatSearchShowResultValues[CHEATSEARCH_SHOWRESULTS];
+extern char* CheatSearchShowResultAreas[CHEATSEARCH_SHOWRESULTS];	// name of the driver ram area holding each address, NULL when the whole cpu space is searched
 
 INT32 CheatSearchInit();
 void CheatSearchExit();
+void CheatSearchSetWidth(INT32 nBytes, bool bBigEndian);	// 1, 2 or 4 byte values, used from the next CheatSearchStart()
 void CheatSearchStart();
 UINT32 CheatSearchValueNoChange();
 UINT32 CheatSearchValueChange();
@@ -9,6 +9,14 @@ static UINT8 *kaneko_view2_gfx[MAX_VIEW2_CHIPS] = { NULL, NULL };
 static UINT8 *kaneko_view2_gfx_trans[MAX_VIEW2_CHIPS] = { NULL, NULL };
 static INT32 kaneko_color_offset[MAX_VIEW2_CHIPS] = { 0, 0 };
 
+// Each layer's tiles split by priority group, drawing passes only visit their own group.
+// Vram is mapped straight to the cpu, so the lists are rebuilt when a new set of passes
+// starts (a pass at a priority no higher than the one before it).
+static UINT16 kaneko_view2_tiles[MAX_VIEW2_CHIPS][2][8][32 * 32];
+static INT32 kaneko_view2_count[MAX_VIEW2_CHIPS][2][8];
+static UINT8 kaneko_view2_group[MAX_VIEW2_CHIPS][2][32 * 32];	// 0xff = tile is transparent
+static INT32 kaneko_view2_last_priority[MAX_VIEW2_CHIPS][2] = { { 8, 8 }, { 8, 8 } };
+
 void kaneko_view2_init(INT32 chip, UINT8 *video_ram, UINT8 *reg_ram, UINT8 *gfx_rom, INT32 color_offset, UINT8 *gfx_trans, INT32 global_x, INT32 global_y)
 {
 	kaneko_view2_vram[chip] = video_ram;
@@ -19,6 +27,9 @@ void kaneko_view2_init(INT32 chip, UINT8 *video_ram, UINT8 *reg_ram, UINT8 *gfx_
 
 	kaneko_view2_xoff[chip] = global_x;
 	kaneko_view2_yoff[chip] = global_y;	
+
+	kaneko_view2_last_priority[chip][0] = 8;
+	kaneko_view2_last_priority[chip][1] = 8;
 }
 
 void kaneko_view2_exit()
@@ -32,6 +43,32 @@ void kaneko_view2_exit()
 
 		kaneko_view2_xoff[i] = 0;
 		kaneko_view2_yoff[i] = 0;	
+
+		kaneko_view2_last_priority[i][0] = 8;
+		kaneko_view2_last_priority[i][1] = 8;
+	}
+}
+
+static void kaneko_view2_build_lists(INT32 chip, INT32 layer, UINT16 *vram)
+{
+	INT32 *count = kaneko_view2_count[chip][layer];
+	UINT8 *group = kaneko_view2_group[chip][layer];
+
+	memset (count, 0, 8 * sizeof(INT32));
+
+	for (INT32 offs = 0; offs < 32 * 32; offs++)
+	{
+		INT32 attr = BURN_ENDIAN_SWAP_INT16(vram[offs * 2 + 0]);
+		INT32 code = BURN_ENDIAN_SWAP_INT16(vram[offs * 2 + 1]) & 0x1fff;
+
+		if (kaneko_view2_gfx_trans[chip] && kaneko_view2_gfx_trans[chip][code]) {
+			group[offs] = 0xff;
+			continue;
+		}
+
+		group[offs] = (attr & 0x0700) >> 8;
+
+		kaneko_view2_tiles[chip][layer][group[offs]][count[group[offs]]++] = offs;
 	}
 }
 
@@ -46,6 +83,15 @@ void kaneko_view2_draw_layer(INT32 chip, INT32 layer, INT32 priority)
 	INT32 enable = ~tmflip & (layer ? 0x0010 : 0x1000);
 	if (enable == 0) return; // disable!
 
+	if (priority <= kaneko_view2_last_priority[chip][layer]) {
+		kaneko_view2_build_lists(chip, layer, vram);
+	}
+	kaneko_view2_last_priority[chip][layer] = priority;
+
+	if (kaneko_view2_count[chip][layer][priority] == 0) return;
+
+	UINT8 *group = kaneko_view2_group[chip][layer];
+
 	INT32 tmflipx = tmflip & 0x0200; // flip whole tilemap x
 	INT32 tmflipy = tmflip & 0x0100; // flip whole tilemap y
 
@@ -74,18 +120,13 @@ void kaneko_view2_draw_layer(INT32 chip, INT32 layer, INT32 priority)
 			{
 				INT32 offs = ((srcy << 5) | ((srcx + (x >> 4)) & 0x1f));
 
+				if (group[offs] != priority) continue;
+
 				INT32 attr  = BURN_ENDIAN_SWAP_INT16(vram[offs * 2 + 0]);
 				INT32 code  = BURN_ENDIAN_SWAP_INT16(vram[offs * 2 + 1]) & 0x1fff;
 				INT32 color = ((attr & 0x00fc) << 2) + kaneko_color_offset[chip];
 				INT32 flipx = (attr & 0x0002) ? 0x0f : 0;
 				INT32 flipy = (attr & 0x0001) ? 0xf0 : 0;
-				INT32 group = (attr & 0x0700) >> 8;
-
-				if (kaneko_view2_gfx_trans) {
-					if (kaneko_view2_gfx_trans[code]) continue;
-				}
-
-				if (group != priority) continue;
 	
 				UINT8 *gfxsrc = kaneko_view2_gfx[chip] + (code << 8) + (((scrollyy & 0x0f) << 4) ^ flipy);
 	
@@ -104,9 +145,12 @@ void kaneko_view2_draw_layer(INT32 chip, INT32 layer, INT32 priority)
 	else
 	{
 		INT32 scrollx = (xscroll >> 6) & 0x1ff;
+		UINT16 *tiles = kaneko_view2_tiles[chip][layer][priority];
+		INT32 count = kaneko_view2_count[chip][layer][priority];
 
-		for (INT32 offs = 0; offs < 32 * 32; offs++)
+		for (INT32 i = 0; i < count; i++)
 		{
+			INT32 offs = tiles[i];
 			INT32 sx = (offs & 0x1f) * 16;
 			INT32 sy = (offs / 0x20) * 16;
 	
@@ -122,11 +166,6 @@ void kaneko_view2_draw_layer(INT32 chip, INT32 layer, INT32 priority)
 			INT32 color = ((attr & 0x00fc) >> 2) + (0x400 >> 4);
 			INT32 flipx = (attr & 0x0002);
 			INT32 flipy = (attr & 0x0001);
-			INT32 group = (attr & 0x0700) >> 8;
-
-			if (kaneko_view2_gfx_trans) {
-				if (kaneko_view2_gfx_trans[code]) continue;
-			}
 
 			if (tmflipy) {
 				flipy ^= 1;
@@ -137,8 +176,6 @@ void kaneko_view2_draw_layer(INT32 chip, INT32 layer, INT32 priority)
 				flipx ^= 2;
 				sx = 304 - sx; // fix later!
 			}
-	
-			if (group != priority) continue;
 
 			if (sx >= 0 && sy >=0 && sx <= (nScreenWidth - 16) && sy <= (nScreenHeight-16)) // non-clipped
 			{
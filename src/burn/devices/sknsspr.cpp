@@ -28,28 +28,154 @@ static UINT8 decodebuffer[0x2000];
 static INT32 skns_rle_decode ( INT32 romoffset, INT32 size, UINT8*gfx_source, INT32 gfx_length )
 {
 	UINT8 *src = gfx_source;
-	INT32 srcsize = gfx_length;
+	INT32 srcmask = gfx_length - 1; // gfx lengths are always a power of 2
 	UINT8 *dst = decodebuffer;
 	INT32 decodeoffset = 0;
 
 	while(size>0) {
-		UINT8 code = src[(romoffset++)%srcsize];
+		UINT8 code = src[(romoffset++)&srcmask];
 		size -= (code & 0x7f) + 1;
 		if(code & 0x80) { /* (code & 0x7f) normal values will follow */
 			code &= 0x7f;
 			do {
-				dst[(decodeoffset++)%SUPRNOVA_DECODE_BUFFER_SIZE] = src[(romoffset++)%srcsize];
+				dst[(decodeoffset++)&(SUPRNOVA_DECODE_BUFFER_SIZE-1)] = src[(romoffset++)&srcmask];
 				code--;
 			} while(code != 0xff);
 		} else {  /* repeat next value (code & 0x7f) times */
-			UINT8 val = src[(romoffset++)%srcsize];
+			UINT8 val = src[(romoffset++)&srcmask];
 			do {
-				dst[(decodeoffset++)%SUPRNOVA_DECODE_BUFFER_SIZE] = val;
+				dst[(decodeoffset++)&(SUPRNOVA_DECODE_BUFFER_SIZE-1)] = val;
 				code--;
 			} while(code != 0xff);
 		}
 	}
-	return &src[romoffset%srcsize]-gfx_source;
+	return romoffset&srcmask;
+}
+
+// Decoded sprite cache
+//
+// Sprites are decoded from rom, so the same rom offset and size always decode to the
+// same pixels. Decoded sprites are kept (least recently used first out) up to
+// nSknsSpriteCacheSize KB, so a sprite that stays on screen is only decoded once.
+
+#define SKNS_CACHE_HASH_SIZE	4096
+
+struct skns_cache_entry {
+	UINT8 *gfx_source;
+	INT32 romoffset;
+	INT32 size;
+	INT32 endromoffs;
+	skns_cache_entry *hash_next;
+	skns_cache_entry *lru_prev, *lru_next;	// lru_next is less recently used
+	UINT8 data[1];
+};
+
+INT32 nSknsSpriteCacheSize = 4096;
+
+static skns_cache_entry *cache_hash[SKNS_CACHE_HASH_SIZE];
+static skns_cache_entry *cache_lru_head = NULL;
+static skns_cache_entry *cache_lru_tail = NULL;
+static INT32 cache_bytes = 0;
+static UINT32 cache_hits = 0, cache_misses = 0, cache_evictions = 0;
+
+static inline INT32 skns_cache_hash(UINT8 *gfx_source, INT32 romoffset, INT32 size)
+{
+	UINT32 h = (UINT32)romoffset * 0x9e3779b1 ^ (UINT32)size ^ (UINT32)(((uintptr_t)gfx_source) >> 4);
+
+	return (h >> 16) & (SKNS_CACHE_HASH_SIZE - 1);
+}
+
+static void skns_cache_unlink(skns_cache_entry *e)
+{
+	if (e->lru_prev) e->lru_prev->lru_next = e->lru_next; else cache_lru_head = e->lru_next;
+	if (e->lru_next) e->lru_next->lru_prev = e->lru_prev; else cache_lru_tail = e->lru_prev;
+}
+
+static void skns_cache_push_front(skns_cache_entry *e)
+{
+	e->lru_prev = NULL;
+	e->lru_next = cache_lru_head;
+	if (cache_lru_head) cache_lru_head->lru_prev = e; else cache_lru_tail = e;
+	cache_lru_head = e;
+}
+
+static void skns_cache_evict()
+{
+	skns_cache_entry *e = cache_lru_tail;
+	skns_cache_entry **pp = &cache_hash[skns_cache_hash(e->gfx_source, e->romoffset, e->size)];
+
+	while (*pp != e) pp = &(*pp)->hash_next;
+	*pp = e->hash_next;
+
+	skns_cache_unlink(e);
+	cache_bytes -= sizeof(skns_cache_entry) + e->size;
+	cache_evictions++;
+
+	free(e);
+}
+
+static void skns_cache_flush()
+{
+	while (cache_lru_tail) {
+		skns_cache_evict();
+	}
+
+	cache_evictions = 0;
+}
+
+// Returns the decoded sprite, from the cache if it can
+static UINT8 *skns_sprite_decode(INT32 romoffset, INT32 size, UINT8 *gfx_source, INT32 gfx_length, INT32 *endromoffs)
+{
+	INT32 budget = nSknsSpriteCacheSize * 1024;
+
+	if (budget <= 0) {
+		*endromoffs = skns_rle_decode(romoffset, size, gfx_source, gfx_length);
+		return decodebuffer;
+	}
+
+	INT32 h = skns_cache_hash(gfx_source, romoffset, size);
+
+	for (skns_cache_entry *e = cache_hash[h]; e; e = e->hash_next) {
+		if (e->romoffset == romoffset && e->size == size && e->gfx_source == gfx_source) {
+			if (e != cache_lru_head) {
+				skns_cache_unlink(e);
+				skns_cache_push_front(e);
+			}
+			cache_hits++;
+			*endromoffs = e->endromoffs;
+			return e->data;
+		}
+	}
+
+	cache_misses++;
+	*endromoffs = skns_rle_decode(romoffset, size, gfx_source, gfx_length);
+
+	INT32 entry_bytes = sizeof(skns_cache_entry) + size;
+	if (entry_bytes > budget) {
+		return decodebuffer;
+	}
+
+	while (cache_lru_tail && cache_bytes + entry_bytes > budget) {
+		skns_cache_evict();
+	}
+
+	skns_cache_entry *e = (skns_cache_entry*)malloc(entry_bytes);
+	if (e == NULL) {
+		return decodebuffer;
+	}
+
+	e->gfx_source = gfx_source;
+	e->romoffset = romoffset;
+	e->size = size;
+	e->endromoffs = *endromoffs;
+	memcpy(e->data, decodebuffer, size);
+
+	e->hash_next = cache_hash[h];
+	cache_hash[h] = e;
+	skns_cache_push_front(e);
+	cache_bytes += entry_bytes;
+
+	return e->data;
 }
 
 void skns_sprite_kludge(INT32 x, INT32 y)
@@ -430,7 +556,7 @@ void skns_draw_sprites(UINT16 *bitmap, UINT32* spriteram_source, INT32 spriteram
 
 			romoffset &= gfxlen-1;
 
-			endromoffs = skns_rle_decode ( romoffset, size, gfx_source, gfx_length );
+			UINT8 *decoded = skns_sprite_decode ( romoffset, size, gfx_source, gfx_length, &endromoffs );
 
 			// in Cyvern
 
@@ -449,7 +575,7 @@ void skns_draw_sprites(UINT16 *bitmap, UINT32* spriteram_source, INT32 spriteram
 
 				if(zoomx_m || zoomx_s || zoomy_m || zoomy_s)
 				{
-					blit_z[ (xflip<<1) | yflip ](bitmap, decodebuffer, sx, sy, xsize, ysize, zoomx_m, zoomx_s, zoomy_m, zoomy_s, NewColour);
+					blit_z[ (xflip<<1) | yflip ](bitmap, decoded, sx, sy, xsize, ysize, zoomx_m, zoomx_s, zoomy_m, zoomy_s, NewColour);
 				}
 				else
 				{
@@ -465,7 +591,7 @@ void skns_draw_sprites(UINT16 *bitmap, UINT32* spriteram_source, INT32 spriteram
 									if ((sy+yy < (cliprect_max_y+1)) && (sy+yy >= cliprect_min_y))
 									{
 										INT32 pix;
-										pix = decodebuffer[xsize*yy+xx];
+										pix = decoded[xsize*yy+xx];
 										if (pix)
 											bitmap[(sy+yy) * nScreenWidth + (sx+xx)] = pix+ NewColour; // change later
 									}
@@ -485,7 +611,7 @@ void skns_draw_sprites(UINT16 *bitmap, UINT32* spriteram_source, INT32 spriteram
 									if ((sy+(ysize-1-yy) < (cliprect_max_y+1)) && (sy+(ysize-1-yy) >= cliprect_min_y))
 									{
 										INT32 pix;
-										pix = decodebuffer[xsize*yy+xx];
+										pix = decoded[xsize*yy+xx];
 										if (pix)
 											bitmap[(sy+(ysize-1-yy)) * nScreenWidth + (sx+xx)] = pix+ NewColour; // change later
 									}
@@ -505,7 +631,7 @@ void skns_draw_sprites(UINT16 *bitmap, UINT32* spriteram_source, INT32 spriteram
 									if ((sy+yy < (cliprect_max_y+1)) && (sy+yy >= cliprect_min_y))
 									{
 										INT32 pix;
-										pix = decodebuffer[xsize*yy+xx];
+										pix = decoded[xsize*yy+xx];
 										if (pix)
 											bitmap[(sy+yy) * nScreenWidth + (sx+(xsize-1-xx))] = pix+ NewColour; // change later
 									}
@@ -526,7 +652,7 @@ void skns_draw_sprites(UINT16 *bitmap, UINT32* spriteram_source, INT32 spriteram
 									if ((sy+(ysize-1-yy) < (cliprect_max_y+1)) && (sy+(ysize-1-yy) >= cliprect_min_y))
 									{
 										INT32 pix;
-										pix = decodebuffer[xsize*yy+xx];
+										pix = decoded[xsize*yy+xx];
 										if (pix)
 											bitmap[(sy+(ysize-1-yy)) * nScreenWidth + (sx+(xsize-1-xx))] = pix+ NewColour; // change later
 									}
@@ -544,6 +670,11 @@ void skns_draw_sprites(UINT16 *bitmap, UINT32* spriteram_source, INT32 spriteram
 
 void skns_init()
 {
+	memset(cache_hash, 0, sizeof(cache_hash));
+	cache_lru_head = cache_lru_tail = NULL;
+	cache_bytes = 0;
+	cache_hits = cache_misses = cache_evictions = 0;
+
 	DebugDev_SknsSprInitted = 1;
 }
 
@@ -553,5 +684,12 @@ void skns_exit()
 	if (!DebugDev_SknsSprInitted) bprintf(PRINT_ERROR, _T("skns_exit called without init\n"));
 #endif
 
+	if (cache_hits + cache_misses) {
+		bprintf(PRINT_NORMAL, _T("    Sprite cache: %d hits, %d misses (%d%% hit rate), %d evictions.\n"), cache_hits, cache_misses, (INT32)((UINT64)cache_hits * 100 / (cache_hits + cache_misses)), cache_evictions);
+	}
+
+	skns_cache_flush();
+	cache_hits = cache_misses = 0;
+
 	DebugDev_SknsSprInitted = 0;
 }
@@ -38,6 +38,19 @@ static UINT8 vpc_vdc0_enabled[4];
 static UINT8 vpc_vdc1_enabled[4];
 static UINT8 vpc_prio_map[0x200];
 
+// Pattern rows decoded from the 4 bitplanes to one byte per pixel, indexed by
+// the vram word the row starts at. Kept for both vdcs (sgx), dropped by
+// vdc_write_vram() when one of the words a row is built from changes.
+#define VDC_VRAM_WORDS	0x8000
+
+static UINT8 *vdc_bg_row[2];		// 8 pixels, planes at +0, +8 words
+static UINT8 *vdc_obj_row[2];		// 16 pixels, planes at +0, +0x10, +0x20, +0x30 words
+static UINT8 *vdc_bg_valid[2];
+static UINT8 *vdc_obj_valid[2];
+static UINT8 *vdc_row_cache = NULL;
+
+static UINT64 vdc_plane_lut[256];	// one plane byte -> a bit in each of 8 pixel bytes
+
 //--------------------------------------------------------------------------------------------------------------------------------
 
 static void vpc_update_prio_map()
@@ -273,6 +286,75 @@ void vce_reset()
 
 enum vdc_regs {MAWR = 0, MARR, VxR, reg3, reg4, CR, RCR, BXR, BYR, MWR, HSR, HDR, VPR, VDW, VCR, DCR, SOUR, DESR, LENR, DVSSR };
 
+static void vdc_row_cache_reset()
+{
+	for (INT32 i = 0; i < 2; i++) {
+		memset (vdc_bg_valid[i], 0, VDC_VRAM_WORDS);
+		memset (vdc_obj_valid[i], 0, VDC_VRAM_WORDS);
+	}
+}
+
+static inline void vdc_write_vram(INT32 which, INT32 offset, UINT8 l, UINT8 h)
+{
+	INT32 word = offset >> 1;
+
+	vdc_vidram[which][offset + 0] = l;
+	vdc_vidram[which][offset + 1] = h;
+
+	vdc_bg_valid[which][word] = 0;
+	if (word >= 0x08) vdc_bg_valid[which][word - 0x08] = 0;
+
+	for (INT32 i = 0; i < 0x40 && i <= word; i += 0x10) {
+		vdc_obj_valid[which][word - i] = 0;
+	}
+}
+
+static const UINT8 *vdc_get_bg_row(INT32 which, INT32 vram_offs)
+{
+	INT32 word = vram_offs >> 1;
+	UINT8 *row = vdc_bg_row[which] + (word << 3);
+
+	if (!vdc_bg_valid[which][word])
+	{
+		UINT8 *src = vdc_vidram[which] + vram_offs;
+		UINT64 pixels;
+
+		pixels  = vdc_plane_lut[src[0x00]];
+		pixels |= vdc_plane_lut[src[0x01]] << 1;
+		pixels |= vdc_plane_lut[src[0x10]] << 2;
+		pixels |= vdc_plane_lut[src[0x11]] << 3;
+
+		memcpy (row, &pixels, 8);
+
+		// the last rows read past the end of vram, don't keep those
+		vdc_bg_valid[which][word] = (word < (VDC_VRAM_WORDS - 0x08));
+	}
+
+	return row;
+}
+
+static const UINT8 *vdc_get_obj_row(INT32 which, INT32 word)
+{
+	UINT8 *row = vdc_obj_row[which] + (word << 4);
+
+	if (!vdc_obj_valid[which][word])
+	{
+		UINT8 *src = vdc_vidram[which] + (word << 1);
+		UINT64 left = 0, right = 0;
+
+		// bit 15 of each plane word is the leftmost pixel
+		for (INT32 plane = 0; plane < 4; plane++) {
+			left  |= vdc_plane_lut[src[plane * 0x20 + 1]] << plane;
+			right |= vdc_plane_lut[src[plane * 0x20 + 0]] << plane;
+		}
+
+		memcpy (row + 0, &left, 8);
+		memcpy (row + 8, &right, 8);
+		vdc_obj_valid[which][word] = 1;
+	}
+
+	return row;
+}
 
 static void conv_obj(INT32 which, INT32 i, INT32 l, INT32 hf, INT32 vf, UINT8 *buf)
 {
@@ -285,6 +367,19 @@ static void conv_obj(INT32 which, INT32 i, INT32 l, INT32 hf, INT32 vf, UINT8 *b
 
 	tmp = l + ( i << 5);
 
+	if ((tmp + 0x30) < VDC_VRAM_WORDS)
+	{
+		const UINT8 *row = vdc_get_obj_row(which, tmp);
+
+		if (hf) {
+			for(x=0;x<16;x++) buf[x] = row[15 - x];
+		} else {
+			memcpy (buf, row, 16);
+		}
+		return;
+	}
+
+	// pattern runs off the end of vram, read it as it always was
 	b0  = vdc_vidram[which][(tmp + 0x00) * 2 + 0];
 	b0 |= vdc_vidram[which][(tmp + 0x00) * 2 + 1]<<8;
 	b1  = vdc_vidram[which][(tmp + 0x10) * 2 + 0];
@@ -723,8 +818,6 @@ static void pce_refresh_line(INT32 which, INT32 /*line*/, INT32 external_input,
 	/* Are we in greyscale mode or in color mode? */
 	INT32 color_base = vce_control & 0x80 ? 512 : 0;
 
-	INT32 b0, b1, b2, b3;
-	INT32 i0, i1, i2, i3;
 	INT32 cell_pattern_index;
 	INT32 cell_palette;
 	INT32 x, c, i;
@@ -757,18 +850,11 @@ static void pce_refresh_line(INT32 which, INT32 /*line*/, INT32 external_input,
 
 			INT32 vram_offs = (cell_pattern_index + (v_row << 1)) & 0xffff;
 
-			b0 = vdc_vidram[which][vram_offs + 0x00];
-			b1 = vdc_vidram[which][vram_offs + 0x01];
-			b2 = vdc_vidram[which][vram_offs + 0x10];
-			b3 = vdc_vidram[which][vram_offs + 0x11];
+			const UINT8 *row = vdc_get_bg_row(which, vram_offs);
 
 			for(x=0;x<8;x++)
 			{
-				i0 = (b0 >> (7-x)) & 1;
-				i1 = (b1 >> (7-x)) & 1;
-				i2 = (b2 >> (7-x)) & 1;
-				i3 = (b3 >> (7-x)) & 1;
-				c = (cell_palette << 4 | i3 << 3 | i2 << 2 | i1 << 1 | i0);
+				c = (cell_palette << 4 | row[x]);
 
 				/* colour #0 always comes from palette #0 */
 				if ( ! ( c & 0x0F ) )
@@ -992,8 +1078,7 @@ static void vdc_do_dma(INT32 which)
 		h = vdc_vidram[which][((src * 2) + 1) & 0xffff];
 
 		if ((dst & 0x8000) == 0) {
-			vdc_vidram[which][(dst * 2) + 0] = l;
-			vdc_vidram[which][(dst * 2) + 1] = h;
+			vdc_write_vram(which, dst * 2, l, h);
 		}
 
 		if(sid) src = (src - 1) & 0xffff;
@@ -1075,8 +1160,7 @@ void vdc_write(INT32 which, UINT8 offset, UINT8 data)
 				{
 					INT32 voff = vdc_data[which][MAWR] * 2;
 					if ((voff & 0x10000) == 0) {
-						vdc_vidram[which][voff + 0] = vdc_latch[which];
-						vdc_vidram[which][voff + 1] = data;
+						vdc_write_vram(which, voff, vdc_latch[which], data);
 					}
 					vdc_data[which][MAWR] += vdc_inc[which];
 				}
@@ -1198,6 +1282,8 @@ void vdc_reset()
 
 	vdc_inc[0] = 1;
 	vdc_inc[1] = 1;
+
+	vdc_row_cache_reset();
 }
 
 void vdc_get_dimensions(INT32 which, INT32 *x, INT32 *y)
@@ -1213,6 +1299,27 @@ void vdc_get_dimensions(INT32 which, INT32 *x, INT32 *y)
 void vdc_init()
 {
 	DebugDev_VDCInitted = 1;
+
+	for (INT32 i = 0; i < 256; i++) {
+		UINT8 *pixels = (UINT8*)&vdc_plane_lut[i];
+
+		for (INT32 x = 0; x < 8; x++) {
+			pixels[x] = (i >> (7 - x)) & 1;
+		}
+	}
+
+	vdc_row_cache = (UINT8*)BurnMalloc(2 * VDC_VRAM_WORDS * (8 + 16 + 1 + 1));
+
+	UINT8 *Next = vdc_row_cache;
+
+	for (INT32 i = 0; i < 2; i++) {
+		vdc_bg_row[i]		= Next; Next += VDC_VRAM_WORDS * 8;
+		vdc_obj_row[i]		= Next; Next += VDC_VRAM_WORDS * 16;
+		vdc_bg_valid[i]		= Next; Next += VDC_VRAM_WORDS;
+		vdc_obj_valid[i]	= Next; Next += VDC_VRAM_WORDS;
+	}
+
+	vdc_row_cache_reset();
 }
 
 void vdc_exit()
@@ -1221,6 +1328,8 @@ void vdc_exit()
 	if (!DebugDev_VDCInitted) bprintf(PRINT_ERROR, _T("vdc_exit called without init\n"));
 #endif
 
+	BurnFree (vdc_row_cache);
+
 	DebugDev_VDCInitted = 0;
 }
 
@@ -1236,6 +1345,10 @@ INT32 vdc_scan(INT32 nAction, INT32 *pnMin)
 		*pnMin =  0x029702;
 	}
 
+	if (nAction & ACB_WRITE) {
+		vdc_row_cache_reset();		// vram is loaded with the driver's ram
+	}
+
 	if (nAction & ACB_DRIVER_DATA) {
 		for (INT32 i = 0; i < 2; i++) {
 			SCAN_VAR(vdc_register[i]);
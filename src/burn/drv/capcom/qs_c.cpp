@@ -3,6 +3,7 @@
 #include <math.h>
 #include "cps.h"
 #include "burn_sound.h"
+#include "burn_trace.h"
 
 static const INT32 nQscClock = 4000000;
 static const INT32 nQscClockDivider = 166;
@@ -259,6 +260,8 @@ void QscWrite(INT32 a, INT32 d)
 
 INT32 QscUpdate(INT32 nEnd)
 {
+	BURN_TRACE_SCOPE("QSound", "sound");
+
 	INT32 nLen;
 
 	if (nEnd > nBurnSoundLen) {
@@ -34,12 +34,23 @@ static UINT16* pZBuffer = NULL;
 static UINT16* pZRow;
 static UINT16* pZPixel;
 
+// Parts of the z-buffer written this frame, as a bounding box and per row
+static INT32 nMaskLeft, nMaskRight, nMaskTop, nMaskBottom;
+static INT16* pZRowLeft = NULL;
+static INT16* pZRowRight = NULL;
+static UINT8* pZRowDirty = NULL;											// written since the z-buffer was last cleared
+
 static INT32 nSpriteRow, nSpriteRowSize;
 static INT32 nXPos, nYPos, nZPos;
 static INT32 nXSize, nYSize;
 static INT32 nSpriteXZoomSize, nSpriteYZoomSize;
 static INT32 nSpriteXOffset, nSpriteYOffset;
 
+// Columns of a zoomed sprite that get drawn: screen column and source column
+static INT32 nSpriteColumns;
+static INT16 SpriteColumnDst[512];
+static INT16 SpriteColumnSrc[512];
+
 static INT32 nFirstSprite[4], nLastSprite[4];
 
 static INT32 nTopSprite;
@@ -51,9 +62,58 @@ static RenderSpriteFunction* RenderSprite;
 // Include the sprite rendering functions
 #include "cave_sprite_func.h"
 
+// Does a sprite cover any pixel written to the z-buffer this frame?
+static INT32 CaveZBufferTest()
+{
+	if (nXPos >= nMaskRight || nXPos + nXSize < nMaskLeft || nYPos >= nMaskBottom || nYPos + nYSize < nMaskTop) {
+		return 0;
+	}
+
+	INT32 nTop = (nYPos > nMaskTop) ? nYPos : nMaskTop;
+	INT32 nBottom = (nYPos + nYSize < nMaskBottom) ? (nYPos + nYSize) : nMaskBottom;
+
+	for (INT32 y = nTop; y < nBottom; y++) {
+		if (nXPos < pZRowRight[y] && nXPos + nXSize >= pZRowLeft[y]) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static void CaveZBufferMark()
+{
+	INT32 nBottom = nYPos + nYSize;
+	if (nBottom > nCaveYSize) {
+		nBottom = nCaveYSize;
+	}
+
+	if (nXPos < nMaskLeft) {
+		nMaskLeft = nXPos;
+	}
+	if (nXPos + nXSize > nMaskRight) {
+		nMaskRight = nXPos + nXSize;
+	}
+	if (nYPos < nMaskTop) {
+		nMaskTop = nYPos;
+	}
+	if (nBottom > nMaskBottom) {
+		nMaskBottom = nBottom;
+	}
+
+	for (INT32 y = nYPos; y < nBottom; y++) {
+		if (nXPos < pZRowLeft[y]) {
+			pZRowLeft[y] = nXPos;
+		}
+		if (nXPos + nXSize > pZRowRight[y]) {
+			pZRowRight[y] = nXPos + nXSize;
+		}
+		pZRowDirty[y] = 1;
+	}
+}
+
 INT32 CaveSpriteRender(INT32 nLowPriority, INT32 nHighPriority)
 {
-	static INT32 nMaskLeft, nMaskRight, nMaskTop, nMaskBottom;
 	CaveSprite* pBuffer;
 
 	INT32 nPriorityMask = 0;
@@ -66,6 +126,11 @@ INT32 CaveSpriteRender(INT32 nLowPriority, INT32 nHighPriority)
 		nZPos = -1;
 		nTopSprite = -1;
 
+		for (INT32 y = (nMaskTop > 0) ? nMaskTop : 0; y < nMaskBottom; y++) {
+			pZRowLeft[y] = 0x7FFF;
+			pZRowRight[y] = -1;
+		}
+
 		nMaskLeft = nMaskTop = 9999;
 		nMaskRight = nMaskBottom = -1;
 	}
@@ -159,30 +224,18 @@ INT32 CaveSpriteRender(INT32 nLowPriority, INT32 nHighPriority)
 			nFunction = (pBuffer->flip & 2) << 1;									// X Flip
 
 			if (nTopSprite > nCurrentZPos) {										// Test ZBuffer
-				if (nXPos < nMaskRight && (nXPos + nXSize) >= nMaskLeft && nYPos < nMaskBottom && (nYPos + nYSize) >= nMaskTop) {
+				if (CaveZBufferTest()) {
 					nFunction |= 1;
 				}
 			}
 
 			if (nUseBuffer < nCurrentZPos) {										// Write ZBuffer
 				nFunction |= 2;
-
-				if (nXPos < nMaskLeft) {
-					nMaskLeft = nXPos;
-				}
-				if ((nXPos + nXSize) > nMaskRight) {
-					nMaskRight = nXPos + nXSize;
-				}
-				if (nYPos < nMaskTop) {
-					nMaskTop = nYPos;
-				}
-				if ((nYPos + nYSize) > nMaskBottom) {
-					nMaskBottom = nYPos + nYSize;
-				}
+				CaveZBufferMark();
 			}
 
 			if (nFunction & 3) {
-				pZRow = pZBuffer + (nYPos * 320) + nXPos;
+				pZRow = pZBuffer + (nYPos * nCaveXSize) + nXPos;
 				nZPos = nCurrentZPos + nZOffset;
 			}
 
@@ -284,26 +337,14 @@ INT32 CaveSpriteRender(INT32 nLowPriority, INT32 nHighPriority)
 			}
 
 			if (nTopSprite > nCurrentZPos) {										// Test ZBuffer
-				if (nXPos < nMaskRight && nXPos + nXSize >= nMaskLeft && nYPos < nMaskBottom && nYPos + nYSize >= nMaskTop) {
+				if (CaveZBufferTest()) {
 					nFunction |= 1;
 				}
 			}
 
 			if (nUseBuffer < nCurrentZPos) {										// Write ZBuffer
 				nFunction |= 2;
-
-				if (nXPos < nMaskLeft) {
-					nMaskLeft = nXPos;
-				}
-				if (nXPos + nXSize > nMaskRight) {
-					nMaskRight = nXPos + nXSize;
-				}
-				if (nYPos < nMaskTop) {
-					nMaskTop = nYPos;
-				}
-				if (nYPos + nYSize > nMaskBottom) {
-					nMaskBottom = nYPos + nYSize;
-				}
+				CaveZBufferMark();
 			}
 
 			if (nFunction & 3) {
@@ -311,6 +352,29 @@ INT32 CaveSpriteRender(INT32 nLowPriority, INT32 nHighPriority)
 				nZPos = nCurrentZPos + nZOffset;
 			}
 
+			// Work out which source column each screen column shows. When zooming in, a
+			// column is only drawn where the source column changes.
+			{
+				INT32 nOffset = nSpriteXOffset;
+				INT32 nPrevOffset = nSpriteXOffset & 0xFFFF0000;
+				if (nPrevOffset == 0) {
+					nPrevOffset = 0xFEDC1234;
+				}
+
+				nSpriteColumns = 0;
+				for (INT32 x = 0; x < nXSize; x++, nOffset += nSpriteXZoomSize) {
+					if (nFunction & 4) {
+						if ((nOffset & 0xFFFF0000) == (nPrevOffset & 0xFFFF0000)) {
+							continue;
+						}
+						nPrevOffset = nOffset;
+					}
+					SpriteColumnDst[nSpriteColumns] = x;
+					SpriteColumnSrc[nSpriteColumns] = nOffset >> 16;
+					nSpriteColumns++;
+				}
+			}
+
 			nXSize <<= 16;
 			nYSize <<= 16;
 
@@ -326,7 +390,12 @@ INT32 CaveSpriteRender(INT32 nLowPriority, INT32 nHighPriority)
 		if (nZPos >= 0) {
 			nZOffset += nTopSprite;
 			if (nZOffset > 0xFC00) {
-				memset(pZBuffer, 0, nCaveXSize * nCaveYSize * sizeof(UINT16));
+				for (INT32 y = 0; y < nCaveYSize; y++) {
+					if (pZRowDirty[y]) {
+						memset(pZBuffer + y * nCaveXSize, 0, nCaveXSize * sizeof(UINT16));
+						pZRowDirty[y] = 0;
+					}
+				}
 				nZOffset = 0;
 			}
 		}
@@ -667,6 +736,9 @@ void CaveSpriteExit()
 {
 	BurnFree(pSpriteList);
 	BurnFree(pZBuffer);
+	BurnFree(pZRowLeft);
+	BurnFree(pZRowRight);
+	BurnFree(pZRowDirty);
 	
 	CaveSpriteVisibleXOffset = 0;
 
@@ -705,6 +777,25 @@ INT32 CaveSpriteInit(INT32 nType, INT32 nROMSize)
 	memset(pZBuffer, 0, nCaveXSize * nCaveYSize * sizeof(UINT16));
 	nZOffset = 0;
 
+	BurnFree(pZRowLeft);
+	BurnFree(pZRowRight);
+	BurnFree(pZRowDirty);
+	pZRowLeft = (INT16*)BurnMalloc(nCaveYSize * sizeof(INT16));
+	pZRowRight = (INT16*)BurnMalloc(nCaveYSize * sizeof(INT16));
+	pZRowDirty = (UINT8*)BurnMalloc(nCaveYSize);
+	if (pZRowLeft == NULL || pZRowRight == NULL || pZRowDirty == NULL) {
+		CaveSpriteExit();
+		return 1;
+	}
+
+	for (INT32 y = 0; y < nCaveYSize; y++) {
+		pZRowLeft[y] = 0x7FFF;
+		pZRowRight[y] = -1;
+	}
+	memset(pZRowDirty, 0, nCaveYSize);
+	nMaskLeft = nMaskTop = 9999;
+	nMaskRight = nMaskBottom = -1;
+
 	for (nSpriteAddressMask = 1; nSpriteAddressMask < nROMSize; nSpriteAddressMask <<= 1) {}
 	nSpriteAddressMask--;
 
@@ -3,7 +3,6 @@
 #define FUNCTIONNAME(a,b,c,d,e,f,g) FN(a,b,c,d,e,f,g)
 
 #if ROT == 0
- #define ADVANCECOLUMN pPixel += (BPP >> 3)
  #define ADVANCEROW pRow += ((BPP >> 3) * XSIZE)
 #else
  #error unsupported rotation angle specified
@@ -21,25 +20,21 @@
 
 #if ZBUFFER == 0
  #define ZBUF _NOZBUFFER
- #define ADVANCEZCOLUMN
  #define ADVANCEZROW
  #define TESTZBUF(a) 1
  #define WRITEZBUF(a)
 #elif ZBUFFER == 1
  #define ZBUF _RZBUFFER
- #define ADVANCEZCOLUMN pZPixel += 1
  #define ADVANCEZROW pZRow += XSIZE
  #define TESTZBUF(a) (pZPixel[a] <= nZPos)
  #define WRITEZBUF(a)
 #elif ZBUFFER == 2
  #define ZBUF _WZBUFFER
- #define ADVANCEZCOLUMN pZPixel += 1
  #define ADVANCEZROW pZRow += XSIZE
  #define TESTZBUF(a) 1
  #define WRITEZBUF(a) pZPixel[a] = nZPos
 #elif ZBUFFER == 3
  #define ZBUF _RWZBUFFER
- #define ADVANCEZCOLUMN pZPixel += 1
  #define ADVANCEZROW pZRow += XSIZE
  #define TESTZBUF(a) (pZPixel[a] <= nZPos)
  #define WRITEZBUF(a) pZPixel[a] = nZPos
@@ -92,19 +87,12 @@ static void FUNCTIONNAME(BPP,XSIZE,ROT,FLIP,ZOOMMODE,ZBUF,DEPTH)()
 // Create an empty function if unsupported features are requested
 #if ROT == 0 && XFLIP == 0 && EIGHTBIT == 1
 
+	// The columns to draw are worked out in CaveSpriteRender(), see SpriteColumnDst/Src
 	INT32 nSpriteColumn;
 
-	INT32 nSpriteXOffset2;
-
  #if ZOOM == 2
-	INT32 nPrevSpriteXOffset;
-	INT32 nPrevSpriteXOffsetStart = nSpriteXOffset & 0xFFFF0000;
 	INT32 nPrevSpriteYOffset = nSpriteYOffset & 0xFFFF0000;
 
-	if (nPrevSpriteXOffsetStart == 0) {
-		nPrevSpriteXOffsetStart = 0xFEDC1234;
-	}
-
 	if (nPrevSpriteYOffset == 0) {
 		nPrevSpriteYOffset = 0xFEDC1234;
 	}
@@ -125,34 +113,18 @@ static void FUNCTIONNAME(BPP,XSIZE,ROT,FLIP,ZOOMMODE,ZBUF,DEPTH)()
 			continue;
 		}
 		nPrevSpriteYOffset = nSpriteYOffset;
-		nPrevSpriteXOffset = nPrevSpriteXOffsetStart;
  #endif
 		pSpriteRowData = ((UINT8*)pSpriteData) + (nSpriteYOffset >> 16) * nSpriteRowSize;
 
-		nSpriteXOffset2 = nSpriteXOffset;
-
+		pPixel = pRow;
  #if ZBUFFER != 0
 		pZPixel = pZRow;
  #endif
 
-		for (nSpriteColumn = nXSize, pPixel = pRow; nSpriteColumn > 0; nSpriteColumn -= 0x00010000, nSpriteXOffset2 += nSpriteXZoomSize) {
-
- #if ZOOM == 2
-			if ((nSpriteXOffset2 & 0xFFFF0000) != (nPrevSpriteXOffset & 0xFFFF0000)) {
-
-				nPrevSpriteXOffset = nSpriteXOffset2;
- #endif
-				PLOTPIXEL(0, pSpriteRowData[nSpriteXOffset2 >> 16]);
-
- #if ZOOM == 2
-			}
- #endif
-
-			ADVANCECOLUMN;
- #if ZBUFFER != 0
-			ADVANCEZCOLUMN;
- #endif
+		for (nSpriteColumn = 0; nSpriteColumn < nSpriteColumns; nSpriteColumn++) {
+			INT32 nColumn = SpriteColumnDst[nSpriteColumn];
 
+			PLOTPIXEL(nColumn, pSpriteRowData[SpriteColumnSrc[nSpriteColumn]]);
 		}
 
 		ADVANCEROW;
@@ -169,9 +141,7 @@ static void FUNCTIONNAME(BPP,XSIZE,ROT,FLIP,ZOOMMODE,ZBUF,DEPTH)()
 #undef PLOTPIXEL
 #undef TESTCOLOUR
 #undef ADVANCEZROW
-#undef ADVANCEZCOLUMN
 #undef ADVANCEROW
-#undef ADVANCECOLUMN
 #undef TESTZBUF
 #undef WRITEZBUF
 #undef ZBUF
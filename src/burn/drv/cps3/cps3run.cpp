@@ -19,6 +19,7 @@ Port to FBA by OopsWare
 
 #include "cps3.h"
 #include "sh2_intf.h"
+#include "burn_band.h"
 
 #define	BE_GFX		1
 //#define	FAST_BOOT	1
@@ -84,6 +85,13 @@ static UINT32 chardma_table_address = 0;
 
 static INT32 cps3_gfx_width, cps3_gfx_height;
 static INT32 cps3_gfx_max_x, cps3_gfx_max_y;
+static UINT32 cps3_gfx_zoom;
+
+// Lines of RamScreen the current render band may draw to, private to each render thread
+static BURN_BAND_TLS INT32 cps3_clip_min_y, cps3_clip_max_y;
+
+static UINT32 nDrawFrames = 0;
+static UINT64 nDrawTicks = 0;
 
 
 // -- AMD/Fujitsu 29F016 --------------------------------------------------
@@ -1243,6 +1251,19 @@ INT32 cps3Init()
 
 INT32 cps3Exit()
 {
+	if (nDrawFrames) {
+		INT32 nBands = BurnBandCount(0, 224);
+
+		if (nBands > 1) {
+			bprintf(PRINT_NORMAL, _T("    CPS3 render (%d bands): %d frames, %d us per frame.\n"), nBands, nDrawFrames, (INT32)(nDrawTicks / nDrawFrames));
+		} else {
+			bprintf(PRINT_NORMAL, _T("    CPS3 render (serial): %d frames, %d us per frame.\n"), nDrawFrames, (INT32)(nDrawTicks / nDrawFrames));
+		}
+	}
+
+	nDrawFrames = 0;
+	nDrawTicks = 0;
+
 	Sh2Exit();
 	
 	BurnFree(Mem);
@@ -1568,9 +1589,9 @@ static void cps3_drawgfxzoom_2(UINT32 code, UINT32 pal, INT32 flipx, INT32 flipy
 				sx += pixels;
 				x_index_base += pixels*dx;
 			}
-			if( sy < 0 )
+			if( sy < cps3_clip_min_y )
 			{ /* clip top */
-				INT32 pixels = 0-sy;
+				INT32 pixels = cps3_clip_min_y-sy;
 				sy += pixels;
 				y_index += pixels*dy;
 			}
@@ -1579,9 +1600,9 @@ static void cps3_drawgfxzoom_2(UINT32 code, UINT32 pal, INT32 flipx, INT32 flipy
 				INT32 pixels = ex-cps3_gfx_max_x-1;
 				ex -= pixels;
 			}
-			if( ey > cps3_gfx_max_y+1 )
+			if( ey > cps3_clip_max_y )
 			{ /* clip bottom */
-				INT32 pixels = ey-cps3_gfx_max_y-1;
+				INT32 pixels = ey-cps3_clip_max_y;
 				ey -= pixels;
 			}
 		}
@@ -1702,54 +1723,25 @@ static void cps3_draw_tilemapsprite_line(INT32 drawline, UINT32 * regs )
 
 static INT32 WideScreenFrameDelay = 0;
 
-static void DrvDraw()
+// Draws lines nStart - nEnd of RamScreen, every band walks the whole sprite list
+static void DrvDrawScreenBand(INT32, INT32 nStart, INT32 nEnd)
 {
 	INT32 bg_drawn[4] = { 0, 0, 0, 0 };
+	UINT32 fsz = cps3_gfx_zoom;
 
-	UINT32 fullscreenzoom = RamVReg[ 6 * 4 + 3 ] & 0xff;
-	UINT32 fullscreenzoomwidecheck = RamVReg[6 * 4 + 1];
-	
-	if (((fullscreenzoomwidecheck & 0xffff0000) >> 16) == 0x0265) {
-		INT32 Width, Height;
-		BurnDrvGetVisibleSize(&Width, &Height);
-		
-		if (Width != 496) {
-			BurnDrvSetVisibleSize(496, 224);
-			BurnDrvSetAspect(16, 9);
-			Reinitialise();
-			WideScreenFrameDelay = GetCurrentFrame() + 1;
-		}
-	} else {
-		INT32 Width, Height;
-		BurnDrvGetVisibleSize(&Width, &Height);
-		
-		if (Width != 384) {
-			BurnDrvSetVisibleSize(384, 224);
-			BurnDrvSetAspect(4, 3);
-			Reinitialise();
-			WideScreenFrameDelay = GetCurrentFrame() + 1;
-		}
-	}
-	
-	if (fullscreenzoom > 0x80) fullscreenzoom = 0x80;
-	UINT32 fsz = (fullscreenzoom << (16 - 6));
-	
-	cps3_gfx_max_x = ((cps3_gfx_width * fsz)  >> 16) - 1;	// 384 ( 496 for SFIII2 Only)
-	cps3_gfx_max_y = ((cps3_gfx_height * fsz) >> 16) - 1;	// 224
+	cps3_clip_min_y = nStart;
+	cps3_clip_max_y = (nEnd < cps3_gfx_max_y + 1) ? nEnd : (cps3_gfx_max_y + 1);
 
 	if (nBurnLayer & 1)
 	{
-		UINT32 * pscr = RamScreen;
+		UINT32 * pscr = RamScreen + nStart * 512*2;
 		INT32 clrsz = (cps3_gfx_max_x + 1) * sizeof(INT32);
-		for(INT32 yy = 0; yy<=cps3_gfx_max_y; yy++, pscr += 512*2)
+		for(INT32 yy = nStart; yy<=cps3_gfx_max_y && yy<nEnd; yy++, pscr += 512*2)
 			memset(pscr, 0, clrsz);
 	}
 	else
 	{
-		Cps3CurPal[0x20000] = BurnHighCol(0xff, 0x00, 0xff, 0);
-
-		INT32 i;
-		for (i = 0; i < 1024 * 448; i++) {
+		for (INT32 i = nStart * 1024; i < nEnd * 1024; i++) {
 			RamScreen[i] = 0x20000;
 		}
 	}
@@ -1826,7 +1818,10 @@ static void DrvDraw()
 						{
 							UINT32 srcy = 0;
 							for (INT32 ry = 0; ry < 224; ry++, srcy += fsz) {
-								cps3_draw_tilemapsprite_line( srcy >> 16, regs );
+								INT32 drawline = srcy >> 16;
+								if (drawline < nStart || drawline >= nEnd) continue;
+
+								cps3_draw_tilemapsprite_line( drawline, regs );
 							}
 						}
 
@@ -1923,28 +1918,36 @@ static void DrvDraw()
 			}
 		}
 	}
-	
+}
+
+// Scales lines nStart - nEnd of the output from RamScreen and draws the text layer over them
+static void DrvDrawOutputBand(INT32, INT32 nStart, INT32 nEnd)
+{
+	// text tiles are 8 lines high, keep bands on tile row boundaries
+	nStart = (nStart + 7) & ~7;
+	nEnd = (nEnd + 7) & ~7;
+
 	{
-		UINT32 srcx, srcy = 0;
+		UINT32 srcx, srcy = nStart * cps3_gfx_zoom;
 		UINT32 * srcbitmap;
-		UINT16 * dstbitmap = (UINT16 * )pBurnDraw;
+		UINT16 * dstbitmap = (UINT16 * )pBurnDraw + nStart * cps3_gfx_width;
 
-		for (INT32 rendery=0; rendery<224; rendery++) {
+		for (INT32 rendery=nStart; rendery<nEnd; rendery++) {
 			srcbitmap = RamScreen + (srcy >> 16) * 1024;
 			srcx=0;
 			for (INT32 renderx=0; renderx<cps3_gfx_width; renderx++, dstbitmap ++) {
 				*dstbitmap = Cps3CurPal[ srcbitmap[srcx>>16] ];
-				srcx += fsz;
+				srcx += cps3_gfx_zoom;
 			}
-			srcy += fsz;
+			srcy += cps3_gfx_zoom;
 		}
 	}
 	
 	if (nBurnLayer & 2)
 	{
 		// bank select? (sfiii2 intro)
-		INT32 count = (ss_bank_base & 0x01000000) ? 0x0000 : 0x0800;
-		for (INT32 y=0; y<32-4; y++) {
+		INT32 count = ((ss_bank_base & 0x01000000) ? 0x0000 : 0x0800) + (nStart / 8) * 64;
+		for (INT32 y=nStart/8; y<nEnd/8 && y<32-4; y++) {
 			for (INT32 x=0; x<64; x++, count++) {
 				UINT32 data = RamSS[count]; // +0x800 = 2nd bank, used on sfiii2 intro..
 				UINT32 tile = (data >> 16) & 0x1ff;
@@ -1962,6 +1965,63 @@ static void DrvDraw()
 	}
 }
 
+static void DrvDraw()
+{
+	UINT64 nTicks = BurnGetTicks();
+
+	UINT32 fullscreenzoom = RamVReg[ 6 * 4 + 3 ] & 0xff;
+	UINT32 fullscreenzoomwidecheck = RamVReg[6 * 4 + 1];
+	
+	if (((fullscreenzoomwidecheck & 0xffff0000) >> 16) == 0x0265) {
+		INT32 Width, Height;
+		BurnDrvGetVisibleSize(&Width, &Height);
+		
+		if (Width != 496) {
+			BurnDrvSetVisibleSize(496, 224);
+			BurnDrvSetAspect(16, 9);
+			Reinitialise();
+			WideScreenFrameDelay = GetCurrentFrame() + 1;
+		}
+	} else {
+		INT32 Width, Height;
+		BurnDrvGetVisibleSize(&Width, &Height);
+		
+		if (Width != 384) {
+			BurnDrvSetVisibleSize(384, 224);
+			BurnDrvSetAspect(4, 3);
+			Reinitialise();
+			WideScreenFrameDelay = GetCurrentFrame() + 1;
+		}
+	}
+	
+	if (fullscreenzoom > 0x80) fullscreenzoom = 0x80;
+	UINT32 fsz = (fullscreenzoom << (16 - 6));
+	
+	cps3_gfx_max_x = ((cps3_gfx_width * fsz)  >> 16) - 1;	// 384 ( 496 for SFIII2 Only)
+	cps3_gfx_max_y = ((cps3_gfx_height * fsz) >> 16) - 1;	// 224
+	cps3_gfx_zoom = fsz;
+
+	// RamScreen lines that can be drawn to or shown this frame
+	INT32 nLines = ((223 * fsz) >> 16) + 1;
+	if (nLines < cps3_gfx_max_y + 1) nLines = cps3_gfx_max_y + 1;
+
+	if (~nBurnLayer & 1)
+	{
+		Cps3CurPal[0x20000] = BurnHighCol(0xff, 0x00, 0xff, 0);
+
+		for (INT32 i = nLines * 1024; i < 1024 * 448; i++) {
+			RamScreen[i] = 0x20000;
+		}
+	}
+
+	// Both passes can be split into horizontal bands and drawn on several threads
+	BurnBandRun(DrvDrawScreenBand, 0, nLines);
+	BurnBandRun(DrvDrawOutputBand, 0, 224);
+
+	nDrawFrames++;
+	nDrawTicks += BurnGetTicks() - nTicks;
+}
+
 static INT32 cps_int10_cnt = 0;
 
 INT32 cps3Frame()
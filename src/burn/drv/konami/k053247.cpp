@@ -657,6 +657,8 @@ void zdrawgfxzoom32GP(UINT32 code, UINT32 color, INT32 flipx, INT32 flipy, INT32
 	eax = dst_miny;  if ((eax -= dst_y) > 0) { dst_skipy = eax;  dst_h -= eax;  dst_y = dst_miny; }
 	eax = dst_lasty; if ((eax -= dst_maxy) > 0) dst_h -= eax;
 
+	if (zcode >= 0) konamigx_mixer_mark_zbuf(drawmode == 4, dst_x, dst_y, dst_w, dst_h);
+
 	// calculate zoom factors and clip source
 	if (nozoom)
 	{
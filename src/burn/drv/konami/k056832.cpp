@@ -12,6 +12,10 @@ static UINT8 *K056832Rom;
 static UINT8 *K056832RomExp;
 static UINT8 *K056832TransTab;
 
+static UINT32 *K056832AttrCache;
+static UINT8 K056832PageDirty[16];
+static INT32 K056832PageLayer[16];
+
 static INT32 K056832RomExpMask;
 
 static INT32 m_layer_offs[8][2];
@@ -40,6 +44,16 @@ static INT32 m_rom_half;
 
 static void (*m_callback)(INT32 layer, INT32 *code, INT32 *color, INT32 *flags);
 
+static inline void k056832_mark_page_dirty(INT32 page)
+{
+	if (page < 16) K056832PageDirty[page] = 1;
+}
+
+static void k056832_mark_all_dirty()
+{
+	memset (K056832PageDirty, 1, sizeof(K056832PageDirty));
+}
+
 void K056832Reset()
 {
 	memset (K056832VideoRAM, 0, 0x2000 * 0x11 * 2);
@@ -57,6 +71,8 @@ void K056832Reset()
 	m_rom_half = 0;
 	m_selected_page = 0;
 	m_selected_page_x4096 = 0;
+
+	k056832_mark_all_dirty();
 }
 
 static void CalculateTranstab()
@@ -106,6 +122,7 @@ void K056832Init(UINT8 *rom, UINT8 *romexp, INT32 rom_size, void (*cb)(INT32 lay
 	m_layer_association = m_default_layer_association;
 
 	K056832VideoRAM = (UINT16*)BurnMalloc(0x2000 * 0x11 * 2);
+	K056832AttrCache = (UINT32*)BurnMalloc(16 * 64 * 32 * sizeof(UINT32));
 
 	K056832Reset();
 }
@@ -114,6 +131,7 @@ void K056832Exit()
 {
 	BurnFree (K056832VideoRAM);
 	BurnFree (K056832TransTab);
+	BurnFree (K056832AttrCache);
 
 	m_callback = NULL;
 }
@@ -263,12 +281,17 @@ static void k056832_update_page_layout()
 	}
 }
 
-static void k056832_word_write_update(INT32 offset) // (offset/2)&0x1f internally
+static void k056832_word_write_update(INT32 offset, UINT16 old) // (offset/2)&0x1f internally
 {
 	offset = (offset / 2) & 0x1f;
 
 	UINT16 data = k056832Regs[offset];
 
+	// only the flip override and the flip/palette bits go into the decoded attributes
+	if ((offset == 0x02/2 || offset == 0x06/2) && data != old) {
+		k056832_mark_all_dirty();
+	}
+
 	if (offset >= 0x10/2 && offset <= 0x1e/2)
 	{
 		m_active_layer = offset & 3;
@@ -304,16 +327,20 @@ static void k056832_word_write_update(INT32 offset) // (offset/2)&0x1f internall
 
 void K056832WordWrite(INT32 offset, UINT16 data)
 {
+	UINT16 old = k056832Regs[(offset / 2) & 0x1f];
+
 	k056832Regs[(offset / 2) & 0x1f] = data;
-	k056832_word_write_update(offset);
+	k056832_word_write_update(offset, old);
 }
 
 void K056832ByteWrite(INT32 offset, UINT8 data)
 {
+	UINT16 old = k056832Regs[(offset / 2) & 0x1f];
+
 	UINT8 *regs = (UINT8*)k056832Regs;
 	regs[(offset & 0x3f) ^ 1] = data;
 
-	k056832_word_write_update(offset);
+	k056832_word_write_update(offset, old);
 }
 
 UINT16 K056832RomWordRead(UINT16 offset)
@@ -328,6 +355,7 @@ UINT16 K056832RomWordRead(UINT16 offset)
 void K056832HalfRamWriteWord(UINT32 offset, UINT16 data)
 {
 	K056832VideoRAM[m_selected_page_x4096 + (offset & 0xffe) + 1] = data;
+	k056832_mark_page_dirty(m_selected_page);
 }
 
 void K056832HalfRamWriteByte(UINT32 offset, UINT8 data)
@@ -335,6 +363,7 @@ void K056832HalfRamWriteByte(UINT32 offset, UINT8 data)
 	UINT8 *ram = (UINT8*)(K056832VideoRAM + (m_selected_page_x4096 + (offset & 0xffe) + 1));
 
 	ram[(offset & 1) ^ 1] = data;
+	k056832_mark_page_dirty(m_selected_page);
 }
 
 UINT16 K056832HalfRamReadWord(UINT32 offset)
@@ -353,6 +382,7 @@ void K056832RamWriteWord(UINT32 offset, UINT16 data)
 	offset = (offset & 0x1fff) / 2;
 
 	K056832VideoRAM[m_selected_page_x4096 + (offset)] = data;
+	k056832_mark_page_dirty(m_selected_page);
 }
 
 void K056832RamWriteByte(UINT32 offset, UINT8 data)
@@ -360,6 +390,7 @@ void K056832RamWriteByte(UINT32 offset, UINT8 data)
 	UINT8 *ram = (UINT8*)(K056832VideoRAM + m_selected_page_x4096);
 
 	ram[(offset & 0x1fff) ^ 1] = data;
+	k056832_mark_page_dirty(m_selected_page);
 }
 
 UINT16 K056832RamReadWord(UINT32 offset)
@@ -433,15 +464,46 @@ static inline UINT32 alpha_blend(UINT32 d, UINT32 s, UINT32 p)
 		((((s & 0x00ff00) * p) + ((d & 0x00ff00) * a)) & 0x00ff0000)) >> 8;
 }
 
-static void draw_layer_internal(INT32 layer, INT32 pageIndex, INT32 *clip, INT32 scrollx, INT32 scrolly, INT32 flags, INT32 priority)
+// Decoded tile attributes (code, colour and flip before the driver callback), one entry per
+// tile. A page is decoded again when its video ram or the registers change, or when it gets
+// drawn as a different layer (the flip override is per layer).
+static inline UINT32 k056832_decode_attr(INT32 attr, INT32 code, INT32 fbits, INT32 flipmask)
 {
 	static const struct K056832_SHIFTMASKS
 	{
 		INT32 flips, palm1, pals2, palm2;
 	}
 	k056832_shiftmasks[4] = {{6, 0x3f, 0, 0x00}, {4, 0x0f, 2, 0x30}, {2, 0x03, 2, 0x3c}, {0, 0x00, 2, 0x3f}};
-	const struct K056832_SHIFTMASKS *smptr;
+	const struct K056832_SHIFTMASKS *smptr = &k056832_shiftmasks[fbits];
+
+	INT32 flip  = flipmask & (attr >> smptr->flips) & 3;
+	INT32 color = (attr & smptr->palm1) | (attr >> smptr->pals2 & smptr->palm2);
+
+	return (code & 0xffff) | (color << 16) | (flip << 24);
+}
 
+static UINT32 *k056832_page_attr(INT32 pageIndex, INT32 layer)
+{
+	INT32 fbits = (k056832Regs[3] >> 6) & 3;
+	INT32 flipmask = (k056832Regs[1] >> (layer << 1)) & 0x3; // tile-flip override (see p.20 3.2.2 "REG2")
+	UINT32 *attr = K056832AttrCache + (pageIndex << 11);
+
+	if (K056832PageDirty[pageIndex] || K056832PageLayer[pageIndex] != layer)
+	{
+		UINT16 *pMem = &K056832VideoRAM[pageIndex << 12];
+
+		for (INT32 offs = 0; offs < 64 * 32; offs++, pMem += 2)
+			attr[offs] = k056832_decode_attr(pMem[0], pMem[1], fbits, flipmask);
+
+		K056832PageDirty[pageIndex] = 0;
+		K056832PageLayer[pageIndex] = layer;
+	}
+
+	return attr;
+}
+
+static void draw_layer_internal(INT32 layer, INT32 pageIndex, INT32 *clip, INT32 scrollx, INT32 scrolly, INT32 flags, INT32 priority)
+{
 	scrollx &= 0x1ff;
 	scrolly &= 0xff;
 
@@ -456,58 +518,76 @@ static void draw_layer_internal(INT32 layer, INT32 pageIndex, INT32 *clip, INT32
 
 	if (alpha == 255) alpha_enable = 0;
 
-	for (INT32 offs = 0; offs < 64 * 32; offs++)
+	if (m_layer_association)
 	{
-		INT32 sx = (offs & 0x3f) * 8;
-		INT32 sy = (offs / 0x40) * 8;
+		layer = m_layer_assoc_with_page[pageIndex];
+		if (layer == -1)
+			layer = 0;  // use layer 0's palette info for unmapped pages
+	}
+	else
+		layer = m_active_layer;
 
-		sx -= scrollx;
-		if (sx < -7) sx += 512;
-		sy -= scrolly;
+	UINT32 *attr = k056832_page_attr(pageIndex, layer);
+
+	// Only visit the tile rows and columns that reach into the clip rectangle
+	INT32 rows[32], row_sy[32], nrows = 0;
+	INT32 cols[64], col_sx[64], ncols = 0;
+
+	for (INT32 ty = 0; ty < 32; ty++)
+	{
+		INT32 sy = ty * 8 - scrolly;
 		if (sy < -7) sy += 256;
+		if (tilemap_flip & 2) sy = (256 - 8) - sy;
+
+		if (sy < (miny-7) || sy > maxy) continue;
+
+		rows[nrows] = ty;
+		row_sy[nrows++] = sy;
+	}
 
+	for (INT32 tx = 0; tx < 64; tx++)
+	{
+		INT32 sx = tx * 8 - scrollx;
+		if (sx < -7) sx += 512;
 		if (tilemap_flip & 1) sx = (512 - 8) - sx;
-		if (tilemap_flip & 2) sy = (256 - 8) - sy;
 
-		if (sy < (miny-7) || sy > maxy || sx < (minx-7) || sx > maxx) continue;
+		if (sx < (minx-7) || sx > maxx) continue;
 
-		UINT16 *pMem = &K056832VideoRAM[(pageIndex << 12) + (offs << 1)];
+		cols[ncols] = tx;
+		col_sx[ncols++] = sx;
+	}
 
-		INT32 attr  = pMem[0];
-		INT32 code  = pMem[1];
+	for (INT32 r = 0; r < nrows; r++)
+	{
+		INT32 sy = row_sy[r];
 
-		if (m_layer_association)
-		{
-			layer = m_layer_assoc_with_page[pageIndex];
-			if (layer == -1)
-				layer = 0;  // use layer 0's palette info for unmapped pages
-		}
-		else
-			layer = m_active_layer;
+		// clip the tile rows once
+		INT32 iy0 = (sy < miny) ? (miny - sy) : 0;
+		INT32 iy1 = (sy + 7 > maxy) ? (maxy - sy + 1) : 8;
 
-		INT32 fbits = (k056832Regs[3] >> 6) & 3;
-		INT32 flip  = (k056832Regs[1] >> (layer << 1)) & 0x3; // tile-flip override (see p.20 3.2.2 "REG2")
-		smptr = &k056832_shiftmasks[fbits];
+		for (INT32 c = 0; c < ncols; c++)
+		{
+			INT32 sx = col_sx[c];
+			UINT32 tattr = attr[(rows[r] << 6) | cols[c]];
 
-		flip &= (attr >> smptr->flips) & 3;
-		INT32 color = (attr & smptr->palm1) | (attr >> smptr->pals2 & smptr->palm2);
-		INT32 g_flags = flip & 3;
+			INT32 code    = tattr & 0xffff;
+			INT32 color   = (tattr >> 16) & 0xff;
+			INT32 g_flags = (tattr >> 24) & 3;
 
-		m_callback(layer, &code, &color, &g_flags);
+			m_callback(layer, &code, &color, &g_flags);
 
-		// hack - mystic warriors' water level - iq
-		if (g_flags & 0x8000) {
-			alpha_enable = 1;
-			alpha = (g_flags >> 16) & 0xff;
-		}
+			// hack - mystic warriors' water level - iq
+			if (g_flags & 0x8000) {
+				alpha_enable = 1;
+				alpha = (g_flags >> 16) & 0xff;
+			}
 
-	//	code &= K056832RomExpMask; // mask in callback if necessary
+		//	code &= K056832RomExpMask; // mask in callback if necessary
 
-		if (!opaque) {
-			if (K056832TransTab[code]) continue;
-		}
+			if (!opaque) {
+				if (K056832TransTab[code]) continue;
+			}
 
-		{
 			if (tilemap_flip & 1) g_flags ^= 1;
 			if (tilemap_flip & 2) g_flags ^= 2;
 
@@ -518,46 +598,45 @@ static void draw_layer_internal(INT32 layer, INT32 pageIndex, INT32 *clip, INT32
 			if (g_flags & 0x01) flip_tile |= 0x07;
 			if (g_flags & 0x02) flip_tile |= 0x38;
 
-			UINT8 *pri = konami_priority_bitmap + ((sy -  CLIP_MINY) * nScreenWidth) - CLIP_MINX;
-			UINT32 *dst = konami_bitmap32 + ((sy -  CLIP_MINY) * nScreenWidth) - CLIP_MINX;
+			// and the columns
+			INT32 ix0 = (sx < minx) ? (minx - sx) : 0;
+			INT32 ix1 = (sx + 7 > maxx) ? (maxx - sx + 1) : 8;
 
-			{
-				if (alpha_enable) {
-					for (INT32 iy = 0; iy < 8; iy++, dst += nScreenWidth, pri += nScreenWidth) {
-						INT32 yy = sy+iy;
-		
-						if (yy < miny || yy > maxy) continue;
-	
-						for (INT32 ix = 0; ix < 8; ix++) {
-							INT32 xx = sx+ix;
-		
-							if (xx < minx || xx > maxx) continue;
-		
-							INT32 pxl = rom[((iy*8)+ix)^flip_tile];
-		
-							if (pxl || opaque) {
-								dst[xx] = alpha_blend(dst[xx], pal[pxl], alpha);
-								pri[xx] = priority;
-							}
+			UINT8 *pri = konami_priority_bitmap + ((sy + iy0 - CLIP_MINY) * nScreenWidth) - CLIP_MINX + sx;
+			UINT32 *dst = konami_bitmap32 + ((sy + iy0 - CLIP_MINY) * nScreenWidth) - CLIP_MINX + sx;
+
+			if (alpha_enable) {
+				for (INT32 iy = iy0; iy < iy1; iy++, dst += nScreenWidth, pri += nScreenWidth) {
+					UINT8 *src = rom + ((iy * 8) ^ (flip_tile & 0x38));
+
+					for (INT32 ix = ix0; ix < ix1; ix++) {
+						INT32 pxl = src[ix ^ (flip_tile & 7)];
+
+						if (pxl || opaque) {
+							dst[ix] = alpha_blend(dst[ix], pal[pxl], alpha);
+							pri[ix] = priority;
 						}
 					}
-				} else {
-					for (INT32 iy = 0; iy < 8; iy++, dst += nScreenWidth, pri += nScreenWidth) {
-						INT32 yy = sy+iy;
-		
-						if (yy < miny || yy > maxy) continue;
-			
-						for (INT32 ix = 0; ix < 8; ix++) {
-							INT32 xx = sx+ix;
-		
-							if (xx < minx || xx > maxx) continue;
-		
-							INT32 pxl = rom[((iy*8)+ix)^flip_tile];
-		
-							if (pxl || opaque) {
-								dst[xx] = pal[pxl];
-								pri[xx] = priority;
-							}
+				}
+			} else if (opaque) {
+				for (INT32 iy = iy0; iy < iy1; iy++, dst += nScreenWidth, pri += nScreenWidth) {
+					UINT8 *src = rom + ((iy * 8) ^ (flip_tile & 0x38));
+
+					for (INT32 ix = ix0; ix < ix1; ix++) {
+						dst[ix] = pal[src[ix ^ (flip_tile & 7)]];
+						pri[ix] = priority;
+					}
+				}
+			} else {
+				for (INT32 iy = iy0; iy < iy1; iy++, dst += nScreenWidth, pri += nScreenWidth) {
+					UINT8 *src = rom + ((iy * 8) ^ (flip_tile & 0x38));
+
+					for (INT32 ix = ix0; ix < ix1; ix++) {
+						INT32 pxl = src[ix ^ (flip_tile & 7)];
+
+						if (pxl) {
+							dst[ix] = pal[pxl];
+							pri[ix] = priority;
 						}
 					}
 				}
@@ -918,4 +997,8 @@ void K056832Scan(INT32 nAction)
 		SCAN_VAR(tilemap_flip);
 		SCAN_VAR(m_rom_half);
 	}
+
+	if (nAction & ACB_WRITE) {
+		k056832_mark_all_dirty();
+	}
 }
@@ -20,6 +20,17 @@ static INT32 *K054338_shdRGB;
 
 static UINT8 *gx_shdzbuf, *gx_objzbuf;
 
+#define GX_ZBUFW	512
+#define GX_ZBUFH	256
+
+// x range (start, end) of each z-buffer row that sprites have written since it was last wiped
+static INT16 gx_objzdirty[GX_ZBUFH][2];
+static INT16 gx_shdzdirty[GX_ZBUFH][2];
+
+static UINT32 gx_mixer_time[GX_TIME_STAGES];
+static UINT64 gx_mixer_time_total[GX_TIME_STAGES];
+static UINT32 gx_mixer_runs;
+
 static INT32 k053247_vrcbk[4];
 static INT32 k053247_opset;
 static INT32 k053247_coreg;
@@ -83,6 +94,16 @@ void konamigx_mixer_init(INT32 objdma)
 
 	gx_objpool = (struct GX_OBJ*)BurnMalloc(GX_MAX_OBJECTS * sizeof(GX_OBJ));
 
+	// nothing has been wiped yet, so the first wipe has to clear everything
+	for (INT32 i = 0; i < GX_ZBUFH; i++) {
+		gx_objzdirty[i][0] = gx_shdzdirty[i][0] = 0;
+		gx_objzdirty[i][1] = gx_shdzdirty[i][1] = GX_ZBUFW;
+	}
+
+	memset(gx_mixer_time, 0, sizeof(gx_mixer_time));
+	memset(gx_mixer_time_total, 0, sizeof(gx_mixer_time_total));
+	gx_mixer_runs = 0;
+
 	K054338_export_config(&K054338_shdRGB);
 
 	gx_spriteram = (UINT16*)K053247Ram;
@@ -108,27 +129,101 @@ void konamigx_mixer_exit()
 	}
 	BurnFree(gx_objpool);
 	m_gx_objdma = 0;
+
+	if (gx_mixer_runs) {
+		bprintf(PRINT_NORMAL, _T("    GX mixer: %d frames, wipe %d us, build %d us, sort %d us, draw %d us average.\n"), gx_mixer_runs,
+			(INT32)(gx_mixer_time_total[GX_TIME_WIPE] / gx_mixer_runs), (INT32)(gx_mixer_time_total[GX_TIME_BUILD] / gx_mixer_runs),
+			(INT32)(gx_mixer_time_total[GX_TIME_SORT] / gx_mixer_runs), (INT32)(gx_mixer_time_total[GX_TIME_DRAW] / gx_mixer_runs));
+	}
 }
 
-static void gx_wipezbuf(INT32 noshadow)
+UINT32 konamigx_mixer_get_time(INT32 stage)
 {
-#define GX_ZBUFW	512
+	if (stage < 0 || stage >= GX_TIME_STAGES) return 0;
+
+	return gx_mixer_time[stage];
+}
+
+void konamigx_mixer_mark_zbuf(INT32 shadow, INT32 x, INT32 y, INT32 w, INT32 h)
+{
+	INT16 (*dirty)[2] = shadow ? gx_shdzdirty : gx_objzdirty;
+
+	if (y + h > GX_ZBUFH) h = GX_ZBUFH - y;
+	if (x + w > GX_ZBUFW) w = GX_ZBUFW - x;
+
+	for (INT32 i = y; i < y + h; i++)
+	{
+		if (dirty[i][0] > x) dirty[i][0] = x;
+		if (dirty[i][1] < x + w) dirty[i][1] = x + w;
+	}
+}
+
+// wipe the dirty part of the first h rows, never touching the last column (w is one short of the screen, as always)
+static void gx_wipezrows(UINT8 *zbuf, INT16 (*dirty)[2], INT32 w, INT32 h, INT32 bytes)
+{
+	for (INT32 i = 0; i < h; i++)
+	{
+		INT32 sx = dirty[i][0];
+		INT32 ex = dirty[i][1];
+		if (ex > w) ex = w;
 
+		if (sx < ex) memset(zbuf + (i * GX_ZBUFW + sx) * bytes, -1, (ex - sx) * bytes);
+
+		dirty[i][0] = GX_ZBUFW;
+		dirty[i][1] = 0;
+	}
+}
+
+static void gx_wipezbuf(INT32 noshadow)
+{
 	INT32 w = (nScreenWidth - 1);
 	INT32 h = (nScreenHeight - 1);
 
-	UINT8 *zptr = gx_objzbuf;
-	INT32 ecx = h;
-
-	do { memset(zptr, -1, w); zptr += GX_ZBUFW; } while (--ecx);
+	// only sprites write the z-buffers, so rows they haven't touched are still clear
+	gx_wipezrows(gx_objzbuf, gx_objzdirty, w, h, 1);
 
 	if (!noshadow)
+		gx_wipezrows(gx_shdzbuf, gx_shdzdirty, w, h, 2);
+}
+
+// sort objects in descending order with a radix sort on the order key, ties going to the
+// later object (the same order the old selection sort produced)
+static void gx_sortobjects(struct GX_OBJ *objpool, INT32 *objbuf, INT32 nobj)
+{
+	INT32 temp[GX_MAX_OBJECTS];
+	INT32 count[256];
+	INT32 *src = objbuf, *dst = temp;
+
+	if (nobj < 2) return;
+
+	for (INT32 i = 0; i < nobj; i++)
+		objbuf[i] = nobj - 1 - i;
+
+	for (INT32 shift = 0; shift < 32; shift += 8)
 	{
-		zptr = gx_shdzbuf;
-		w <<= 1;
-		ecx = h;
-		do { memset(zptr, -1, w); zptr += (GX_ZBUFW<<1); } while (--ecx);
+		memset(count, 0, sizeof(count));
+
+		for (INT32 i = 0; i < nobj; i++)
+			count[((UINT32)objpool[src[i]].order >> shift) & 0xff]++;
+
+		// every key shares this byte, so this pass wouldn't move anything
+		if (count[((UINT32)objpool[src[0]].order >> shift) & 0xff] == nobj) continue;
+
+		// bucket offsets, highest byte first
+		for (INT32 i = 255, pos = 0; i >= 0; i--)
+		{
+			INT32 n = count[i];
+			count[i] = pos;
+			pos += n;
+		}
+
+		for (INT32 i = 0; i < nobj; i++)
+			dst[count[((UINT32)objpool[src[i]].order >> shift) & 0xff]++] = src[i];
+
+		INT32 *swap = src; src = dst; dst = swap;
 	}
+
+	if (src != objbuf) memcpy(objbuf, src, nobj * sizeof(INT32));
 }
 
 void konamigx_mixer_primode(INT32 mode)
@@ -412,11 +507,16 @@ void konamigx_mixer(INT32 sub1 /*extra tilemap 1*/, INT32 sub1flags, INT32 sub2
 	cltc_shdpri &= K338_CTL_SHDPRI;
 
 	// wipe z-buffer
+	UINT64 times[GX_TIME_STAGES + 1];
+	times[GX_TIME_WIPE] = BurnGetTicks();
+
 	if (mixerflags & GXMIX_NOZBUF)
 		mixerflags |= GXMIX_NOSHADOW;
 	else
 		gx_wipezbuf(mixerflags & GXMIX_NOSHADOW);
 
+	times[GX_TIME_BUILD] = BurnGetTicks();
+
 	// cache global parameters
 	konamigx_precache_registers();
 
@@ -459,10 +559,9 @@ void konamigx_mixer(INT32 sub1 /*extra tilemap 1*/, INT32 sub1flags, INT32 sub2
 
 	shadowon[2] = shadowon[1] = shadowon[0] = 0;
 
-	INT32 k = 0;
 	if (!(mixerflags & GXMIX_NOSHADOW))
 	{
-		INT32 i,j;
+		INT32 i,j,k;
 		// only enable shadows beyond a +/-7 RGB threshold
 		for (j=0,i=0; i<3; j+=3,i++)
 		{
@@ -540,7 +639,6 @@ void konamigx_mixer(INT32 sub1 /*extra tilemap 1*/, INT32 sub1flags, INT32 sub2
 	}
 
 //  i = j = 0xff;
-	INT32 l = 0;
 
 	for (INT32 offs=0; offs<0x800; offs+=8)
 	{
@@ -554,8 +652,8 @@ void konamigx_mixer(INT32 sub1 /*extra tilemap 1*/, INT32 sub1flags, INT32 sub2
 		if (k053247_opset & 0x10) zcode = 0xff - zcode;
 
 		INT32 code  = gx_spriteram[offs+1];
-		INT32 color = k = gx_spriteram[offs+6];
-		l     = gx_spriteram[offs+7];
+		INT32 k     = gx_spriteram[offs+6];
+		INT32 color = k;
 
 		K053247Callback(&code, &color, &pri);
 
@@ -683,21 +781,20 @@ void konamigx_mixer(INT32 sub1 /*extra tilemap 1*/, INT32 sub1flags, INT32 sub2
 		}
 	}
 
-	// sort objects in decending order (SLOW)
-	k = nobj;
-	l = nobj - 1;
+	// sort objects in decending order
+	times[GX_TIME_SORT] = BurnGetTicks();
 
-	for (INT32 j=0; j<l; j++)
-	{
-		INT32 temp1 = objbuf[j];
-		INT32 temp2 = objpool[temp1].order;
-		for (INT32 i=j+1; i<k; i++)
-		{
-			INT32 temp3 = objbuf[i];
-			INT32 temp4 = objpool[temp3].order;
-			if ((UINT32)temp2 <= (UINT32)temp4) { temp2 = temp4; objbuf[i] = temp1; objbuf[j] = temp1 = temp3; }
-		}
-	}
+	gx_sortobjects(objpool, objbuf, nobj);
+
+	times[GX_TIME_DRAW] = BurnGetTicks();
 
 	konamigx_mixer_draw(sub1,sub1flags,sub2,sub2flags,mixerflags,extra_bitmap,rushingheroes_hack,objpool,objbuf,nobj);
+
+	times[GX_TIME_STAGES] = BurnGetTicks();
+
+	for (INT32 i = 0; i < GX_TIME_STAGES; i++) {
+		gx_mixer_time[i] = (UINT32)(times[i + 1] - times[i]);
+		gx_mixer_time_total[i] += gx_mixer_time[i];
+	}
+	gx_mixer_runs++;
 }
@@ -496,3 +496,15 @@ void konamigx_mixer_init(int objdma);
 void konamigx_mixer_exit();
 void konamigx_mixer_primode(int mode);
 void konamigx_mixer(int sub1 /*extra tilemap 1*/, int sub1flags, int sub2 /*extra tilemap 2*/, int sub2flags, int mixerflags, int extra_bitmap /*extra tilemap 3*/, int rushingheroes_hack);
+
+// called by the GX sprite renderer for every rectangle it z-buffers, so the next wipe can skip untouched rows
+void konamigx_mixer_mark_zbuf(int shadow, int x, int y, int w, int h);
+
+// time (in microseconds) each stage of the last konamigx_mixer() call took, for profiling
+#define GX_TIME_WIPE    0               // z-buffer wipe
+#define GX_TIME_BUILD   1               // object pool build
+#define GX_TIME_SORT    2               // object pool sort
+#define GX_TIME_DRAW    3               // layer & sprite drawing
+#define GX_TIME_STAGES  4
+
+UINT32 konamigx_mixer_get_time(int stage);
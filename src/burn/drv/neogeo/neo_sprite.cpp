@@ -1,4 +1,5 @@
 #include "neogeo.h"
+#include "burn_band.h"
 
 UINT8* NeoZoomROM;
 
@@ -16,14 +17,17 @@ static UINT8* NeoTileAttribActive;
 
 INT32 nSliceStart, nSliceEnd, nSliceSize;
 
-static UINT32* pTileData;
-static UINT32* pTilePalette;
+// Everything the bank renderers touch is private to the band being drawn
+static BURN_BAND_TLS INT32 nSpriteSliceStart, nSpriteSliceEnd;
 
-static UINT16* pBank;
+static BURN_BAND_TLS UINT32* pTileData;
+static BURN_BAND_TLS UINT32* pTilePalette;
 
-static INT32 nBankSize;
-static INT32 nBankXPos, nBankYPos;
-static INT32 nBankXZoom, nBankYZoom;
+static BURN_BAND_TLS UINT16* pBank;
+
+static BURN_BAND_TLS INT32 nBankSize;
+static BURN_BAND_TLS INT32 nBankXPos, nBankYPos;
+static BURN_BAND_TLS INT32 nBankXZoom, nBankYZoom;
 
 static INT32 nNeoSpriteFrame04, nNeoSpriteFrame08;
 
@@ -32,7 +36,13 @@ static INT32 nLastBPP = -1;
 typedef void (*RenderBankFunction)();
 static RenderBankFunction* RenderBank;
 
-static 	UINT16 BankAttrib01, BankAttrib02, BankAttrib03;
+static BURN_BAND_TLS UINT16 BankAttrib01, BankAttrib02, BankAttrib03;
+
+// Sprite chains carry their position over from the previous bank (and from the
+// previous slice), so each band starts from a copy of the caller's chain state
+static INT32 nSpriteBankStart;
+static INT32 nChainSize, nChainXPos, nChainYPos, nChainXZoom, nChainYZoom;
+static INT32 nChainNextSize, nChainNextXPos, nChainNextYPos, nChainNextXZoom, nChainNextYZoom;
 
 static inline UINT32 alpha_blend(UINT32 d, UINT32 s, UINT32 p)
 {
@@ -45,39 +55,19 @@ static inline UINT32 alpha_blend(UINT32 d, UINT32 s, UINT32 p)
 // Include the tile rendering functions
 #include "neo_sprite_func.h"
 
-INT32 NeoRenderSprites()
+static void NeoRenderSpriteBand(INT32 nBand, INT32 nStart, INT32 nEnd)
 {
-	if (nLastBPP != nBurnBpp ) {
-		nLastBPP = nBurnBpp;
-
-		RenderBank = RenderBankNormal[nBurnBpp - 2];
-	}
-
-	if (!NeoSpriteROMActive || !(nBurnLayer & 1)) {
-		return 0;
-	}
-
-//	UINT16 BankAttrib01, BankAttrib02, BankAttrib03;
-
-	nNeoSpriteFrame04 = nNeoSpriteFrame & 3;
-	nNeoSpriteFrame08 = nNeoSpriteFrame & 7;
-	
-	// ssrpg hack! - NeoCD/SDL
-	INT32 nStart = 0;
-	if (SekReadWord(0x108) == 0x0085) {
-		UINT16 *vidram = (UINT16*)NeoGraphicsRAM;
-
-	   	if ((vidram[0x8202] & 0x40) == 0 && (vidram[0x8203] & 0x40) != 0) {
-			nStart = 3;
+	nSpriteSliceStart = nStart;
+	nSpriteSliceEnd   = nEnd;
 
-			while ((vidram[0x8200 + nStart] & 0x40) != 0) nStart++;
-
-			if (nStart == 3) nStart = 0;
-		}
-	}
+	nBankSize  = nChainSize;
+	nBankXPos  = nChainXPos;
+	nBankYPos  = nChainYPos;
+	nBankXZoom = nChainXZoom;
+	nBankYZoom = nChainYZoom;
 
 	for (INT32 nBank = 0; nBank < 0x17D; nBank++) {
-		INT32 zBank = (nBank + nStart) % 0x17d;
+		INT32 zBank = (nBank + nSpriteBankStart) % 0x17d;
 		BankAttrib01 = *((UINT16*)(NeoGraphicsRAM + 0x010000 + (zBank << 1)));
 		BankAttrib02 = *((UINT16*)(NeoGraphicsRAM + 0x010400 + (zBank << 1)));
 		BankAttrib03 = *((UINT16*)(NeoGraphicsRAM + 0x010800 + (zBank << 1)));
@@ -96,7 +86,7 @@ INT32 NeoRenderSprites()
 			nBankYZoom = BankAttrib01 & 0xFF;
 			nBankSize  = BankAttrib02 & 0x3F;
 
-//			if (nBankSize > 0x10 && nSliceStart == 0x10) bprintf(PRINT_NORMAL, _T("bank: %04X, x: %04X, y: %04X, zoom: %02X, size: %02X.\n"), zBank, nBankXPos, nBankYPos, nBankYZoom, nBankSize);
+//			if (nBankSize > 0x10 && nSpriteSliceStart == 0x10) bprintf(PRINT_NORMAL, _T("bank: %04X, x: %04X, y: %04X, zoom: %02X, size: %02X.\n"), zBank, nBankXPos, nBankYPos, nBankYZoom, nBankSize);
 		}
 
 		if (nBankSize) {
@@ -115,6 +105,56 @@ INT32 NeoRenderSprites()
 		}
 	}
 
+	// Every band ends on the same chain state, keep the first one's
+	if (nBand == 0) {
+		nChainNextSize  = nBankSize;
+		nChainNextXPos  = nBankXPos;
+		nChainNextYPos  = nBankYPos;
+		nChainNextXZoom = nBankXZoom;
+		nChainNextYZoom = nBankYZoom;
+	}
+}
+
+INT32 NeoRenderSprites()
+{
+	if (nLastBPP != nBurnBpp ) {
+		nLastBPP = nBurnBpp;
+
+		RenderBank = RenderBankNormal[nBurnBpp - 2];
+	}
+
+	if (!NeoSpriteROMActive || !(nBurnLayer & 1)) {
+		return 0;
+	}
+
+	nNeoSpriteFrame04 = nNeoSpriteFrame & 3;
+	nNeoSpriteFrame08 = nNeoSpriteFrame & 7;
+	
+	// ssrpg hack! - NeoCD/SDL
+	INT32 nStart = 0;
+	if (SekReadWord(0x108) == 0x0085) {
+		UINT16 *vidram = (UINT16*)NeoGraphicsRAM;
+
+	   	if ((vidram[0x8202] & 0x40) == 0 && (vidram[0x8203] & 0x40) != 0) {
+			nStart = 3;
+
+			while ((vidram[0x8200 + nStart] & 0x40) != 0) nStart++;
+
+			if (nStart == 3) nStart = 0;
+		}
+	}
+
+	nSpriteBankStart = nStart;
+
+	// Split the slice into bands; each band walks every sprite chain but only draws its own lines
+	BurnBandRun(NeoRenderSpriteBand, nSliceStart, nSliceEnd);
+
+	nChainSize  = nChainNextSize;
+	nChainXPos  = nChainNextXPos;
+	nChainYPos  = nChainNextYPos;
+	nChainXZoom = nChainNextXZoom;
+	nChainYZoom = nChainNextYZoom;
+
 //	bprintf(PRINT_NORMAL, _T("\n"));
 
 	return 0;
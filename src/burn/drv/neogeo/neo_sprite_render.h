@@ -500,13 +500,13 @@ static void FUNCTIONNAME(BPP,XZOOM,CLIP,OPACITY)()
 //		bprintf(PRINT_NORMAL, _T("  - s:%i l:%i y:%i %i z:%i\n"), nLinesTotal, nLinesDone, nYPos, nBankYPos, nBankYZoom);
 
 		// Skip everything above the part of the display we need to render
-		if (nYPos < nSliceStart) {
-			nLinesDone += nSliceStart - nYPos;
+		if (nYPos < nSpriteSliceStart) {
+			nLinesDone += nSpriteSliceStart - nYPos;
 			continue;
 		}
 		// Skip everything below the part of the display we need to render
-		if (nYPos >= nSliceEnd) {
-			nLinesDone += nSliceStart + 512 - nYPos;
+		if (nYPos >= nSpriteSliceEnd) {
+			nLinesDone += nSpriteSliceStart + 512 - nYPos;
 			continue;
 		}
 
@@ -587,8 +587,8 @@ static void FUNCTIONNAME(BPP,XZOOM,CLIP,OPACITY)()
 #endif
 
 			// Clip to the part of the screen we need to render
-			if (nEndLine - nStartLine > nSliceEnd - nYPos - 1) {
-				nEndLine = nStartLine + nSliceEnd - nYPos - 1;
+			if (nEndLine - nStartLine > nSpriteSliceEnd - nYPos - 1) {
+				nEndLine = nStartLine + nSpriteSliceEnd - nYPos - 1;
 			}
 
 			pTileRow = pBurnDraw + (nYPos - 0x10) * (BPP >> 3) * nNeoScreenWidth + nBankXPos * (BPP >> 3);
@@ -1,5 +1,6 @@
 #include "pgm.h"
 #include "pgm_sprite.h"
+#include "burn_band.h"
 
 //#define DUMP_SPRITE_BITMAPS
 //#define DRAW_SPRITE_NUMBER
@@ -10,12 +11,18 @@ static INT32   nTileMask = 0;
 static UINT8   sprmsktab[0x100];
 static UINT8  *SpritePrio;		// sprite priorities
 static UINT16 *pTempScreen;		// sprites
-static UINT16 *pTempDraw;		// pre-zoomed sprites
+static UINT16 *pTempDrawBand[BURN_BAND_MAX_THREADS];	// pre-zoomed sprites, one per band
 static UINT8  *tiletrans;		// tile transparency table
 static UINT8  *texttrans;		// text transparency table
 static UINT32 *pTempDraw32;		// 32 bit temporary bitmap (blending!)
 static UINT8  *pSpriteBlendTable;	// if blending is available, allocate this.
 
+// The screen can be drawn in horizontal bands on several threads (see burn_band.h),
+// everything below only touches the lines between nClipMinY and nClipMaxY.
+static BURN_BAND_TLS INT32 nClipMinY;
+static BURN_BAND_TLS INT32 nClipMaxY;
+static BURN_BAND_TLS UINT16 *pTempDraw;
+
 static inline UINT32 alpha_blend(UINT32 d, UINT32 s, UINT32 p)
 {
 	INT32 a = 255 - p;
@@ -62,7 +69,7 @@ static void draw_font(INT32 sx, INT32 sy, UINT32 code)
 
 		if (enable_blending) {
 			for (INT32 y = 0; y < 7; y++) {
-				if ((sy+y)<0 || (sy+y)>=nScreenHeight) continue; // clip
+				if ((sy+y)<nClipMinY || (sy+y)>=nClipMaxY) continue; // clip
 	
 				UINT32 *dst = pTempDraw32 + (sy + y) * nScreenWidth;
 	
@@ -79,7 +86,7 @@ static void draw_font(INT32 sx, INT32 sy, UINT32 code)
 			}
 		} else {
 			for (INT32 y = 0; y < 7; y++) {
-				if ((sy+y)<0 || (sy+y)>=nScreenHeight) continue; // clip
+				if ((sy+y)<nClipMinY || (sy+y)>=nClipMaxY) continue; // clip
 	
 				UINT16 *dst = pTransDraw + (sy + y) * nScreenWidth;
 	
@@ -252,24 +259,29 @@ static void pgm_draw_sprite_nozoom(INT32 wide, INT32 high, INT32 palt, INT32 bof
 
 	sprite_draw_nozoom_function *drawsprite = nozoom_draw_table[flipx ? 1 : 0];
 
+	INT32 miny = nClipMinY;
+	INT32 maxy = nClipMaxY;
+
+	if (ypos >= maxy || (ypos + high) <= miny) return;
+
 	for (INT32 ycnt = 0; ycnt < high; ycnt++) {
 		if (flipy) {
 			yoff = ypos + ((high-1) - ycnt);
-			if (yoff < 0) break;
-			if (yoff < nScreenHeight) {
+			if (yoff < miny) break;
+			if (yoff < maxy) {
 				dest = pTempScreen + (yoff * nScreenWidth);
 				pdest = SpritePrio + (yoff * nScreenWidth);
 			}
 		} else {
 			yoff = ypos + ycnt;
-			if (yoff >= nScreenHeight) break;
-			if (yoff >= 0)  {
+			if (yoff >= maxy) break;
+			if (yoff >= miny)  {
 				dest = pTempScreen + (yoff * nScreenWidth);
 				pdest = SpritePrio + (yoff * nScreenWidth);
 			}
 		}
 
-		if (yoff >= 0 && yoff < nScreenHeight && xpos >= 0 && (xpos + wide) < nScreenWidth)
+		if (yoff >= miny && yoff < maxy && xpos >= 0 && (xpos + wide) < nScreenWidth)
 		{
 			for (INT32 xcnt = 0; xcnt < wide; xcnt+=8)
 			{
@@ -289,7 +301,7 @@ static void pgm_draw_sprite_nozoom(INT32 wide, INT32 high, INT32 palt, INT32 bof
 				boffset++;
 				aoffset &= adatasize;
 
-				if (yoff < 0 || yoff >= nScreenHeight || msk == 0) {
+				if (yoff < miny || yoff >= maxy || msk == 0) {
 					aoffset += sprmsktab[msk];
 
 					continue;
@@ -540,6 +552,11 @@ static void draw_sprite_new_zoomed(INT32 wide, INT32 high, INT32 xpos, INT32 ypo
 	INT32 yoffset;
 	INT32 ycntdraw;
 	INT32 yzoombit;
+	INT32 miny = nClipMinY;
+	INT32 maxy = nClipMaxY;
+
+	// a growing sprite draws at most two lines per source line, don't decode it if they all miss
+	if (ypos >= maxy || (ypos + (ygrow ? 2 * high : high)) <= miny) return;
 
 	pgm_prepare_sprite(wide, high, palt, boffset);
 
@@ -555,7 +572,7 @@ static void draw_sprite_new_zoomed(INT32 wide, INT32 high, INT32 xpos, INT32 ypo
 
 			if (!(flip&0x02)) yoffset = (ycnt*(wide*16));
 			else yoffset = ( (high-ycnt-1)*(wide*16));
-			if ((ydrawpos >= 0) && (ydrawpos < 224))
+			if ((ydrawpos >= miny) && (ydrawpos < maxy))
 			{
 				dest = pTempScreen + ydrawpos * nScreenWidth;
 				pdest = SpritePrio + ydrawpos * nScreenWidth;
@@ -566,7 +583,7 @@ static void draw_sprite_new_zoomed(INT32 wide, INT32 high, INT32 xpos, INT32 ypo
 			ydrawpos = ypos + ycntdraw;
 			if (!(flip&0x02)) yoffset = (ycnt*(wide*16));
 			else yoffset = ( (high-ycnt-1)*(wide*16));
-			if ((ydrawpos >= 0) && (ydrawpos < 224))
+			if ((ydrawpos >= miny) && (ydrawpos < maxy))
 			{
 				dest = pTempScreen + ydrawpos * nScreenWidth;
 				pdest = SpritePrio + ydrawpos * nScreenWidth;
@@ -574,7 +591,7 @@ static void draw_sprite_new_zoomed(INT32 wide, INT32 high, INT32 xpos, INT32 ypo
 			}
 			ycntdraw++;
 
-			if (ydrawpos == 224) ycnt = high;
+			if (ydrawpos == maxy) ycnt = high;
 		}
 		else if (yzoombit ==1 && ygrow == 0)
 		{
@@ -587,7 +604,7 @@ static void draw_sprite_new_zoomed(INT32 wide, INT32 high, INT32 xpos, INT32 ypo
 
 			if (!(flip&0x02)) yoffset = (ycnt*(wide*16));
 			else yoffset = ( (high-ycnt-1)*(wide*16));
-			if ((ydrawpos >= 0) && (ydrawpos < 224))
+			if ((ydrawpos >= miny) && (ydrawpos < maxy))
 			{
 				dest = pTempScreen + ydrawpos * nScreenWidth;
 				pdest = SpritePrio + ydrawpos * nScreenWidth;
@@ -595,7 +612,7 @@ static void draw_sprite_new_zoomed(INT32 wide, INT32 high, INT32 xpos, INT32 ypo
 			}
 			ycntdraw++;
 
-			if (ydrawpos == 224) ycnt = high;
+			if (ydrawpos == maxy) ycnt = high;
 		}
 
 		ycnt++;
@@ -649,11 +666,14 @@ static void copy_sprite_priority(INT32 prio)
 	UINT16 *src = pTempScreen;
 	UINT8 *pri = SpritePrio;
 
+	INT32 start = nClipMinY * nScreenWidth;
+	INT32 end = nClipMaxY * nScreenWidth;
+
 	if (enable_blending) {
 		UINT32 *dest = pTempDraw32;
 		INT32 blend_levels[16] = { 0x00, 0x1f, 0x2f, 0x3f, 0x4f, 0x5f, 0x6f, 0x7f, 0x8f, 0x9f, 0xaf, 0xbf, 0xcf, 0xdf, 0xef, 0xff };
 
-		for (INT32 i = 0; i < nScreenWidth * nScreenHeight; i++)
+		for (INT32 i = start; i < end; i++)
 		{
 			if (pri[i] == prio) {
 				if (src[i]&0xf000) {
@@ -665,7 +685,7 @@ static void copy_sprite_priority(INT32 prio)
 		}
 	} else {
 		UINT16 *dest = pTransDraw;
-		for (INT32 i = 0; i < nScreenWidth * nScreenHeight; i++)
+		for (INT32 i = start; i < end; i++)
 		{
 			if (pri[i] == prio) {
 				dest[i] = src[i];
@@ -674,6 +694,54 @@ static void copy_sprite_priority(INT32 prio)
 	}
 }
 
+// size x size tile clipped to the band, pixels equal to transpen are skipped. The generic
+// tile renderers share one pTileData pointer, so they can't be used from several threads.
+static void draw_tile(UINT8 *gfx, INT32 size, INT32 sx, INT32 sy, INT32 color, INT32 depth, INT32 transpen, INT32 flipx, INT32 flipy)
+{
+	INT32 xflip = flipx ? (size - 1) : 0;
+	INT32 yflip = flipy ? (size - 1) * size : 0;
+
+	INT32 miny = (sy < nClipMinY) ? (nClipMinY - sy) : 0;
+	INT32 maxy = ((sy + size) > nClipMaxY) ? (nClipMaxY - sy) : size;
+	INT32 minx = (sx < 0) ? -sx : 0;
+	INT32 maxx = ((sx + size) > nScreenWidth) ? (nScreenWidth - sx) : size;
+
+	color <<= depth;
+
+	if (enable_blending)
+	{
+		UINT32 *pal = RamCurPal + color;
+
+		for (INT32 y = miny; y < maxy; y++) {
+			UINT8 *src = gfx + ((y * size) ^ yflip);
+			UINT32 *dst = pTempDraw32 + ((sy + y) * nScreenWidth) + sx;
+
+			for (INT32 x = minx; x < maxx; x++) {
+				INT32 pxl = src[x ^ xflip];
+
+				if (pxl != transpen) {
+					dst[x] = pal[pxl];
+				}
+			}
+		}
+	}
+	else
+	{
+		for (INT32 y = miny; y < maxy; y++) {
+			UINT8 *src = gfx + ((y * size) ^ yflip);
+			UINT16 *dst = pTransDraw + ((sy + y) * nScreenWidth) + sx;
+
+			for (INT32 x = minx; x < maxx; x++) {
+				INT32 pxl = src[x ^ xflip];
+
+				if (pxl != transpen) {
+					dst[x] = pxl | color;
+				}
+			}
+		}
+	}
+}
+
 static void draw_text()
 {
 	UINT16 *vram = (UINT16*)PGMTxtRAM;
@@ -694,101 +762,14 @@ static void draw_text()
 		sy -= scrolly;
 		if (sy < -7) sy += 256;
 
-		if (sx >= nScreenWidth || sy >= nScreenHeight) continue;
+		if (sx >= nScreenWidth || sy >= nClipMaxY || (sy + 8) <= nClipMinY) continue;
 
 		INT32 attr  = BURN_ENDIAN_SWAP_INT16(vram[offs * 2 + 1]);
 		INT32 color = ((attr & 0x3e) >> 1) | 0x80;
 		INT32 flipx =  (attr & 0x40);
 		INT32 flipy =  (attr & 0x80);
 
-		if (enable_blending) 
-		{
-			UINT8 *gfx = PGMTileROM + (code * 0x40);
-			INT32 flip = (flipx ? 0x07 : 0) | (flipy ? 0x38 : 0);
-			UINT32 *pal = RamCurPal + color * 0x10;
-			UINT32 *dst = pTempDraw32 + (sy * nScreenWidth) + sx;
-
-			for (INT32 y = 0; y < 8; y++, dst += nScreenWidth) {
-				if ((sy+y) >= 0 && (sy+y)<nScreenHeight) {
-					for (INT32 x = 0; x < 8; x++) {
-						INT32 pxl = gfx[((y*8)+x)^flip];
-
-						if (pxl != 0xf) {
-							if ((sx+x)>=0 && (sx+x)<nScreenWidth) {
-								dst[x] = pal[pxl];
-							}
-						}
-					}
-				}
-			}
-		}
-		else
-		{
-			if (sx < 0 || sy < 0 || sx >= nScreenWidth - 8 || sy >= nScreenHeight - 8)
-			{
-				if (texttrans[code] & 2) { // opaque
-					if (flipy) {
-						if (flipx) {
-							Render8x8Tile_FlipXY_Clip(pTransDraw, code, sx, sy, color, 4, 0, PGMTileROM);
-						} else {
-							Render8x8Tile_FlipY_Clip(pTransDraw, code, sx, sy, color, 4, 0, PGMTileROM);
-						}
-					} else {
-						if (flipx) {
-							Render8x8Tile_FlipX_Clip(pTransDraw, code, sx, sy, color, 4, 0, PGMTileROM);
-						} else {
-							Render8x8Tile_Clip(pTransDraw, code, sx, sy, color, 4, 0, PGMTileROM);
-						}
-					}
-				} else {
-					if (flipy) {
-						if (flipx) {
-							Render8x8Tile_Mask_FlipXY_Clip(pTransDraw, code, sx, sy, color, 4, 15, 0, PGMTileROM);
-						} else {
-							Render8x8Tile_Mask_FlipY_Clip(pTransDraw, code, sx, sy, color, 4, 15, 0, PGMTileROM);
-						}
-					} else {
-						if (flipx) {
-							Render8x8Tile_Mask_FlipX_Clip(pTransDraw, code, sx, sy, color, 4, 15, 0, PGMTileROM);
-						} else {
-							Render8x8Tile_Mask_Clip(pTransDraw, code, sx, sy, color, 4, 15, 0, PGMTileROM);
-						}
-					}
-				}
-			}
-			else
-			{
-				if (texttrans[code] & 2) { // opaque
-					if (flipy) {
-						if (flipx) {
-							Render8x8Tile_FlipXY(pTransDraw, code, sx, sy, color, 4, 0, PGMTileROM);
-						} else {
-							Render8x8Tile_FlipY(pTransDraw, code, sx, sy, color, 4, 0, PGMTileROM);
-						}
-					} else {
-						if (flipx) {
-							Render8x8Tile_FlipX(pTransDraw, code, sx, sy, color, 4, 0, PGMTileROM);
-						} else {
-							Render8x8Tile(pTransDraw, code, sx, sy, color, 4, 0, PGMTileROM);
-						}
-					}
-				} else {
-					if (flipy) {
-						if (flipx) {
-							Render8x8Tile_Mask_FlipXY(pTransDraw, code, sx, sy, color, 4, 15, 0, PGMTileROM);
-						} else {
-							Render8x8Tile_Mask_FlipY(pTransDraw, code, sx, sy, color, 4, 15, 0, PGMTileROM);
-						}
-					} else {
-						if (flipx) {
-							Render8x8Tile_Mask_FlipX(pTransDraw, code, sx, sy, color, 4, 15, 0, PGMTileROM);
-						} else {
-							Render8x8Tile_Mask(pTransDraw, code, sx, sy, color, 4, 15, 0, PGMTileROM);
-						}
-					}
-				}
-			}
-		}
+		draw_tile(PGMTileROM + (code * 0x40), 8, sx, sy, color, 4, 0x0f, flipx, flipy);
 	}
 }
 
@@ -828,7 +809,7 @@ static void draw_background()
 			sy -= yscroll;
 			if (sy < -31) sy += 512;
 
-			if (sx >= nScreenWidth || sy >= nScreenHeight) continue;
+			if (sx >= nScreenWidth || sy >= nClipMaxY || (sy + 32) <= nClipMinY) continue;
 
 			INT32 code = BURN_ENDIAN_SWAP_INT16(vram[offs * 2]);
 			if (code >= nTileMask) continue;
@@ -837,101 +818,14 @@ static void draw_background()
 			INT32 flipy = BURN_ENDIAN_SWAP_INT16(vram[offs*2+1]) & 0x80;
 			INT32 flipx = BURN_ENDIAN_SWAP_INT16(vram[offs*2+1]) & 0x40;
 
-			if (enable_blending) 
-			{
-				UINT8 *gfx = PGMTileROMExp + (code * 0x400);
-				INT32 flip = (flipx ? 0x1f : 0) | (flipy ? 0x3e0 : 0);
-				UINT32 *pal = RamCurPal + color * 0x20;
-				UINT32 *dst = pTempDraw32 + (sy * nScreenWidth) + sx;
-	
-				for (INT32 y = 0; y < 32; y++, dst += nScreenWidth) {
-					if ((sy+y) >= 0 && (sy+y)<nScreenHeight) {
-						for (INT32 x = 0; x < 32; x++) {
-							INT32 pxl = gfx[((y*32)+x)^flip];
-	
-							if (pxl != 0x1f) {
-								if ((sx+x)>=0 && (sx+x)<nScreenWidth) {
-									dst[x] = pal[pxl];
-								}
-							}
-						}
-					}
-				}
-			}
-			else
-			{
-				if (sx < 0 || sy < 0 || sx >= nScreenWidth - 32 || sy >= nScreenHeight - 32)
-				{
-					if (tiletrans[code] & 2) { // opaque
-						if (flipy) {
-							if (flipx) {
-								Render32x32Tile_FlipXY_Clip(pTransDraw, code, sx, sy, color, 5, 0, PGMTileROMExp);
-							} else {
-								Render32x32Tile_FlipY_Clip(pTransDraw, code, sx, sy, color, 5, 0, PGMTileROMExp);
-							}
-						} else {
-							if (flipx) {
-								Render32x32Tile_FlipX_Clip(pTransDraw, code, sx, sy, color, 5, 0, PGMTileROMExp);
-							} else {
-								Render32x32Tile_Clip(pTransDraw, code, sx, sy, color, 5, 0, PGMTileROMExp);
-							}
-						}
-					} else {
-						if (flipy) {
-							if (flipx) {
-								Render32x32Tile_Mask_FlipXY_Clip(pTransDraw, code, sx, sy, color, 5, 0x1f, 0, PGMTileROMExp);
-							} else {
-								Render32x32Tile_Mask_FlipY_Clip(pTransDraw, code, sx, sy, color, 5, 0x1f, 0, PGMTileROMExp);
-							}
-						} else {
-							if (flipx) {
-								Render32x32Tile_Mask_FlipX_Clip(pTransDraw, code, sx, sy, color, 5, 0x1f, 0, PGMTileROMExp);
-							} else {
-								Render32x32Tile_Mask_Clip(pTransDraw, code, sx, sy, color, 5, 0x1f, 0, PGMTileROMExp);
-							}
-						}
-					}
-				}
-				else
-				{
-					if (tiletrans[code] & 2) { // opaque
-						if (flipy) {
-							if (flipx) {
-								Render32x32Tile_FlipXY(pTransDraw, code, sx, sy, color, 5, 0, PGMTileROMExp);
-							} else {
-								Render32x32Tile_FlipY(pTransDraw, code, sx, sy, color, 5, 0, PGMTileROMExp);
-							}
-						} else {
-							if (flipx) {
-								Render32x32Tile_FlipX(pTransDraw, code, sx, sy, color, 5, 0, PGMTileROMExp);
-							} else {
-								Render32x32Tile(pTransDraw, code, sx, sy, color, 5, 0, PGMTileROMExp);
-							}
-						}
-					} else {
-						if (flipy) {
-							if (flipx) {
-								Render32x32Tile_Mask_FlipXY(pTransDraw, code, sx, sy, color, 5, 0x1f, 0, PGMTileROMExp);
-							} else {
-								Render32x32Tile_Mask_FlipY(pTransDraw, code, sx, sy, color, 5, 0x1f, 0, PGMTileROMExp);
-							}
-						} else {
-							if (flipx) {
-								Render32x32Tile_Mask_FlipX(pTransDraw, code, sx, sy, color, 5, 0x1f, 0, PGMTileROMExp);
-							} else {
-								Render32x32Tile_Mask(pTransDraw, code, sx, sy, color, 5, 0x1f, 0, PGMTileROMExp);
-							}
-						}
-					}
-				}
-			}
+			draw_tile(PGMTileROMExp + (code * 0x400), 32, sx, sy, color, 5, 0x1f, flipx, flipy);
 		}
 
 		return;
 	}
 
 	// do line scroll (slow)
-	for (INT32 y = 0; y < 224; y++)
+	for (INT32 y = nClipMinY; y < nClipMaxY; y++)
 	{
 		INT32 scrollx = (xscroll + BURN_ENDIAN_SWAP_INT16(rowscroll[y])) & 0x7ff;
 		INT32 scrolly = (yscroll + y) & 0x7ff;
@@ -1018,28 +912,16 @@ static void pgmBlendCopy()
 	}
 }
 
-INT32 pgmDraw()
+static void pgm_draw_band(INT32 nBand, INT32 nStart, INT32 nEnd)
 {
-	if (enable_blending) nPgmPalRecalc = 1; // force recalc.
-
-	if (nPgmPalRecalc) {
-		for (INT32 i = 0; i < 0x1200 / 2; i++) {
-			RamCurPal[i] = CalcCol(BURN_ENDIAN_SWAP_INT16(PGMPalRAM[i]));
-		}
-		nPgmPalRecalc = 0;
-	}
-
-	{
-		// black / magenta
-		RamCurPal[0x1200/2] = (nBurnLayer & 1) ? RamCurPal[0x3ff] : BurnHighCol(0xff, 0, 0xff, 0);
-		RamCurPal[0x1202/2] = BurnHighCol(0xff,0x00,0xff,0);
-	}
+	nClipMinY = nStart;
+	nClipMaxY = nEnd;
+	pTempDraw = pTempDrawBand[nBand];
 
 	// Fill in background color (0x1200/2)
 	// also, clear buffers
 	{
-
-		for (INT32 i = 0; i < nScreenWidth * nScreenHeight; i++) {
+		for (INT32 i = nClipMinY * nScreenWidth; i < nClipMaxY * nScreenWidth; i++) {
 			pTempDraw32[i] = RamCurPal[0x900];
 			pTransDraw[i] = 0x900;
 			pTempScreen[i] = 0;
@@ -1058,6 +940,33 @@ INT32 pgmDraw()
 	pgm_drawsprites_fonts(0);
 #endif
 	if (nBurnLayer & 2) draw_text();
+}
+
+INT32 pgmDraw()
+{
+	if (enable_blending) nPgmPalRecalc = 1; // force recalc.
+
+	if (nPgmPalRecalc) {
+		for (INT32 i = 0; i < 0x1200 / 2; i++) {
+			RamCurPal[i] = CalcCol(BURN_ENDIAN_SWAP_INT16(PGMPalRAM[i]));
+		}
+		nPgmPalRecalc = 0;
+	}
+
+	{
+		// black / magenta
+		RamCurPal[0x1200/2] = (nBurnLayer & 1) ? RamCurPal[0x3ff] : BurnHighCol(0xff, 0, 0xff, 0);
+		RamCurPal[0x1202/2] = BurnHighCol(0xff,0x00,0xff,0);
+	}
+
+	// each band needs its own buffer to pre-zoom sprites into
+	for (INT32 i = 1; i < BurnBandCount(0, nScreenHeight); i++) {
+		if (pTempDrawBand[i] == NULL) {
+			pTempDrawBand[i] = (UINT16*)BurnMalloc(0x400 * 0x200 * sizeof(INT16));
+		}
+	}
+
+	BurnBandRun(pgm_draw_band, 0, nScreenHeight);
 
 	if (enable_blending) {
 		pgmBlendCopy();
@@ -1140,7 +1049,7 @@ void pgmInitDraw() // preprocess some things...
 	GenericTilesInit();
 
 	pTempDraw32 = (UINT32*)BurnMalloc(0x448 * 0x224 * 4);
-	pTempDraw = (UINT16*)BurnMalloc(0x400 * 0x200 * sizeof(INT16));
+	pTempDrawBand[0] = (UINT16*)BurnMalloc(0x400 * 0x200 * sizeof(INT16));
 	SpritePrio = (UINT8*)BurnMalloc(nScreenWidth * nScreenHeight);
 	pTempScreen = (UINT16*)BurnMalloc(nScreenWidth * nScreenHeight * sizeof(INT16));
 
@@ -1204,7 +1113,9 @@ void pgmExitDraw()
 	nTileMask = 0;
 
 	BurnFree (pTempDraw32);
-	BurnFree (pTempDraw);
+	for (INT32 i = 0; i < BURN_BAND_MAX_THREADS; i++) {
+		BurnFree (pTempDrawBand[i]);
+	}
 	BurnFree (tiletrans);
 	BurnFree (texttrans);
 	BurnFree (pTempScreen);
@@ -101,14 +101,26 @@
 extern UINT16 snes_cgram[SNES_CGRAM_SIZE];
 extern UINT32 snesPal[0x20000];
 /*SPC700*/
-extern double spccycles;
+/* The SPC700 only talks to the 65816 through the four APU ports, so with the
+   event driven scheduler it is left to run behind and only caught up when a
+   port is touched (readfromspc/writetospc) or the frame ends. spccycles is
+   how far it is behind in master clocks <<SPC_CLOCK_SHIFT, kept in integers so
+   that catching up in one go lands exactly where running in step would. */
+#define SPC_CLOCK_SHIFT	19
+extern INT64 spccycles;
 extern double spctotal2;
 extern double spctotal3;
+extern INT32 spcswitches;
 void execspc();
 
 static inline void clockspc(int cyc)
 {
-	spccycles+=cyc;
+	spccycles+=(INT64)cyc<<SPC_CLOCK_SHIFT;
+	if (!nSnesSpcCatchUp && spccycles>0) execspc();
+}
+
+static inline void syncspc()
+{
 	if (spccycles>0) execspc();
 }
 
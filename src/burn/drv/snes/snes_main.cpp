@@ -8,6 +8,12 @@ INT32 oldnmi=0;
 INT32 spcclck;
 double spcclck2,spcclck3;
 
+INT32 nSnesSpcCatchUp = 1;
+
+static UINT32 nStatFrames = 0;
+static UINT64 nStatSwitches = 0;
+static UINT64 nStatTicks = 0;
+
 extern int pal;
 UINT16 srammask=0;
 
@@ -335,7 +341,11 @@ INT32 SnesInit()
 
 	SnesReset();
 
-	spccycles=-10000;
+	spccycles=-((INT64)10000<<SPC_CLOCK_SHIFT);
+
+	nStatFrames=0;
+	nStatSwitches=0;
+	nStatTicks=0;
 
 
 	BurnLoadRom(SNES_rom,0,0);
@@ -390,6 +400,11 @@ INT32 SnesInit()
 
 INT32 SnesExit()
 {
+	if (nStatFrames)
+	{
+		bprintf(PRINT_NORMAL, _T("    SPC700 (%s): %d frames, %d.%02d switches per frame, %d us per frame.\n"), nSnesSpcCatchUp ? _T("catch-up") : _T("lockstep"), nStatFrames, (INT32)(nStatSwitches / nStatFrames), (INT32)(nStatSwitches * 100 / nStatFrames % 100), (INT32)(nStatTicks / nStatFrames));
+	}
+
 	for (int i=0;i<2048;i++)
 	{
 		memlookup[i]=NULL;
@@ -400,11 +415,15 @@ INT32 SnesExit()
 
 INT32 SnesFrame()
 {
+	UINT64 nTicks = BurnGetTicks();
+
 	if (DoSnesReset)
 	{
 		SnesReset();
 	}
 
+	spcswitches=0;
+
 	nmi=vbl=0;
 	framenum++;
 	if (framenum==50)
@@ -467,8 +486,16 @@ INT32 SnesFrame()
 		}
 
 	}
+
+	// bring the spc700 up to the end of the frame
+	syncspc();
+
 	frames++;
 
+	nStatFrames++;
+	nStatSwitches += spcswitches;
+	nStatTicks += BurnGetTicks() - nTicks;
+
 	return 0;
 }
 
@@ -212,6 +212,78 @@ enum
 	SNES_COLOR_DEPTH_8BPP
 };
 
+/*****************************************
+* Tile row cache
+*
+* 8 pixel tile rows decoded from bitplanes
+* to one byte per pixel, for each VRAM
+* address and colour depth. VRAM writes
+* drop the rows they land in.
+*****************************************/
+
+static UINT8  tile_row_cache[3][0x10000][8];
+static UINT8  tile_row_valid[3][0x10000];
+static UINT64 tile_row_lut[256];	/* one bitplane byte -> a bit in each of 8 pixel bytes */
+
+static void snes_tile_row_init( void )
+{
+	for (INT32 i = 0; i < 256; i++)
+	{
+		UINT8 *pixels = (UINT8 *)&tile_row_lut[i];
+
+		for (INT32 x = 0; x < 8; x++)
+			pixels[x] = (i >> (7 - x)) & 1;
+	}
+
+	memset(tile_row_valid, 0, sizeof(tile_row_valid));
+}
+
+/* planes is 2, 4 or 8 */
+SNES_INLINE const UINT8 *snes_get_tile_row( UINT8 planes, UINT16 tileaddr )
+{
+	INT32 depth = planes >> 2;
+	UINT8 *row = tile_row_cache[depth][tileaddr];
+
+	if (!tile_row_valid[depth][tileaddr])
+	{
+		UINT64 pixels = 0;
+
+		for (INT32 ii = 0; ii < planes / 2; ii++)
+		{
+			pixels |= tile_row_lut[snes_vram[tileaddr + 16 * ii]] << (2 * ii);
+			pixels |= tile_row_lut[snes_vram[tileaddr + 16 * ii + 1]] << (2 * ii + 1);
+		}
+
+		memcpy(row, &pixels, 8);
+		tile_row_valid[depth][tileaddr] = 1;
+	}
+
+	return row;
+}
+
+SNES_INLINE void snes_vram_write( UINT32 offset, UINT8 data )
+{
+	snes_vram[offset] = data;
+
+	/* a 2bpp row reads offset and offset + 1, 4bpp adds + 16 and 8bpp adds + 32 and + 48 */
+	for (UINT32 plane = 0; plane < 64; plane += 16)
+	{
+		for (UINT32 byte = 0; byte < 2; byte++)
+		{
+			UINT32 row = offset - plane - byte;
+
+			if (row <= 0xffff)
+			{
+				if (plane == 0)
+					tile_row_valid[SNES_COLOR_DEPTH_2BPP][row] = 0;
+				if (plane < 32)
+					tile_row_valid[SNES_COLOR_DEPTH_4BPP][row] = 0;
+				tile_row_valid[SNES_COLOR_DEPTH_8BPP][row] = 0;
+			}
+		}
+	}
+}
+
 
 
 /*****************************************
@@ -341,39 +413,13 @@ SNES_INLINE void snes_draw_blend( UINT16 offset, UINT16 *colour, UINT8 prevent_c
 
 SNES_INLINE void snes_draw_tile( UINT8 planes, UINT8 layer, UINT16 tileaddr, INT16 xpos, UINT8 priority, UINT8 flip, UINT8 direct_colors, UINT16 palNo, UINT8 hires )
 {
-	UINT8 mask, plane[8];
+	const UINT8 *pixels = snes_get_tile_row(planes, tileaddr);
 	UINT16 c;
 	INT16 ii, jj;
 
-	for (ii = 0; ii < planes / 2; ii++)
+	for (ii = xpos, jj = 0; ii < (xpos + 8); ii++, jj++)
 	{
-		plane[2 * ii] = snes_vram[tileaddr + 16 * ii];
-		plane[2 * ii + 1] = snes_vram[tileaddr + 16 * ii + 1];
-	}
-
-	if (flip)
-		mask = 0x1;
-	else
-		mask = 0x80;
-
-	for (ii = xpos; ii < (xpos + 8); ii++)
-	{
-		UINT8 colour = 0;
-		if (flip)
-		{
-			for (jj = 0; jj < planes; jj++)
-				colour |= plane[jj] & mask ? (1 << jj) : 0;
-
-			mask <<= 1;
-		}
-		else
-		{
-			for (jj = 0; jj < planes; jj++)
-				colour |= plane[jj] & mask ? (1 << jj) : 0;
-
-			mask >>= 1;
-		}
-
+		UINT8 colour = pixels[flip ? (7 - jj) : jj];
 
 		if (!hires)
 		{
@@ -606,37 +652,13 @@ SNES_INLINE void snes_draw_tile_x2( UINT8 planes, UINT8 layer, UINT16 tileaddr,
 
 SNES_INLINE void snes_draw_tile_object( UINT16 tileaddr, INT16 xpos, UINT8 priority, UINT8 flip, UINT16 palNo, UINT8 blend )
 {
-	UINT8 mask, plane[4];
+	const UINT8 *pixels = snes_get_tile_row(4, tileaddr);
 	UINT16 c;
 	INT16 ii, jj;
 
-	plane[0] = snes_vram[tileaddr];
-	plane[1] = snes_vram[tileaddr + 1];
-	plane[2] = snes_vram[tileaddr + 16];
-	plane[3] = snes_vram[tileaddr + 17];
-
-	if (flip)
-		mask = 0x01;
-	else
-		mask = 0x80;
-
-	for (ii = xpos; ii < (xpos + 8); ii++)
+	for (ii = xpos, jj = 0; ii < (xpos + 8); ii++, jj++)
 	{
-		UINT8 colour = 0;
-		if (flip)
-		{
-			for (jj = 0; jj < 4; jj++)
-				colour |= plane[jj] & mask ? (1 << jj) : 0;
-
-			mask <<= 1;
-		}
-		else
-		{
-			for (jj = 0; jj < 4; jj++)
-				colour |= plane[jj] & mask ? (1 << jj) : 0;
-
-			mask >>= 1;
-		}
+		UINT8 colour = pixels[flip ? (7 - jj) : jj];
 
 		if (ii >= 0 && ii < SNES_SCR_WIDTH && scanlines[SNES_MAINSCREEN].enable)
 		{
@@ -1756,6 +1778,7 @@ void resetppu()
 	memset(snes_cgram,0x0000,SNES_CGRAM_SIZE*2);
 	memset(snes_oam,0xff,SNES_OAM_SIZE*2);
 	memset(snes_vram,0x55,SNES_VRAM_SIZE);
+	snes_tile_row_init();
 	memset(snes_ram,0x55,0x4000*2);
 
 	snes_ppu.update_windows = 1;
@@ -2220,11 +2243,11 @@ void writeppu(unsigned short offset, unsigned char data)
 					UINT32 rem = addr & vram_fgr_mask;
 					UINT32 faddr = (addr & ~vram_fgr_mask) + (rem >> vram_fgr_shift) + ((rem & (vram_fgr_count - 1)) << 3);
 
-					snes_vram[(faddr << 1) & 0x1ffff] = data;
+					snes_vram_write((faddr << 1) & 0x1ffff, data);
 				}
 				else
 				{
-					snes_vram[(addr << 1) & 0x1ffff] = data;
+					snes_vram_write((addr << 1) & 0x1ffff, data);
 				}
 
 				if (!vram_fgr_high)
@@ -2244,11 +2267,11 @@ void writeppu(unsigned short offset, unsigned char data)
 					UINT32 rem = addr & vram_fgr_mask;
 					UINT32 faddr = (addr & ~vram_fgr_mask) + (rem >> vram_fgr_shift) + ((rem & (vram_fgr_count - 1)) << 3);
 
-					snes_vram[((faddr << 1) + 1) & 0x1ffff] = data;
+					snes_vram_write(((faddr << 1) + 1) & 0x1ffff, data);
 				}
 				else
 				{
-					snes_vram[((addr << 1) + 1) & 0x1ffff] = data;
+					snes_vram_write(((addr << 1) + 1) & 0x1ffff, data);
 				}
 
 				if (vram_fgr_high)
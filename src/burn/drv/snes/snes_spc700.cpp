@@ -5,9 +5,10 @@ int spcoutput;
 
 int spctotal,dsptotal;
 
-double spccycles;
+INT64 spccycles;
 double spctotal2;
 double spctotal3;
+INT32 spcswitches;
 
 struct SPC_Struct
 {
@@ -50,11 +51,13 @@ int spctimer[3],spctimer2[3],spclimit[3];
 
 unsigned char readfromspc(unsigned short addr)
 {
+	syncspc();
 	return spctocpu[addr&3];
 }
 
 void writetospc(unsigned short addr, unsigned char val)
 {
+	syncspc();
 	spcram[(addr&3)+0xF4]=val;
 }
 
@@ -156,6 +159,7 @@ void execspc()
 	unsigned long templ;
 	int spccount;
 	//        snemlog("ExecSPC %i\n",spccycles);
+	spcswitches++;
 	while (spccycles>0)
 	{
 		spc3=spc2;
@@ -1863,8 +1867,9 @@ void execspc()
 			//snemlog(L"Bad SPC opcode %02X at %04X\n",opcode,spc.pc);
 
 		}
-		if (global_pal) spccycles-=(spccount*20.7796875f);//20.36383f);
-		else     spccycles-=(spccount*20.9395313f);
+		// the float product is a multiple of 2^-19, so this is exact
+		if (global_pal) spccycles-=(INT64)((spccount*20.7796875f)*(float)(1<<SPC_CLOCK_SHIFT));//20.36383f);
+		else     spccycles-=(INT64)((spccount*20.9395313f)*(float)(1<<SPC_CLOCK_SHIFT));
 		//                spctotal2+=(spccount*20.78f);//20.36383f);
 		//                spctotal3+=spccount;
 		spctimer[0]-=spccount;
@@ -16,7 +16,11 @@ static INT32 TC0480SCPXOffset;
 static INT32 TC0480SCPYOffset;
 static INT32 TC0480SCPTextXOffset;
 static INT32 TC0480SCPTextYOffset;
-static UINT16 *pTC0480SCPTempDraw = NULL;
+static UINT16 *pTC0480SCPLayerDraw = NULL;		// each bg layer's whole tilemap, 1024x512
+static UINT32 TC0480SCPLayerRam[4][0x800];		// the tile words each cached tilemap was drawn from
+static UINT8 *TC0480SCPLayerGfx[4];
+static INT32 TC0480SCPLayerDblWidth[4];
+static INT32 TC0480SCPLayerDirty[4];
 static INT32 TC0480SCPColBase;
 static INT32 TC0480SCPDblWidth;
 
@@ -36,8 +40,6 @@ static const UINT16 TC0480SCPBgPriLookup[8] =
 
 #define PLOTPIXEL(x, po) pPixel[x] = nPalette | pTileData[x] | po;
 #define PLOTPIXEL_FLIPX(x, a, po) pPixel[x] = nPalette | pTileData[a] | po;
-#define PLOTPIXEL_MASK(x, mc, po) if (pTileData[x] != mc) {pPixel[x] = nPalette | pTileData[x] | po;}
-#define PLOTPIXEL_MASK_FLIPX(x, a, mc, po) if (pTileData[a] != mc) {pPixel[x] = nPalette | pTileData[a] | po;}
 #define CLIPPIXEL(x, sx, mx, a) if ((sx + x) >= 0 && (sx + x) < mx) { a; };
 
 static void RenderTile(UINT16* pDestDraw, INT32 nTileNumber, INT32 StartX, INT32 StartY, INT32 nTilePalette, INT32 nColourDepth, INT32 nPaletteOffset, UINT8 *pTile)
@@ -160,131 +162,58 @@ static void RenderTile_FlipXY(UINT16* pDestDraw, INT32 nTileNumber, INT32 StartX
 	}
 }
 
-static void RenderTile_Mask(UINT16* pDestDraw, INT32 nTileNumber, INT32 StartX, INT32 StartY, INT32 nTilePalette, INT32 nColourDepth, INT32 nMaskColour, INT32 nPaletteOffset, UINT8 *pTile)
-{
-	UINT32 nPalette = nTilePalette << nColourDepth;
-	pTileData = pTile + (nTileNumber << 8);
-	
-	INT32 TileMapWidth = 512;
-	if (TC0480SCPDblWidth) TileMapWidth = 1024;
-	
-	UINT16* pPixel = pDestDraw + (StartY * TileMapWidth) + StartX;
-
-	for (INT32 y = 0; y < 16; y++, pPixel += TileMapWidth, pTileData += 16) {
-		PLOTPIXEL_MASK( 0, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 1, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 2, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 3, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 4, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 5, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 6, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 7, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 8, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 9, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK(10, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK(11, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK(12, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK(13, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK(14, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK(15, nMaskColour, nPaletteOffset);
-	}
-}
+#undef PLOTPIXEL
+#undef PLOTPIXEL_FLIPX
+#undef CLIPPIXEL
 
-static void RenderTile_Mask_FlipX(UINT16* pDestDraw, INT32 nTileNumber, INT32 StartX, INT32 StartY, INT32 nTilePalette, INT32 nColourDepth, INT32 nMaskColour, INT32 nPaletteOffset, UINT8 *pTile)
+// Bring a bg layer's cached tilemap up to date, only tiles whose words changed are redrawn.
+// Tiles are drawn opaque, transparent layers skip pen 0 when the tilemap is resampled.
+static UINT16 *TC0480SCPUpdateLayer(INT32 Layer, UINT16 *VideoRam, INT32 Columns, UINT8 *pSrc)
 {
-	UINT32 nPalette = nTilePalette << nColourDepth;
-	pTileData = pTile + (nTileNumber << 8);
-	
-	INT32 TileMapWidth = 512;
-	if (TC0480SCPDblWidth) TileMapWidth = 1024;
+	UINT16 *pDraw = pTC0480SCPLayerDraw + Layer * 1024 * 512;
+	UINT32 *pRam = (UINT32*)VideoRam;
+	UINT32 *pDrawn = TC0480SCPLayerRam[Layer];
+
+	if (TC0480SCPLayerGfx[Layer] != pSrc || TC0480SCPLayerDblWidth[Layer] != TC0480SCPDblWidth) {
+		TC0480SCPLayerGfx[Layer] = pSrc;
+		TC0480SCPLayerDblWidth[Layer] = TC0480SCPDblWidth;
+		TC0480SCPLayerDirty[Layer] = 1;
+	}
 
-	UINT16* pPixel = pDestDraw + (StartY * TileMapWidth) + StartX;
+	for (INT32 TileIndex = 0; TileIndex < Columns * 32; TileIndex++) {
+		if (pRam[TileIndex] == pDrawn[TileIndex] && !TC0480SCPLayerDirty[Layer]) continue;
 
-	for (INT32 y = 0; y < 16; y++, pPixel += TileMapWidth, pTileData += 16) {
-		PLOTPIXEL_MASK_FLIPX(15,  0, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX(14,  1, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX(13,  2, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX(12,  3, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX(11,  4, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX(10,  5, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 9,  6, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 8,  7, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 7,  8, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 6,  9, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 5, 10, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 4, 11, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 3, 12, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 2, 13, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 1, 14, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 0, 15, nMaskColour, nPaletteOffset);
-	}
-}
+		pDrawn[TileIndex] = pRam[TileIndex];
 
-static void RenderTile_Mask_FlipY(UINT16* pDestDraw, INT32 nTileNumber, INT32 StartX, INT32 StartY, INT32 nTilePalette, INT32 nColourDepth, INT32 nMaskColour, INT32 nPaletteOffset, UINT8 *pTile)
-{
-	UINT32 nPalette = nTilePalette << nColourDepth;
-	pTileData = pTile + (nTileNumber << 8);
-	
-	INT32 TileMapWidth = 512;
-	if (TC0480SCPDblWidth) TileMapWidth = 1024;
+		INT32 Attr = BURN_ENDIAN_SWAP_INT16(VideoRam[2 * TileIndex]);
+		INT32 Code = BURN_ENDIAN_SWAP_INT16(VideoRam[2 * TileIndex + 1]) & (TC0480SCPTilesNum - 1);
+		INT32 Colour = (Attr & 0xff) + TC0480SCPColBase;
+		INT32 xFlip = (Attr >> 14) & 0x01;
+		INT32 yFlip = (Attr >> 15) & 0x01;
 
-	UINT16* pPixel = pDestDraw + ((StartY + 15) * TileMapWidth) + StartX;
+		INT32 x = 16 * (TileIndex % Columns);
+		INT32 y = 16 * (TileIndex / Columns);
 
-	for (INT32 y = 15; y >= 0; y--, pPixel -= TileMapWidth, pTileData += 16) {
-		PLOTPIXEL_MASK( 0, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 1, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 2, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 3, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 4, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 5, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 6, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 7, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 8, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK( 9, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK(10, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK(11, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK(12, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK(13, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK(14, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK(15, nMaskColour, nPaletteOffset);
+		if (xFlip) {
+			if (yFlip) {
+				RenderTile_FlipXY(pDraw, Code, x, y, Colour, 4, 0, pSrc);
+			} else {
+				RenderTile_FlipX(pDraw, Code, x, y, Colour, 4, 0, pSrc);
+			}
+		} else {
+			if (yFlip) {
+				RenderTile_FlipY(pDraw, Code, x, y, Colour, 4, 0, pSrc);
+			} else {
+				RenderTile(pDraw, Code, x, y, Colour, 4, 0, pSrc);
+			}
+		}
 	}
-}
 
-static void RenderTile_Mask_FlipXY(UINT16* pDestDraw, INT32 nTileNumber, INT32 StartX, INT32 StartY, INT32 nTilePalette, INT32 nColourDepth, INT32 nMaskColour, INT32 nPaletteOffset, UINT8 *pTile)
-{
-	UINT32 nPalette = nTilePalette << nColourDepth;
-	pTileData = pTile + (nTileNumber << 8);
-	
-	INT32 TileMapWidth = 512;
-	if (TC0480SCPDblWidth) TileMapWidth = 1024;
-
-	UINT16* pPixel = pDestDraw + ((StartY + 15) * TileMapWidth) + StartX;
+	TC0480SCPLayerDirty[Layer] = 0;
 
-	for (INT32 y = 15; y >= 0; y--, pPixel -= TileMapWidth, pTileData += 16) {
-		PLOTPIXEL_MASK_FLIPX(15,  0, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX(14,  1, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX(13,  2, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX(12,  3, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX(11,  4, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX(10,  5, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 9,  6, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 8,  7, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 7,  8, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 6,  9, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 5, 10, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 4, 11, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 3, 12, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 2, 13, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 1, 14, nMaskColour, nPaletteOffset);
-		PLOTPIXEL_MASK_FLIPX( 0, 15, nMaskColour, nPaletteOffset);
-	}
+	return pDraw;
 }
 
-#undef PLOTPIXEL
-#undef PLOTPIXEL_FLIPX
-#undef PLOTPIXEL_MASK
-#undef CLIPPIXEL
-
 void TC0480SCPCtrlWordWrite(INT32 Offset, UINT16 Data)
 {
 	INT32 Flip = TC0480SCPPriReg & 0x40;
@@ -373,37 +302,12 @@ void TC0480SCPCtrlWordWrite(INT32 Offset, UINT16 Data)
 	}
 }
 
-static inline void DrawScanLine(INT32 y, const UINT16 *src, INT32 Transparent, INT32 /*Pri*/)
-{
-	UINT16* pPixel;
-	INT32 Length;
-	
-	pPixel = pTransDraw + (y * nScreenWidth);
-	
-	Length = nScreenWidth;
-	
-	if (Transparent) {
-		while (Length--) {
-			UINT16 sPixel = *src++;
-			if (sPixel < 0x7fff) {
-				*pPixel = sPixel;
-			}
-			pPixel++;
-		}
-	} else {
-		while (Length--) {
-			*pPixel++ = *src++;
-		}
-	}
-}
-
 static void TC0480SCPRenderLayer01(INT32 Layer, INT32 Opaque, UINT8 *pSrc)
 {
-	INT32 mx, my, Attr, Code, Colour, x, y, sx, TileIndex = 0, Offset, Flip, xFlip, yFlip, xZoom, yZoom, i, yIndex, ySrcIndex, RowIndex, xIndex, xStep, Columns, WidthMask;
+	INT32 y, sx, xZoom, yZoom, i, yIndex, ySrcIndex, RowIndex, xIndex, xStep, Columns, WidthMask;
 	
 	UINT16 *Dst16, *Src16;
-	UINT16 ScanLine[512];
-	UINT16 *pSrcTileMap = pTC0480SCPTempDraw;
+	UINT16 *pSrcTileMap;
 	
 	UINT16 *VideoRam = (UINT16*)TC0480SCPRam + 0x0000;
 	UINT16 *ScrollRam = (UINT16*)TC0480SCPRam + 0x2000;
@@ -433,57 +337,8 @@ static void TC0480SCPRenderLayer01(INT32 Layer, INT32 Opaque, UINT8 *pSrc)
 	xZoom = 0x10000 - (TC0480SCPCtrl[0x08 + Layer] & 0xff00);
 	yZoom = 0x10000 - (((TC0480SCPCtrl[0x08 + Layer] & 0xff) - 0x7f) * 512);
 	
-	// Render the tilemap to a buffer
-	memset(pTC0480SCPTempDraw, 0, 1024 * 512 * sizeof(UINT16));
-	for (my = 0; my < 32; my++) {
-		for (mx = 0; mx < Columns; mx++) {
-			Offset = 2 * TileIndex;
-			Attr = BURN_ENDIAN_SWAP_INT16(VideoRam[Offset]);
-			Code = BURN_ENDIAN_SWAP_INT16(VideoRam[Offset + 1]) & (TC0480SCPTilesNum - 1);
-			Colour = Attr & 0xff;
-			Flip = (Attr & 0xc000) >> 14;
-			xFlip = (Flip >> 0) & 0x01;
-			yFlip = (Flip >> 1) & 0x01;
-			
-			Colour += TC0480SCPColBase;
-		
-			x = 16 * mx;
-			y = 16 * my;
-			
-			if (Opaque) {
-				if (xFlip) {
-					if (yFlip) {
-						RenderTile_FlipXY(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, pSrc);
-					} else {
-						RenderTile_FlipX(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, pSrc);
-					}
-				} else {
-					if (yFlip) {
-						RenderTile_FlipY(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, pSrc);
-					} else {
-						RenderTile(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, pSrc);
-					}
-				}
-			} else {
-				if (xFlip) {
-					if (yFlip) {
-						RenderTile_Mask_FlipXY(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, 0, pSrc);
-					} else {
-						RenderTile_Mask_FlipX(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, 0, pSrc);
-					}
-				} else {
-					if (yFlip) {
-						RenderTile_Mask_FlipY(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, 0, pSrc);
-					} else {
-						RenderTile_Mask(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, 0, pSrc);
-					}
-				}				
-			}
-			
-			TileIndex++;
-		}
-	}
-	
+	pSrcTileMap = TC0480SCPUpdateLayer(Layer, VideoRam, Columns, pSrc);
+
 	sx = ((BgScrollX[Layer] + 15 + Layer * 4) << 16) + ((255 - (TC0480SCPCtrl[0x10 + Layer] & 0xff)) << 8);
 	sx += (-TC0480SCPXOffset - 15 - Layer * 4) * xZoom;
 
@@ -500,33 +355,25 @@ static void TC0480SCPRenderLayer01(INT32 Layer, INT32 Opaque, UINT8 *pSrc)
 		xIndex = sx - ((BURN_ENDIAN_SWAP_INT16(ScrollRam[RowIndex]) << 16)) - ((BURN_ENDIAN_SWAP_INT16(ScrollRam[RowIndex + 0x800]) << 8) & 0xffff);
 
 		Src16 = pSrcTileMap + (ySrcIndex * Columns * 16);
-		Dst16 = ScanLine;
+		Dst16 = pTransDraw + (y * nScreenWidth);
 
 		xStep = xZoom;
 
 		if (Opaque) {
-			for (i = 0; i < 512; i++) {
+			for (i = 0; i < nScreenWidth; i++) {
 				*Dst16++ = Src16[(xIndex >> 16) & WidthMask];
 				xIndex += xStep;
 			}
 		} else {
-			for (i = 0; i < 512; i++) {
+			for (i = 0; i < nScreenWidth; i++, Dst16++) {
 				INT32 Pix = Src16[(xIndex >> 16) & WidthMask];
 				
 				if ((Pix & 0x0f) != 0) {
-					*Dst16++ = Pix;
-				} else {
-					*Dst16++ = 0x8000;
+					*Dst16 = Pix;
 				}
 				xIndex += xStep;
 			}
 		}
-
-		if (Opaque) {
-			DrawScanLine(y, ScanLine, 0, 0);
-		} else {
-			DrawScanLine(y, ScanLine, 1, 0);
-		}
 		
 		yIndex += yZoom;
 		y++;
@@ -535,11 +382,10 @@ static void TC0480SCPRenderLayer01(INT32 Layer, INT32 Opaque, UINT8 *pSrc)
 
 static void TC0480SCPRenderLayer23(INT32 Layer, INT32 Opaque, UINT8 *pSrc)
 {
-	INT32 mx, my, Attr, Code, Colour, x, y, sx, TileIndex = 0, Offset, Flip, xFlip, yFlip, xZoom, yZoom, i, yIndex, ySrcIndex, RowIndex, RowZoom, xIndex, xStep, Columns, WidthMask;
+	INT32 y, sx, xZoom, yZoom, i, yIndex, ySrcIndex, RowIndex, RowZoom, xIndex, xStep, Columns, WidthMask;
 	
 	UINT16 *Dst16, *Src16;
-	UINT16 ScanLine[512];
-	UINT16 *pSrcTileMap = pTC0480SCPTempDraw;
+	UINT16 *pSrcTileMap;
 	
 	xZoom = 0x10000 - (TC0480SCPCtrl[0x08 + Layer] & 0xff00);
 	yZoom = 0x10000 - (((TC0480SCPCtrl[0x08 + Layer] & 0xff) - 0x7f) * 512);
@@ -577,56 +423,7 @@ static void TC0480SCPRenderLayer23(INT32 Layer, INT32 Opaque, UINT8 *pSrc)
 		WidthMask = 0x3ff;
 	}
 
-	// Render the tilemap to a buffer
-	memset(pTC0480SCPTempDraw, 0, 1024 * 512 * sizeof(UINT16));
-	for (my = 0; my < 32; my++) {
-		for (mx = 0; mx < Columns; mx++) {
-			Offset = 2 * TileIndex;
-			Attr = BURN_ENDIAN_SWAP_INT16(VideoRam[Offset]);
-			Code = BURN_ENDIAN_SWAP_INT16(VideoRam[Offset + 1]) & (TC0480SCPTilesNum - 1);
-			Colour = Attr & 0xff;
-			Flip = (Attr & 0xc000) >> 14;
-			xFlip = (Flip >> 0) & 0x01;
-			yFlip = (Flip >> 1) & 0x01;
-			
-			Colour += TC0480SCPColBase;
-	
-			x = 16 * mx;
-			y = 16 * my;
-		
-			if (Opaque) {
-				if (xFlip) {
-					if (yFlip) {
-						RenderTile_FlipXY(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, pSrc);
-					} else {
-						RenderTile_FlipX(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, pSrc);
-					}
-				} else {
-					if (yFlip) {
-						RenderTile_FlipY(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, pSrc);
-					} else {
-						RenderTile(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, pSrc);
-					}
-				}
-			} else {
-				if (xFlip) {
-					if (yFlip) {
-						RenderTile_Mask_FlipXY(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, 0, pSrc);
-					} else {
-						RenderTile_Mask_FlipX(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, 0, pSrc);
-					}
-				} else {
-					if (yFlip) {
-						RenderTile_Mask_FlipY(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, 0, pSrc);
-					} else {
-						RenderTile_Mask(pTC0480SCPTempDraw, Code, x, y, Colour, 4, 0, 0, pSrc);
-					}
-				}				
-			}
-			
-			TileIndex++;
-		}
-	}
+	pSrcTileMap = TC0480SCPUpdateLayer(Layer, VideoRam, Columns, pSrc);
 
 	sx = ((BgScrollX[Layer] + 15 + Layer * 4) << 16) + ((255 - (TC0480SCPCtrl[0x10 + Layer] & 0xff)) << 8);
 	sx += (-TC0480SCPXOffset - 15 - Layer * 4) * xZoom;
@@ -660,32 +457,24 @@ static void TC0480SCPRenderLayer23(INT32 Layer, INT32 Opaque, UINT8 *pSrc)
 		}
 		
 		Src16 = pSrcTileMap + (ySrcIndex * Columns * 16);
-		Dst16 = ScanLine;
+		Dst16 = pTransDraw + (y * nScreenWidth);
 
 		if (Opaque) {
-			for (i = 0; i < 512; i++) {
+			for (i = 0; i < nScreenWidth; i++) {
 				*Dst16++ = Src16[(xIndex >> 16) & WidthMask];
 				xIndex += xStep;
 			}
 		} else	{
-			for (i = 0; i < 512; i++) {
+			for (i = 0; i < nScreenWidth; i++, Dst16++) {
 				INT32 Pix = Src16[(xIndex >> 16) & WidthMask];
 					
 				if ((Pix & 0x0f) != 0) {
-					*Dst16++ = Pix;
-				} else {
-					*Dst16++ = 0x8000;
+					*Dst16 = Pix;
 				}
 				xIndex += xStep;
 			}
 		}
 
-		if (Opaque) {
-			DrawScanLine(y, ScanLine, 0, 0);
-		} else {
-			DrawScanLine(y, ScanLine, 1, 0);
-		}
-
 		yIndex += yZoom;
 		y++;
 	} while (y < nScreenHeight);
@@ -793,6 +582,7 @@ void TC0480SCPReset()
 	CharScrollY = 0;
 	TC0480SCPPriReg = 0;
 	TC0480SCPDblWidth = 0;
+	TC0480SCPLayerDirty[0] = TC0480SCPLayerDirty[1] = TC0480SCPLayerDirty[2] = TC0480SCPLayerDirty[3] = 1;
 }
 
 INT32 TC0480SCPGetBgPriority()
@@ -814,8 +604,9 @@ void TC0480SCPInit(INT32 nNumTiles, INT32 Pixels, INT32 xOffset, INT32 yOffset,
 	TC0480SCPTextXOffset = xTextOffset - TC0480SCPXOffset + 3;
 	TC0480SCPTextYOffset = yTextOffset + TC0480SCPYOffset;
 	
-	pTC0480SCPTempDraw = (UINT16*)BurnMalloc(1024 * 512 * sizeof(UINT16));
-	memset(pTC0480SCPTempDraw, 0, 1024 * 512 * sizeof(UINT16));
+	pTC0480SCPLayerDraw = (UINT16*)BurnMalloc(4 * 1024 * 512 * sizeof(UINT16));
+	memset(pTC0480SCPLayerDraw, 0, 4 * 1024 * 512 * sizeof(UINT16));
+	TC0480SCPLayerDirty[0] = TC0480SCPLayerDirty[1] = TC0480SCPLayerDirty[2] = TC0480SCPLayerDirty[3] = 1;
 	
 	TC0480SCPColBase = 0;
 	TC0480SCPYVisOffset = VisYOffset;
@@ -826,13 +617,14 @@ void TC0480SCPInit(INT32 nNumTiles, INT32 Pixels, INT32 xOffset, INT32 yOffset,
 void TC0480SCPSetColourBase(INT32 Base)
 {
 	TC0480SCPColBase = Base;
+	TC0480SCPLayerDirty[0] = TC0480SCPLayerDirty[1] = TC0480SCPLayerDirty[2] = TC0480SCPLayerDirty[3] = 1;
 }
 
 void TC0480SCPExit()
 {
 	BurnFree(TC0480SCPRam);
 	BurnFree(TC0480SCPChars);
-	BurnFree(pTC0480SCPTempDraw);
+	BurnFree(pTC0480SCPLayerDraw);
 	
 	memset(TC0480SCPCtrl, 0, 0x18);
 	BgScrollX[0] = BgScrollX[1] = BgScrollX[2] = BgScrollX[3] = 0;
@@ -871,4 +663,9 @@ void TC0480SCPScan(INT32 nAction)
 		SCAN_VAR(CharScrollY);
 		SCAN_VAR(TC0480SCPPriReg);
 	}
+
+	if (nAction & ACB_WRITE) {
+		TC0480SCPDblWidth = (TC0480SCPPriReg & 0x80) >> 7;
+		TC0480SCPLayerDirty[0] = TC0480SCPLayerDirty[1] = TC0480SCPLayerDirty[2] = TC0480SCPLayerDirty[3] = 1;
+	}
 }
@@ -1,5 +1,6 @@
 #include "toaplan.h"
 #include "nec_intf.h"
+#include "burn_sched.h"
 // Batsugun & Batsugun Special Version
 
 static UINT8 DrvButton[8] = {0, 0, 0, 0, 0, 0, 0, 0};
@@ -12,6 +13,7 @@ static UINT8 bDrawScreen;
 static bool bVBlank;
 
 static INT32 v25_reset = 0;
+static INT32 nSoundBufferPos = 0;
 
 // Rom information
 static struct BurnRomInfo batsugunRomDesc[] = {
@@ -284,6 +286,7 @@ static INT32 LoadRoms()
 UINT8 __fastcall batsugunReadByte(UINT32 sekAddress)
 {
 	if ((sekAddress & 0xff0000) == 0x210000) {
+		BurnSchedSync();
 		return ShareRAM[(sekAddress / 2) & 0x7fff];
 	}
 
@@ -307,6 +310,7 @@ UINT8 __fastcall batsugunReadByte(UINT32 sekAddress)
 UINT16 __fastcall batsugunReadWord(UINT32 sekAddress)
 {
 	if ((sekAddress & 0xff0000) == 0x210000) {
+		BurnSchedSync();
 		return ShareRAM[(sekAddress / 2) & 0x7fff];
 	}
 
@@ -343,6 +347,7 @@ UINT16 __fastcall batsugunReadWord(UINT32 sekAddress)
 void __fastcall batsugunWriteByte(UINT32 sekAddress, UINT8 byteValue)
 {
 	if ((sekAddress & 0xff0000) == 0x210000) {
+		BurnSchedSync();
 		ShareRAM[(sekAddress / 2) & 0x7fff] = byteValue;
 		return;
 	}
@@ -350,8 +355,14 @@ void __fastcall batsugunWriteByte(UINT32 sekAddress, UINT8 byteValue)
 	switch (sekAddress) {
 		case 0x20001c:
 		case 0x20001d:
-			if (!v25_reset && (~byteValue & 0x20)) VezReset();
+			BurnSchedSync();
+			if (!v25_reset && (~byteValue & 0x20)) {
+				VezOpen(0);
+				VezReset();
+				VezClose();
+			}
 			v25_reset = (~byteValue & 0x20);
+			BurnSchedSetHalt(1, v25_reset);
 			break;
 
 		default: {
@@ -363,6 +374,7 @@ void __fastcall batsugunWriteByte(UINT32 sekAddress, UINT8 byteValue)
 void __fastcall batsugunWriteWord(UINT32 sekAddress, UINT16 wordValue)
 {
 	if ((sekAddress & 0xff0000) == 0x210000) {
+		BurnSchedSync();
 		ShareRAM[(sekAddress / 2) & 0x7fff] = wordValue;
 		return;
 	}
@@ -407,19 +419,39 @@ void __fastcall batsugunWriteWord(UINT32 sekAddress, UINT16 wordValue)
 	}
 }
 
+// Render the sound up to where the V25 has got to
+static void DrvSyncSound()
+{
+	if (pBurnSoundOut == NULL) return;
+
+	INT32 nEnd = (INT32)((INT64)nBurnSoundLen * BurnSchedTotalCycles(1) / nCyclesTotal[1]);
+	if (nEnd > nBurnSoundLen) nEnd = nBurnSoundLen;
+
+	INT32 nSegmentLength = nEnd - nSoundBufferPos;
+	if (nSegmentLength > 0) {
+		INT16* pSoundBuf = pBurnSoundOut + (nSoundBufferPos << 1);
+		BurnYM2151Render(pSoundBuf, nSegmentLength);
+		MSM6295Render(0, pSoundBuf, nSegmentLength);
+		nSoundBufferPos += nSegmentLength;
+	}
+}
+
 void __fastcall batsugun_v25_write(UINT32 address, UINT8 data)
 {
 	switch (address)
 	{
 		case 0x00000:
+			DrvSyncSound();
 			BurnYM2151SelectRegister(data);
 		return;
 
 		case 0x00001:
+			DrvSyncSound();
 			BurnYM2151WriteRegister(data);
 		return;
 
 		case 0x00004:
+			DrvSyncSound();
 			MSM6295Command(0, data);
 		return;
 	}
@@ -471,6 +503,7 @@ static INT32 DrvDoReset()
 	MSM6295Reset(0);
 
 	v25_reset = 1;
+	BurnSchedSetHalt(1, v25_reset);
 
 	return 0;
 }
@@ -545,6 +578,11 @@ static INT32 DrvInit()
 
 	bDrawScreen = true;
 
+	BurnSchedInit(10);
+	BurnSchedAttachSek(0);
+	BurnSchedAttachVez(0);
+	BurnSchedSetSyncGap((16000000 / 60) / 262);					// the V25 doesn't need to be nearer than a line
+
 	DrvDoReset(); // Reset machine
 
 	return 0;
@@ -582,15 +620,20 @@ static INT32 DrvDraw()
 	return 0;
 }
 
-inline static INT32 CheckSleep(INT32)
+static void DrvVBlank(INT32)
 {
-	return 0;
+	bVBlank = true;
+
+	ToaBufferGP9001Sprites();
+
+#if 0
+	// The VBlank interrupt isn't actually used
+	SekSetIRQLine(4, CPU_IRQSTATUS_AUTO);
+#endif
 }
 
 static INT32 DrvFrame()
 {
-	INT32 nInterleave = 10;
-
 	if (DrvReset) {														// Reset machine
 		DrvDoReset();
 	}
@@ -610,83 +653,35 @@ static INT32 DrvFrame()
 	SekNewFrame();
 	VezNewFrame();
 
-	INT32 nSoundBufferPos = 0;
+	nSoundBufferPos = 0;
 	nCyclesTotal[0] = (INT32)((INT64)16000000 * nBurnCPUSpeedAdjust / (0x0100 * 60));
 	nCyclesTotal[1] = (INT32)((INT64)8000000 * nBurnCPUSpeedAdjust / (0x0100 * 60));
-	nCyclesDone[0] = 0;
-	nCyclesDone[1] = 0;
 
 	SekOpen(0);
-	
 	SekSetCyclesScanline(nCyclesTotal[0] / 262);
+	SekClose();
+
 	nToaCyclesDisplayStart = nCyclesTotal[0] - ((nCyclesTotal[0] * (TOA_VBLANK_LINES + 240)) / 262);
 	nToaCyclesVBlankStart = nCyclesTotal[0] - ((nCyclesTotal[0] * TOA_VBLANK_LINES) / 262);
 	bVBlank = false;
 
-	VezOpen(0);
-
-	for (INT32 i = 0; i < nInterleave; i++) {
-    	INT32 nCurrentCPU;
-		INT32 nNext;
+	// The 68000 leads, the V25 is caught up whenever the 68000 touches shared RAM
+	BurnSchedSetCycles(0, nCyclesTotal[0]);
+	BurnSchedSetCycles(1, nCyclesTotal[1]);
+	BurnSchedSetHalt(1, v25_reset);
+	BurnSchedAddEvent(nToaCyclesVBlankStart, DrvVBlank, 0);
 
-		// Run 68000
-		nCurrentCPU = 0;
-		nNext = (i + 1) * nCyclesTotal[nCurrentCPU] / nInterleave;
-
-
-		// Trigger VBlank interrupt
-		if (!bVBlank && nNext > nToaCyclesVBlankStart) {
-			if (nCyclesDone[nCurrentCPU] < nToaCyclesVBlankStart) {
-				nCyclesSegment = nToaCyclesVBlankStart - nCyclesDone[nCurrentCPU];
-				nCyclesDone[nCurrentCPU] += SekRun(nCyclesSegment);
-			}
-
-			bVBlank = true;
-
-			ToaBufferGP9001Sprites();
-
-#if 0
-			// The VBlank interrupt isn't actually used
-			SekSetIRQLine(4, CPU_IRQSTATUS_AUTO);
-#endif
-		}
-
-		nCyclesSegment = nNext - nCyclesDone[nCurrentCPU];
-		if (bVBlank || (!CheckSleep(nCurrentCPU))) {					// See if this CPU is busywaiting
-			nCyclesDone[nCurrentCPU] += SekRun(nCyclesSegment);
-		} else {
-			nCyclesDone[nCurrentCPU] += SekIdle(nCyclesSegment);
-		}
-
-		// sound! (increase interleave?)
-		if (v25_reset) {
-			nCyclesDone[1] += nCyclesTotal[1] / nInterleave;
-		} else {
-			nCyclesDone[1] += VezRun(nCyclesTotal[1] / nInterleave);
-		}
-		
-		if (pBurnSoundOut) {
-			INT32 nSegmentLength = nBurnSoundLen / nInterleave;
-			INT16* pSoundBuf = pBurnSoundOut + (nSoundBufferPos << 1);
-			BurnYM2151Render(pSoundBuf, nSegmentLength);
-			MSM6295Render(0, pSoundBuf, nSegmentLength);
-			nSoundBufferPos += nSegmentLength;
-		}
-	}
+	BurnSchedFrame();
 
 	if (pBurnSoundOut) {
 		INT32 nSegmentLength = nBurnSoundLen - nSoundBufferPos;
-		if (nSegmentLength) {
+		if (nSegmentLength > 0) {
 			INT16* pSoundBuf = pBurnSoundOut + (nSoundBufferPos << 1);
 			BurnYM2151Render(pSoundBuf, nSegmentLength);
 			MSM6295Render(0, pSoundBuf, nSegmentLength);
-
 		}
 	}
 
-	VezClose();
-	SekClose();
-
 	if (pBurnDraw) {
 		DrvDraw();												// Draw screen if needed
 	}
@@ -33,9 +33,24 @@ UINT16* GP9001Reg[2];
 UINT8* GP9001Pointer[2];
 INT32 GP9001Regnum[2];
 
-static UINT32* pTileQueue[32];
+// Each layer keeps its visible tiles queued by priority between frames. A queue is only
+// rebuilt when the layer scrolls onto a new tile row or column, or when a visible part
+// of its tilemap is written. Fine scrolling is applied when the queue is drawn.
+struct GP9001TileLayer {
+	INT32 bValid;
+	INT32 nXTile, nYTile;				// top left tile the queue was built for
+	INT32 bForcePriority;				// priority 0 tiles moved to priority 1 (QueueLayer2)
+	INT32 nXFine, nYFine;
+	UINT32* pQueue[16];
+	INT32 nCount[16];
+};
+
+static GP9001TileLayer TileLayer[2][3];
 static UINT32* pTileQueueData[2] = {NULL, };
 
+UINT32 GP9001TileDirty[2][4][32];		// per layer, a bit per tile written on each tile row
+INT32 bGP9001TileDirtyAll;
+
 static UINT8** pSpriteQueue[32];
 static UINT8** pSpriteQueueData[2] = {NULL, };
 
@@ -162,61 +177,63 @@ static void RenderSpriteQueue(INT32 i, INT32 nPriority)
 	}
 }
 
-static void QueueLayer(INT32 i, UINT16* pTilemap, INT32 nXPos, INT32 nYPos)
+static void QueueLayer(INT32 i, INT32 nLayer, UINT16* pTilemap, INT32 nXPos, INT32 nYPos, INT32 bForcePriority)
 {
 	INT32 x, y;
 	INT32 nTileRow, nTileColumn;
 	UINT32 nTileNumber, nTileAttrib;
 
-	UINT32** pMyTileQueue = &pTileQueue[i << 4];
+	GP9001TileLayer* pLayer = &TileLayer[i][nLayer];
+	UINT32* pDirty = GP9001TileDirty[i][nLayer];
 
-	for (y = 0; y < 16; y++) {
+	INT32 nXTile = nXPos >> 4;
+	INT32 nYTile = nYPos >> 4;
 
-		nTileRow = (((nYPos >> 4) + y) << 6) & 0x7C0;
+	pLayer->nXFine = nXPos & 15;
+	pLayer->nYFine = nYPos & 15;
 
-		for (x = 0; x < 21; x++) {
-			nTileColumn = (((nXPos >> 4) + x) << 1) & 0x3E;
-			nTileNumber = BURN_ENDIAN_SWAP_INT16(pTilemap[nTileRow + nTileColumn + 1]);
+	// Anything written to the 21 x 16 tiles on screen?
+	UINT64 nWindow = (UINT64)0x1FFFFF << (nXTile & 0x1F);
+	UINT32 nColumnMask = (UINT32)nWindow | (UINT32)(nWindow >> 32);
+	UINT32 nWritten = 0;
 
-			if (nTileNumber > 0 && nTileNumber <= nMaxTile[i]) {
-				nTileAttrib = BURN_ENDIAN_SWAP_INT16(pTilemap[nTileRow + nTileColumn]);
-				*pMyTileQueue[(nTileAttrib >> 8) & 0x0F]++ = (nTileAttrib << 16) | nTileNumber;
-				nTileXPos = (x << 4) - (nXPos & 15);
-				nTileYPos = (y << 4) - (nYPos & 15);
-				*pMyTileQueue[(nTileAttrib >> 8) & 0x0F]++ = (nTileXPos << 16) | (nTileYPos & 0xFFFF);
-#if 0
-				printf("%X ", nTileAttrib >> 8);
-#endif
-			}
-		}
+	for (y = 0; y < 16; y++) {
+		nWritten |= pDirty[(nYTile + y) & 0x1F] & nColumnMask;
 	}
-}
+	memset(pDirty, 0, sizeof(GP9001TileDirty[i][nLayer]));
 
-static void QueueLayer2(INT32 i, UINT16* pTilemap, INT32 nXPos, INT32 nYPos)
-{
-	INT32 x, y;
-	INT32 nTileRow, nTileColumn;
-	UINT32 nTileNumber, nTileAttrib;
+	if (pLayer->bValid && nWritten == 0 && !bGP9001TileDirtyAll && pLayer->nXTile == nXTile && pLayer->nYTile == nYTile && pLayer->bForcePriority == bForcePriority) {
+		return;
+	}
 
-	UINT32** pMyTileQueue = &pTileQueue[i << 4];
+	pLayer->bValid = 1;
+	pLayer->nXTile = nXTile;
+	pLayer->nYTile = nYTile;
+	pLayer->bForcePriority = bForcePriority;
+
+	for (INT32 nPriority = 0; nPriority < 16; nPriority++) {
+		pLayer->nCount[nPriority] = 0;
+	}
 
 	for (y = 0; y < 16; y++) {
 
-		nTileRow = (((nYPos >> 4) + y) << 6) & 0x7C0;
+		nTileRow = ((nYTile + y) << 6) & 0x7C0;
 
 		for (x = 0; x < 21; x++) {
-			nTileColumn = (((nXPos >> 4) + x) << 1) & 0x3E;
+			nTileColumn = ((nXTile + x) << 1) & 0x3E;
 			nTileNumber = BURN_ENDIAN_SWAP_INT16(pTilemap[nTileRow + nTileColumn + 1]);
 
 			if (nTileNumber > 0 && nTileNumber <= nMaxTile[i]) {
 				nTileAttrib = BURN_ENDIAN_SWAP_INT16(pTilemap[nTileRow + nTileColumn]);
-				if ((nTileAttrib & 0x0F00) == 0) {
+				if (bForcePriority && (nTileAttrib & 0x0F00) == 0) {
 					nTileAttrib |= 0x0100;
 				}
-				*pMyTileQueue[(nTileAttrib >> 8) & 0x0F]++ = (nTileAttrib << 16) | nTileNumber;
-				nTileXPos = (x << 4) - (nXPos & 15);
-				nTileYPos = (y << 4) - (nYPos & 15);
-				*pMyTileQueue[(nTileAttrib >> 8) & 0x0F]++ = (nTileXPos << 16) | (nTileYPos & 0xFFFF);
+
+				INT32 nPriority = (nTileAttrib >> 8) & 0x0F;
+				UINT32* pEntry = pLayer->pQueue[nPriority] + (pLayer->nCount[nPriority]++ << 1);
+
+				pEntry[0] = (nTileAttrib << 16) | nTileNumber;
+				pEntry[1] = (x << 20) | (y << 4);
 			}
 		}
 	}
@@ -224,39 +241,24 @@ static void QueueLayer2(INT32 i, UINT16* pTilemap, INT32 nXPos, INT32 nYPos)
 
 static void PrepareTiles()
 {
-	for (INT32 i = 0; i < nControllers; i++) {
-		UINT32** pMyTileQueue = &pTileQueue[i << 4];
-
-		for (INT32 nPriority = 0; nPriority < 16; nPriority++) {
-			pMyTileQueue[nPriority] = &pTileQueueData[i][nPriority * 512 * 3 * 2];
-		}
-	}
-
 	if (nControllers == 1) {
-		QueueLayer(0, (UINT16*)(GP9001RAM[0] + 0x0000), GP9001Reg[0][0] + nLayer0XOffset, GP9001Reg[0][1] + nLayer0YOffset);
-		QueueLayer(0, (UINT16*)(GP9001RAM[0] + 0x1000), GP9001Reg[0][2] + nLayer1XOffset, GP9001Reg[0][3] + nLayer1YOffset);
-		QueueLayer(0, (UINT16*)(GP9001RAM[0] + 0x2000), GP9001Reg[0][4] + nLayer2XOffset, GP9001Reg[0][5] + nLayer2YOffset);
+		QueueLayer(0, 0, (UINT16*)(GP9001RAM[0] + 0x0000), GP9001Reg[0][0] + nLayer0XOffset, GP9001Reg[0][1] + nLayer0YOffset, 0);
+		QueueLayer(0, 1, (UINT16*)(GP9001RAM[0] + 0x1000), GP9001Reg[0][2] + nLayer1XOffset, GP9001Reg[0][3] + nLayer1YOffset, 0);
+		QueueLayer(0, 2, (UINT16*)(GP9001RAM[0] + 0x2000), GP9001Reg[0][4] + nLayer2XOffset, GP9001Reg[0][5] + nLayer2YOffset, 0);
 	} else {
-		if (nMode == 2) {
-			QueueLayer(0, (UINT16*)(GP9001RAM[0] + 0x0000), GP9001Reg[0][0] + nLayer0XOffset, GP9001Reg[0][1] + nLayer0YOffset);
-			QueueLayer(0, (UINT16*)(GP9001RAM[0] + 0x1000), GP9001Reg[0][2] + nLayer1XOffset, GP9001Reg[0][3] + nLayer1YOffset);
-			QueueLayer(0, (UINT16*)(GP9001RAM[0] + 0x2000), GP9001Reg[0][4] + nLayer2XOffset, GP9001Reg[0][5] + nLayer2YOffset);
-			QueueLayer(1, (UINT16*)(GP9001RAM[1] + 0x0000), GP9001Reg[1][0] + nLayer0XOffset, GP9001Reg[1][1] + nLayer0YOffset);
-			QueueLayer(1, (UINT16*)(GP9001RAM[1] + 0x1000), GP9001Reg[1][2] + nLayer1XOffset, GP9001Reg[1][3] + nLayer1YOffset);
-			QueueLayer(1, (UINT16*)(GP9001RAM[1] + 0x2000), GP9001Reg[1][4] + nLayer2XOffset, GP9001Reg[1][5] + nLayer2YOffset);
+		QueueLayer(0, 0, (UINT16*)(GP9001RAM[0] + 0x0000), GP9001Reg[0][0] + nLayer0XOffset, GP9001Reg[0][1] + nLayer0YOffset, 0);
+		QueueLayer(0, 1, (UINT16*)(GP9001RAM[0] + 0x1000), GP9001Reg[0][2] + nLayer1XOffset, GP9001Reg[0][3] + nLayer1YOffset, 0);
+		if (nMode == 2 || GP9001Reg[0][4] + nLayer2XOffset == 0) {
+			QueueLayer(0, 2, (UINT16*)(GP9001RAM[0] + 0x2000), GP9001Reg[0][4] + nLayer2XOffset, GP9001Reg[0][5] + nLayer2YOffset, 0);
 		} else {
-			QueueLayer(0, (UINT16*)(GP9001RAM[0] + 0x0000), GP9001Reg[0][0] + nLayer0XOffset, GP9001Reg[0][1] + nLayer0YOffset);
-			QueueLayer(0, (UINT16*)(GP9001RAM[0] + 0x1000), GP9001Reg[0][2] + nLayer1XOffset, GP9001Reg[0][3] + nLayer1YOffset);
-			if (GP9001Reg[0][4] + nLayer2XOffset == 0) {
-				QueueLayer(0, (UINT16*)(GP9001RAM[0] + 0x2000), GP9001Reg[0][4] + nLayer2XOffset, GP9001Reg[0][5] + nLayer2YOffset);
-			} else {
-				QueueLayer2(0, (UINT16*)(GP9001RAM[0] + 0x2000), GP9001Reg[0][4] + nLayer2XOffset, GP9001Reg[0][5] + nLayer2YOffset);
-			}
-			QueueLayer(1, (UINT16*)(GP9001RAM[1] + 0x0000), GP9001Reg[1][0] + nLayer0XOffset, GP9001Reg[1][1] + nLayer0YOffset);
-			QueueLayer(1, (UINT16*)(GP9001RAM[1] + 0x1000), GP9001Reg[1][2] + nLayer1XOffset, GP9001Reg[1][3] + nLayer1YOffset);
-			QueueLayer(1, (UINT16*)(GP9001RAM[1] + 0x2000), GP9001Reg[1][4] + nLayer2XOffset, GP9001Reg[1][5] + nLayer2YOffset);
+			QueueLayer(0, 2, (UINT16*)(GP9001RAM[0] + 0x2000), GP9001Reg[0][4] + nLayer2XOffset, GP9001Reg[0][5] + nLayer2YOffset, 1);
 		}
+		QueueLayer(1, 0, (UINT16*)(GP9001RAM[1] + 0x0000), GP9001Reg[1][0] + nLayer0XOffset, GP9001Reg[1][1] + nLayer0YOffset, 0);
+		QueueLayer(1, 1, (UINT16*)(GP9001RAM[1] + 0x1000), GP9001Reg[1][2] + nLayer1XOffset, GP9001Reg[1][3] + nLayer1YOffset, 0);
+		QueueLayer(1, 2, (UINT16*)(GP9001RAM[1] + 0x2000), GP9001Reg[1][4] + nLayer2XOffset, GP9001Reg[1][5] + nLayer2YOffset, 0);
 	}
+
+	bGP9001TileDirtyAll = 0;
 }
 
 static void RenderTileQueue(INT32 i, INT32 nPriority)
@@ -265,93 +267,94 @@ static void RenderTileQueue(INT32 i, INT32 nPriority)
 	UINT8* pTileStart;
 	UINT8 nOpacity;
 
-	UINT32** pMyTileQueue = &pTileQueue[i << 4];
-
-	*pMyTileQueue[nPriority] = 0;
-	pMyTileQueue[nPriority] = &pTileQueueData[i][nPriority * 512 * 3 * 2];
+	for (INT32 nLayer = 0; nLayer < 3; nLayer++) {
+		GP9001TileLayer* pLayer = &TileLayer[i][nLayer];
+		UINT32* pQueue = pLayer->pQueue[nPriority];
 
-	while ((nTileNumber = *pMyTileQueue[nPriority]++) != 0) {
-		nTileXPos = (INT16)(*pMyTileQueue[nPriority] >> 16);
-		nTileYPos = (INT16)(*pMyTileQueue[nPriority]++ & 0xFFFF);
-		nTileAttrib = nTileNumber;
-		nTileNumber = ((nTileNumber & 0x1FFF) << 2) + GP9001TileBank[(nTileNumber >> 13) & 7];
+		for (INT32 n = pLayer->nCount[nPriority]; n > 0; n--) {
+			nTileNumber = *pQueue++;
+			nTileXPos = (INT16)(*pQueue >> 16) - pLayer->nXFine;
+			nTileYPos = (INT16)(*pQueue++ & 0xFFFF) - pLayer->nYFine;
+			nTileAttrib = nTileNumber;
+			nTileNumber = ((nTileNumber & 0x1FFF) << 2) + GP9001TileBank[(nTileNumber >> 13) & 7];
 
-		pTileStart = GP9001ROM[i] + (nTileNumber << 5);
-		pTilePalette = &ToaPalette[(nTileAttrib >> 12) & 0x07F0];
+			pTileStart = GP9001ROM[i] + (nTileNumber << 5);
+			pTilePalette = &ToaPalette[(nTileAttrib >> 12) & 0x07F0];
 
-		if (nTileXPos >= 0 && nTileXPos < 304 && nTileYPos >= 0 && nTileYPos < 224) {
-			INT32 nTileWidth = 8 * nBurnColumn;
-			pTile = pBurnBitmap + (nTileXPos * nBurnColumn) + (nTileYPos * nBurnRow);
+			if (nTileXPos >= 0 && nTileXPos < 304 && nTileYPos >= 0 && nTileYPos < 224) {
+				INT32 nTileWidth = 8 * nBurnColumn;
+				pTile = pBurnBitmap + (nTileXPos * nBurnColumn) + (nTileYPos * nBurnRow);
 
-			if ((nOpacity = GP9001TileAttrib[i][nTileNumber]) != 0) {
-				pTileData = (UINT32*)pTileStart;
-				RenderTile[nOpacity - 1]();
-			}
-			if ((nOpacity = GP9001TileAttrib[i][nTileNumber + 1]) != 0) {
-				pTile += nTileWidth;
-				pTileData = (UINT32*)(pTileStart + 32);
-				RenderTile[nOpacity - 1]();
-				pTile -= nTileWidth;
-			}
-			pTile += 8 * nBurnRow;
-			if ((nOpacity = GP9001TileAttrib[i][nTileNumber + 2]) != 0) {
-				pTileData = (UINT32*)(pTileStart + 64);
-				RenderTile[nOpacity - 1]();
-			}
-			if ((nOpacity = GP9001TileAttrib[i][nTileNumber + 3]) != 0) {
-				pTile += nTileWidth;
-				pTileData = (UINT32*)(pTileStart + 96);
-				RenderTile[nOpacity - 1]();
-			}
-		} else {
-			INT32 nTileWidth = 8 * nBurnColumn;
-			pTile = pBurnBitmap + (nTileXPos * nBurnColumn) + (nTileYPos * nBurnRow);
-
-			if ((nOpacity = GP9001TileAttrib[i][nTileNumber]) != 0) {
-				if (nTileXPos > -8 && nTileXPos < 320 && nTileYPos > -8 && nTileYPos < 240) {
+				if ((nOpacity = GP9001TileAttrib[i][nTileNumber]) != 0) {
 					pTileData = (UINT32*)pTileStart;
-					if (nTileXPos > 0 && nTileXPos <= 312 && nTileYPos > 0 && nTileYPos <= 232) {
-						RenderTile[nOpacity - 1]();
-					} else {
-						RenderTile[nOpacity]();
-					}
+					RenderTile[nOpacity - 1]();
 				}
-			}
-			if ((nOpacity = GP9001TileAttrib[i][nTileNumber + 1]) != 0) {
-				pTile += nTileWidth;
-				nTileXPos += 8;
-				if (nTileXPos > -8 && nTileXPos < 320 && nTileYPos > -8 && nTileYPos < 240) {
+				if ((nOpacity = GP9001TileAttrib[i][nTileNumber + 1]) != 0) {
+					pTile += nTileWidth;
 					pTileData = (UINT32*)(pTileStart + 32);
-					if (nTileXPos > 0 && nTileXPos <= 312 && nTileYPos > 0 && nTileYPos <= 232) {
-						RenderTile[nOpacity - 1]();
-					} else {
-						RenderTile[nOpacity]();
-					}
+					RenderTile[nOpacity - 1]();
+					pTile -= nTileWidth;
 				}
-				nTileXPos -= 8;
-				pTile -= nTileWidth;
-			}
-			nTileYPos += 8;
-			pTile += 8 * nBurnRow;
-			if ((nOpacity = GP9001TileAttrib[i][nTileNumber + 2]) != 0) {
-				if (nTileXPos > -8 && nTileXPos < 320 && nTileYPos > -8 && nTileYPos < 240) {
+				pTile += 8 * nBurnRow;
+				if ((nOpacity = GP9001TileAttrib[i][nTileNumber + 2]) != 0) {
 					pTileData = (UINT32*)(pTileStart + 64);
-					if (nTileXPos > 0 && nTileXPos <= 312 && nTileYPos > 0 && nTileYPos <= 232) {
-						RenderTile[nOpacity - 1]();
-					} else {
-						RenderTile[nOpacity]();
-					}
+					RenderTile[nOpacity - 1]();
 				}
-			}
-			if ((nOpacity = GP9001TileAttrib[i][nTileNumber + 3]) != 0) {
-				nTileXPos += 8;
-				pTile += nTileWidth;
-				if (nTileXPos > -8 && nTileXPos < 320 && nTileYPos > -8 && nTileYPos < 240) {
+				if ((nOpacity = GP9001TileAttrib[i][nTileNumber + 3]) != 0) {
+					pTile += nTileWidth;
 					pTileData = (UINT32*)(pTileStart + 96);
-					if (nTileXPos > 0 && nTileXPos <= 312 && nTileYPos > 0 && nTileYPos <= 232) {
-						RenderTile[nOpacity - 1]();
-					} else {
-						RenderTile[nOpacity]();
+					RenderTile[nOpacity - 1]();
+				}
+			} else {
+				INT32 nTileWidth = 8 * nBurnColumn;
+				pTile = pBurnBitmap + (nTileXPos * nBurnColumn) + (nTileYPos * nBurnRow);
+
+				if ((nOpacity = GP9001TileAttrib[i][nTileNumber]) != 0) {
+					if (nTileXPos > -8 && nTileXPos < 320 && nTileYPos > -8 && nTileYPos < 240) {
+						pTileData = (UINT32*)pTileStart;
+						if (nTileXPos > 0 && nTileXPos <= 312 && nTileYPos > 0 && nTileYPos <= 232) {
+							RenderTile[nOpacity - 1]();
+						} else {
+							RenderTile[nOpacity]();
+						}
+					}
+				}
+				if ((nOpacity = GP9001TileAttrib[i][nTileNumber + 1]) != 0) {
+					pTile += nTileWidth;
+					nTileXPos += 8;
+					if (nTileXPos > -8 && nTileXPos < 320 && nTileYPos > -8 && nTileYPos < 240) {
+						pTileData = (UINT32*)(pTileStart + 32);
+						if (nTileXPos > 0 && nTileXPos <= 312 && nTileYPos > 0 && nTileYPos <= 232) {
+							RenderTile[nOpacity - 1]();
+						} else {
+							RenderTile[nOpacity]();
+						}
+					}
+					nTileXPos -= 8;
+					pTile -= nTileWidth;
+				}
+				nTileYPos += 8;
+				pTile += 8 * nBurnRow;
+				if ((nOpacity = GP9001TileAttrib[i][nTileNumber + 2]) != 0) {
+					if (nTileXPos > -8 && nTileXPos < 320 && nTileYPos > -8 && nTileYPos < 240) {
+						pTileData = (UINT32*)(pTileStart + 64);
+						if (nTileXPos > 0 && nTileXPos <= 312 && nTileYPos > 0 && nTileYPos <= 232) {
+							RenderTile[nOpacity - 1]();
+						} else {
+							RenderTile[nOpacity]();
+						}
+					}
+				}
+				if ((nOpacity = GP9001TileAttrib[i][nTileNumber + 3]) != 0) {
+					nTileXPos += 8;
+					pTile += nTileWidth;
+					if (nTileXPos > -8 && nTileXPos < 320 && nTileYPos > -8 && nTileYPos < 240) {
+						pTileData = (UINT32*)(pTileStart + 96);
+						if (nTileXPos > 0 && nTileXPos <= 312 && nTileYPos > 0 && nTileYPos <= 232) {
+							RenderTile[nOpacity - 1]();
+						} else {
+							RenderTile[nOpacity]();
+						}
 					}
 				}
 			}
@@ -491,6 +494,15 @@ INT32 ToaInitGP9001(INT32 n)
 		pTileQueueData[i] = (UINT32*)BurnMalloc(nSize);
 		memset(pTileQueueData[i], 0, nSize);
 
+		for (INT32 nLayer = 0; nLayer < 3; nLayer++) {
+			TileLayer[i][nLayer].bValid = 0;
+			for (INT32 nPriority = 0; nPriority < 16; nPriority++) {
+				TileLayer[i][nLayer].pQueue[nPriority] = &pTileQueueData[i][(nLayer * 16 + nPriority) * 512 * 2];
+				TileLayer[i][nLayer].nCount[nPriority] = 0;
+			}
+		}
+		memset(GP9001TileDirty[i], 0, sizeof(GP9001TileDirty[i]));
+
 		nSize = 0x10 * 0x101 * sizeof(UINT8*);
 		pSpriteQueueData[i] = (UINT8**)BurnMalloc(nSize);
 		memset(pSpriteQueueData[i], 0, nSize);
@@ -607,5 +619,9 @@ INT32 ToaScanGP9001(INT32 nAction, INT32* pnMin)
 		SCAN_VAR(GP9001TileBank);
 	}
 
+	if (nAction & ACB_WRITE) {			// VRAM may have changed, rebuild the tile queues
+		bGP9001TileDirtyAll = 1;
+	}
+
 	return 0;
 }
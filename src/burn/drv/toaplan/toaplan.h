@@ -113,6 +113,16 @@ inline static void ToaGP9001SetRAMPointer(UINT32 wordValue, const INT32 nControl
 inline static void ToaGP9001WriteRAM(const UINT16 wordValue, const INT32 nController)
 {
 	extern UINT8* GP9001Pointer[2];
+	extern UINT32 GP9001TileDirty[2][4][32];
+	extern INT32 bGP9001TileDirtyAll;
+
+	// Note which tile was written, so the tile queues know what to rebuild
+	UINT32 nOffset = GP9001Pointer[nController] - GP9001RAM[nController];
+	if (nOffset < 0x3000) {
+		GP9001TileDirty[nController][nOffset >> 12][(nOffset >> 7) & 0x1F] |= 1 << ((nOffset >> 2) & 0x1F);
+	} else if (nOffset >= 0x4000) {
+		bGP9001TileDirtyAll = 1;
+	}
 
 	*((UINT16*)(GP9001Pointer[nController])) = BURN_ENDIAN_SWAP_INT16(wordValue);
 	GP9001Pointer[nController] += 2;
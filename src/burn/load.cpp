@@ -1,6 +1,67 @@
 // Burn - Rom Loading module
 #include "burnint.h"
 
+// Memory the running driver has loaded roms into. The Z80 decode cache only keeps pages that
+// lie inside one of these, anything else may be ram written from where the cpu can't see it.
+#define ROM_REGIONS_MAX		64
+
+static UINT8* pRomRegionStart[ROM_REGIONS_MAX];
+static UINT8* pRomRegionEnd[ROM_REGIONS_MAX];
+static INT32 nRomRegionCount = 0;
+
+static void BurnRomRegionAdd(UINT8* pStart, INT32 nLen)
+{
+	UINT8* pEnd = pStart + nLen;
+
+	// roms are mostly loaded back to back, so grow a region this one touches
+	for (INT32 i = 0; i < nRomRegionCount; i++) {
+		if (pStart <= pRomRegionEnd[i] && pEnd >= pRomRegionStart[i]) {
+			if (pStart < pRomRegionStart[i]) pRomRegionStart[i] = pStart;
+			if (pEnd > pRomRegionEnd[i]) pRomRegionEnd[i] = pEnd;
+			return;
+		}
+	}
+
+	// out of regions, anything not recorded is just never cached
+	if (nRomRegionCount < ROM_REGIONS_MAX) {
+		pRomRegionStart[nRomRegionCount] = pStart;
+		pRomRegionEnd[nRomRegionCount] = pEnd;
+		nRomRegionCount++;
+	}
+}
+
+void BurnRomRegionReset()
+{
+	nRomRegionCount = 0;
+}
+
+// Forget regions in a block that is being freed, it may come back as ram
+void BurnRomRegionFree(UINT8* pStart, INT32 nLen)
+{
+	UINT8* pEnd = pStart + nLen;
+
+	for (INT32 i = 0; i < nRomRegionCount; i++) {
+		if (pRomRegionStart[i] < pEnd && pRomRegionEnd[i] > pStart) {
+			nRomRegionCount--;
+			pRomRegionStart[i] = pRomRegionStart[nRomRegionCount];
+			pRomRegionEnd[i] = pRomRegionEnd[nRomRegionCount];
+			i--;
+		}
+	}
+}
+
+// Returns 1 if all of pStart to pStart + nLen was loaded from roms
+INT32 BurnRomRegionCheck(UINT8* pStart, INT32 nLen)
+{
+	for (INT32 i = 0; i < nRomRegionCount; i++) {
+		if (pStart >= pRomRegionStart[i] && pStart + nLen <= pRomRegionEnd[i]) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
 // Load a rom and separate out the bytes by nGap
 // Dest is the memory block to insert the rom into
 INT32 BurnLoadRomExt(UINT8 *Dest, INT32 i, INT32 nGap, INT32 nFlags)
@@ -73,6 +134,11 @@ INT32 BurnLoadRomExt(UINT8 *Dest, INT32 i, INT32 nGap, INT32 nFlags)
 			free(Load);
 			Load = NULL;
 		}
+
+		INT32 nGroups = (nLoadLen + nGroup - 1) / nGroup;
+		if (nGroups) {
+			BurnRomRegionAdd(Dest, nNibbles ? (nLoadLen * 2) : ((nGroups - 1) * nGap + nGroup));
+		}
 	}
 	else
 	{
@@ -90,6 +156,8 @@ INT32 BurnLoadRomExt(UINT8 *Dest, INT32 i, INT32 nGap, INT32 nFlags)
 		if (nFlags & LD_BYTESWAP) {
 			BurnByteswap(Dest, nLen);
 		}
+
+		BurnRomRegionAdd(Dest, nLen);
 	}
 
 	return 0;
@@ -1,6 +1,7 @@
 #include "burnint.h"
 #include "burn_sound.h"
 #include "burn_ym2151.h"
+#include "burn_trace.h"
 
 void (*BurnYM2151Render)(INT16* pSoundBuf, INT32 nSegmentLength);
 
@@ -22,6 +23,8 @@ static INT32 YM2151RouteDirs[2];
 
 static void YM2151RenderResample(INT16* pSoundBuf, INT32 nSegmentLength)
 {
+	BURN_TRACE_SCOPE("YM2151", "sound");
+
 #if defined FBA_DEBUG
 	if (!DebugSnd_YM2151Initted) bprintf(PRINT_ERROR, _T("YM2151RenderResample called without init\n"));
 #endif
@@ -105,6 +108,8 @@ static void YM2151RenderResample(INT16* pSoundBuf, INT32 nSegmentLength)
 
 static void YM2151RenderNormal(INT16* pSoundBuf, INT32 nSegmentLength)
 {
+	BURN_TRACE_SCOPE("YM2151", "sound");
+
 #if defined FBA_DEBUG
 	if (!DebugSnd_YM2151Initted) bprintf(PRINT_ERROR, _T("YM2151RenderNormal called without init\n"));
 #endif
@@ -1,6 +1,7 @@
 #include "burnint.h"
 #include "burn_sound.h"
 #include "burn_ym2203.h"
+#include "burn_trace.h"
 
 #define MAX_YM2203	3
 
@@ -148,6 +149,8 @@ static void YM2203Render(INT32 nSegmentLength)
 
 static void YM2203UpdateResample(INT16* pSoundBuf, INT32 nSegmentEnd)
 {
+	BURN_TRACE_SCOPE("YM2203", "sound");
+
 #if defined FBA_DEBUG
 	if (!DebugSnd_YM2203Initted) bprintf(PRINT_ERROR, _T("YM2203UpdateResample called without init\n"));
 #endif
@@ -314,6 +317,8 @@ static void YM2203UpdateResample(INT16* pSoundBuf, INT32 nSegmentEnd)
 
 static void YM2203UpdateNormal(INT16* pSoundBuf, INT32 nSegmentEnd)
 {
+	BURN_TRACE_SCOPE("YM2203", "sound");
+
 #if defined FBA_DEBUG
 	if (!DebugSnd_YM2203Initted) bprintf(PRINT_ERROR, _T("YM2203UpdateNormal called without init\n"));
 #endif
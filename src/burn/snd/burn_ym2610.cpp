@@ -1,6 +1,7 @@
 #include "burnint.h"
 #include "burn_sound.h"
 #include "burn_ym2610.h"
+#include "burn_trace.h"
 
 void (*BurnYM2610Update)(INT16* pSoundBuf, INT32 nSegmentEnd);
 
@@ -91,6 +92,8 @@ static void YM2610Render(INT32 nSegmentLength)
 
 static void YM2610UpdateResample(INT16* pSoundBuf, INT32 nSegmentEnd)
 {
+	BURN_TRACE_SCOPE("YM2610", "sound");
+
 #if defined FBA_DEBUG
 	if (!DebugSnd_YM2610Initted) bprintf(PRINT_ERROR, _T("YM2610UpdateResample called without init\n"));
 #endif
@@ -239,6 +242,8 @@ static void YM2610UpdateResample(INT16* pSoundBuf, INT32 nSegmentEnd)
 
 static void YM2610UpdateNormal(INT16* pSoundBuf, INT32 nSegmentEnd)
 {
+	BURN_TRACE_SCOPE("YM2610", "sound");
+
 #if defined FBA_DEBUG
 	if (!DebugSnd_YM2610Initted) bprintf(PRINT_ERROR, _T("YM2610UpdateNormal called without init\n"));
 #endif
@@ -1,6 +1,7 @@
 #include "burnint.h"
 #include "burn_sound.h"
 #include "burn_ym2612.h"
+#include "burn_trace.h"
 
 #define MAX_YM2612	2
 
@@ -89,6 +90,8 @@ static void YM2612Render(INT32 nSegmentLength)
 
 static void YM2612UpdateResample(INT16* pSoundBuf, INT32 nSegmentEnd)
 {
+	BURN_TRACE_SCOPE("YM2612", "sound");
+
 #if defined FBA_DEBUG
 	if (!DebugSnd_YM2612Initted) bprintf(PRINT_ERROR, _T("YM2612UpdateResample called without init\n"));
 #endif
@@ -168,6 +171,8 @@ static void YM2612UpdateResample(INT16* pSoundBuf, INT32 nSegmentEnd)
 
 static void YM2612UpdateNormal(INT16* pSoundBuf, INT32 nSegmentEnd)
 {
+	BURN_TRACE_SCOPE("YM2612", "sound");
+
 #if defined FBA_DEBUG
 	if (!DebugSnd_YM2612Initted) bprintf(PRINT_ERROR, _T("YM2612UpdateNormal called without init\n"));
 #endif
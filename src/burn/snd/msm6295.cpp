@@ -2,6 +2,7 @@
 #include "burnint.h"
 #include "msm6295.h"
 #include "burn_sound.h"
+#include "burn_trace.h"
 
 UINT8* MSM6295ROM;
 UINT8* MSM6295SampleInfo[MAX_MSM6295][4];
@@ -314,6 +315,8 @@ static void MSM6295Render_Cubic(INT32 nChip, INT32* pLeftBuf, INT32 *pRightBuf,
 
 INT32 MSM6295Render(INT32 nChip, INT16* pSoundBuf, INT32 nSegmentLength)
 {
+	BURN_TRACE_SCOPE("MSM6295", "sound");
+
 #if defined FBA_DEBUG
 	if (!DebugSnd_MSM6295Initted) bprintf(PRINT_ERROR, _T("MSM6295Render called without init\n"));
 	if (nChip > nLastMSM6295Chip) bprintf(PRINT_ERROR, _T("MSM6295Render called with invalid chip number %x\n"), nChip);
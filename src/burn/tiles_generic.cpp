@@ -14,6 +14,7 @@ Otherwise, use the Transfer code as usual.
 ================================================================================================*/
 
 #include "tiles_generic.h"
+#include "burn_trace.h"
 
 UINT8* pTileData;
 INT32 nScreenWidth, nScreenHeight;
@@ -63,6 +64,8 @@ void BurnTransferClear()
 
 INT32 BurnTransferCopy(UINT32* pPalette)
 {
+	BURN_TRACE_SCOPE("BurnTransferCopy", "video");
+
 #if defined FBA_DEBUG
 	if (!Debug_BurnTransferInitted) bprintf(PRINT_ERROR, _T("BurnTransferCopy called without init\n"));
 #endif
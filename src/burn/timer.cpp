@@ -15,7 +15,11 @@
 
 double dTime;									// Time elapsed since the emulated machine was started
 
-static INT32 nTimerCount[2], nTimerStart[2];
+// Timers 0 and 1 belong to the sound chip, the rest are added by BurnTimerAdd()
+static INT32 nTimerCount[BURN_TIMER_MAX], nTimerStart[BURN_TIMER_MAX];
+static void (*pTimerCallback[BURN_TIMER_MAX])(INT32);
+static INT32 nTimerParam[BURN_TIMER_MAX];
+static INT32 nTimerUsed = 2;
 
 // Callbacks
 static INT32 (*pTimerOverCallback)(INT32, INT32);
@@ -44,6 +48,23 @@ extern "C" double BurnTimerGetTime()
 
 static INT32 nTicksTotal, nTicksDone, nTicksExtra;
 
+// Reload a timer if it is due, returns its bit for the fired mask
+static inline INT32 TimerCheck(INT32 c)
+{
+	if (nTicksDone < nTimerCount[c]) {
+		return 0;
+	}
+
+	if (nTimerStart[c] == MAX_TIMER_VALUE) {
+		nTimerCount[c] = MAX_TIMER_VALUE;
+	} else {
+		nTimerCount[c] += nTimerStart[c];
+	}
+//	bprintf(PRINT_NORMAL, _T("  - timer %i fired\n"), c);
+
+	return 1 << c;
+}
+
 INT32 BurnTimerUpdate(INT32 nCycles)
 {
 	INT32 nIRQStatus = 0;
@@ -61,6 +82,11 @@ INT32 BurnTimerUpdate(INT32 nCycles)
 		} else {
 			nTicksSegment = nTimerCount[1];
 		}
+		for (INT32 c = 2; c < nTimerUsed; c++) {
+			if (nTimerCount[c] < nTicksSegment) {
+				nTicksSegment = nTimerCount[c];
+			}
+		}
 		if (nTicksSegment > nTicksTotal) {
 			nTicksSegment = nTicksTotal;
 		}
@@ -73,31 +99,23 @@ INT32 BurnTimerUpdate(INT32 nCycles)
 		nTicksDone = MAKE_TIMER_TICKS(pCPUTotalCycles() + 1, nCPUClockspeed) - 1;
 //		bprintf(PRINT_NORMAL, _T("  - ticks done -> %08X cycles -> %i\n"), nTicksDone, pCPUTotalCycles());
 
-		nTimer = 0;
-		if (nTicksDone >= nTimerCount[0]) {
-			if (nTimerStart[0] == MAX_TIMER_VALUE) {
-				nTimerCount[0] = MAX_TIMER_VALUE;
-			} else {
-				nTimerCount[0] += nTimerStart[0];
-			}
-//			bprintf(PRINT_NORMAL, _T("  - timer 0 fired\n"));
-			nTimer |= 1;
-		}
-		if (nTicksDone >= nTimerCount[1]) {
-			if (nTimerStart[1] == MAX_TIMER_VALUE) {
-				nTimerCount[1] = MAX_TIMER_VALUE;
-			} else {
-				nTimerCount[1] += nTimerStart[1];
-			}
-//			bprintf(PRINT_NORMAL, _T("  - timer 1 fired\n"));
-			nTimer |= 2;
+		// Reload every timer that is due before calling any of them back
+		nTimer = TimerCheck(0) | TimerCheck(1);
+		for (INT32 c = 2; c < nTimerUsed; c++) {
+			nTimer |= TimerCheck(c);
 		}
+
 		if (nTimer & 1) {
 			nIRQStatus |= pTimerOverCallback(0, 0);
 		}
 		if (nTimer & 2) {
 			nIRQStatus |= pTimerOverCallback(0, 1);
 		}
+		for (INT32 c = 2; (nTimer >> c) != 0; c++) {
+			if (nTimer & (1 << c)) {
+				pTimerCallback[c](nTimerParam[c]);
+			}
+		}
 	}
 
 	return nIRQStatus;
@@ -109,11 +127,10 @@ void BurnTimerEndFrame(INT32 nCycles)
 
 	BurnTimerUpdate(nCycles);
 
-	if (nTimerCount[0] < MAX_TIMER_VALUE) {
-		nTimerCount[0] -= nTicks;
-	}
-	if (nTimerCount[1] < MAX_TIMER_VALUE) {
-		nTimerCount[1] -= nTicks;
+	for (INT32 c = 0; c < nTimerUsed; c++) {
+		if (nTimerCount[c] < MAX_TIMER_VALUE) {
+			nTimerCount[c] -= nTicks;
+		}
 	}
 
 	nTicksDone -= nTicks;
@@ -251,11 +268,17 @@ void BurnTimerScan(INT32 nAction, INT32* pnMin)
 	}
 
 	if (nAction & ACB_DRIVER_DATA) {
-		SCAN_VAR(nTimerCount);
-		SCAN_VAR(nTimerStart);
+		// the sound chip's timers keep their old layout, added timers follow them
+		ScanVar(nTimerCount, 2 * sizeof(INT32), "nTimerCount");
+		ScanVar(nTimerStart, 2 * sizeof(INT32), "nTimerStart");
 		SCAN_VAR(dTime);
 
 		SCAN_VAR(nTicksDone);
+
+		if (nTimerUsed > 2) {
+			ScanVar(nTimerCount + 2, (nTimerUsed - 2) * sizeof(INT32), "nTimerAddedCount");
+			ScanVar(nTimerStart + 2, (nTimerUsed - 2) * sizeof(INT32), "nTimerAddedStart");
+		}
 	}
 }
 
@@ -266,13 +289,16 @@ void BurnTimerExit()
 	pCPURun = NULL;
 	pCPURunEnd = NULL;
 
+	nTimerUsed = 2;
+
 	return;
 }
 
 void BurnTimerReset()
 {
-	nTimerCount[0] = nTimerCount[1] = MAX_TIMER_VALUE;
-	nTimerStart[0] = nTimerStart[1] = MAX_TIMER_VALUE;
+	for (INT32 c = 0; c < BURN_TIMER_MAX; c++) {
+		nTimerCount[c] = nTimerStart[c] = MAX_TIMER_VALUE;
+	}
 
 	dTime = 0.0;
 
@@ -291,6 +317,22 @@ INT32 BurnTimerInit(INT32 (*pOverCallback)(INT32, INT32), double (*pTimeCallback
 	return 0;
 }
 
+INT32 BurnTimerAdd(void (*pCallback)(INT32), INT32 nParam)
+{
+	if (nTimerUsed >= BURN_TIMER_MAX) {
+		bprintf(PRINT_ERROR, _T("BurnTimerAdd: no timers left.\n"));
+		return -1;
+	}
+
+	INT32 c = nTimerUsed++;
+
+	pTimerCallback[c] = pCallback;
+	nTimerParam[c] = nParam;
+	nTimerCount[c] = nTimerStart[c] = MAX_TIMER_VALUE;
+
+	return c;
+}
+
 INT32 BurnTimerAttachSek(INT32 nClockspeed)
 {
 	nCPUClockspeed = nClockspeed;
@@ -11,10 +11,15 @@ void BurnOPNTimerCallback(INT32 n, INT32 c, INT32 cnt, double stepTime);	// peri
 void BurnOPLTimerCallback(INT32 c, double period);					// period in  s
 void BurnYMFTimerCallback(INT32 n, INT32 c, double period);				// period in us
 
-// Start / stop a timer
+// Start / stop a timer (period 0 stops it)
 void BurnTimerSetRetrig(INT32 c, double period);						// period in  s
 void BurnTimerSetOneshot(INT32 c, double period);						// period in  s
 
+// Timers 0 and 1 are the sound chip's, drivers can add more after BurnTimerInit().
+// The cpu runs straight to whichever running timer fires next.
+#define BURN_TIMER_MAX (16)
+INT32 BurnTimerAdd(void (*pCallback)(INT32 nParam), INT32 nParam);	// returns the timer number for the functions above, -1 if none are left
+
 extern double dTime;
 
 void BurnTimerExit();
@@ -0,0 +1,446 @@
+// Burner ROM set auditor
+//
+// Checks every driver's rom list against the archives in the rom paths, using only the
+// names, sizes and CRCs stored in the zip central directory (or the 7z database) - nothing
+// gets inflated. Each archive is read once, however many sets share it, and the reading is
+// spread over a few threads. The result is written out as JSON.
+
+#include "burner.h"
+
+#if !defined (_WIN32)
+ #include <pthread.h>
+ #include <unistd.h>
+ #define AUDIT_THREADED
+#else
+ #define strcasecmp _stricmp
+#endif
+
+#define AUDIT_MAX_THREADS	16
+#define AUDIT_HASH_SIZE		0x4000
+
+#define AUDIT_ROM_OK		0
+#define AUDIT_ROM_MISSING	1
+#define AUDIT_ROM_BADCRC	2
+#define AUDIT_ROM_BADSIZE	3
+#define AUDIT_ROM_NODUMP	4
+
+static const char* szRomStatus[] = { "ok", "missing", "badcrc", "badsize", "nodump" };
+
+struct AuditArchive {
+	char* szName;						// archive name without path or extension
+	char* szPath;						// where it was found, NULL if it wasn't
+	struct ZipEntry* List;
+	INT32 nListCount;
+	INT32 nHashNext;
+};
+
+static struct AuditArchive* Archive = NULL;
+static INT32 nArchiveCount = 0;
+static INT32 nArchiveSize = 0;
+static INT32 nArchiveHash[AUDIT_HASH_SIZE];
+
+static INT32* pDrvArchive = NULL;		// BZIP_MAX archive indices per driver, -1 terminated
+
+static UINT32 AuditHashName(const char* szName)
+{
+	UINT32 nHash = 2166136261U;
+
+	while (*szName) {
+		nHash = (nHash ^ (UINT8)*szName++) * 16777619U;
+	}
+
+	return nHash & (AUDIT_HASH_SIZE - 1);
+}
+
+static INT32 AuditAddArchive(const char* szName)
+{
+	UINT32 nHash = AuditHashName(szName);
+
+	for (INT32 i = nArchiveHash[nHash]; i >= 0; i = Archive[i].nHashNext) {
+		if (strcmp(Archive[i].szName, szName) == 0) {
+			return i;
+		}
+	}
+
+	if (nArchiveCount == nArchiveSize) {
+		INT32 nNewSize = nArchiveSize ? nArchiveSize * 2 : 1024;
+		struct AuditArchive* NewArchive = (struct AuditArchive*)realloc(Archive, nNewSize * sizeof(struct AuditArchive));
+		if (NewArchive == NULL) {
+			return -1;
+		}
+		Archive = NewArchive;
+		nArchiveSize = nNewSize;
+	}
+
+	struct AuditArchive* pa = &Archive[nArchiveCount];
+	memset(pa, 0, sizeof(struct AuditArchive));
+
+	pa->szName = strdup(szName);
+	if (pa->szName == NULL) {
+		return -1;
+	}
+
+	pa->nHashNext = nArchiveHash[nHash];
+	nArchiveHash[nHash] = nArchiveCount;
+
+	return nArchiveCount++;
+}
+
+// ---------------------------------------------------------------------------
+// Archive scanning
+
+#if defined (AUDIT_THREADED)
+static pthread_mutex_t AuditMutex = PTHREAD_MUTEX_INITIALIZER;
+#ifdef INCLUDE_7Z_SUPPORT
+static pthread_mutex_t Audit7zMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+#endif
+
+static INT32 nArchiveNext = 0;
+static char szAuditRomPath[DIRS_MAX][MAX_PATH];
+
+static void AuditScanArchive(struct AuditArchive* pa)
+{
+	char szPath[MAX_PATH];
+
+	for (INT32 d = 0; d < DIRS_MAX; d++) {
+		char* szRomPath = szAuditRomPath[d];
+
+		if (snprintf(szPath, MAX_PATH, "%s%s.zip", szRomPath, pa->szName) >= MAX_PATH) {
+			continue;
+		}
+
+		if (ZipReadList(szPath, &pa->List, &pa->nListCount) == 0) {
+			pa->szPath = strdup(szPath);
+			return;
+		}
+
+#ifdef INCLUDE_7Z_SUPPORT
+		if (snprintf(szPath, MAX_PATH, "%s%s.7z", szRomPath, pa->szName) >= MAX_PATH) {
+			continue;
+		}
+
+		FILE* fp = fopen(szPath, "rb");
+		if (fp) {
+			fclose(fp);
+
+#if defined (AUDIT_THREADED)
+			pthread_mutex_lock(&Audit7zMutex);
+#endif
+			INT32 nRet = ZipReadList(szPath, &pa->List, &pa->nListCount);
+#if defined (AUDIT_THREADED)
+			pthread_mutex_unlock(&Audit7zMutex);
+#endif
+
+			if (nRet == 0) {
+				pa->szPath = strdup(szPath);
+				return;
+			}
+		}
+#endif
+	}
+}
+
+static void* AuditScanThread(void*)
+{
+	while (1) {
+#if defined (AUDIT_THREADED)
+		pthread_mutex_lock(&AuditMutex);
+#endif
+		INT32 i = nArchiveNext++;
+#if defined (AUDIT_THREADED)
+		pthread_mutex_unlock(&AuditMutex);
+#endif
+
+		if (i >= nArchiveCount) {
+			break;
+		}
+
+		AuditScanArchive(&Archive[i]);
+	}
+
+	return NULL;
+}
+
+static void AuditScanArchives(INT32 nThreads)
+{
+	nArchiveNext = 0;
+
+	// TCHARToANSI() can return a shared buffer, so convert the paths before any threads start
+	for (INT32 d = 0; d < DIRS_MAX; d++) {
+		TCHARToANSI(szAppRomPaths[d], szAuditRomPath[d], MAX_PATH);
+	}
+
+#if defined (AUDIT_THREADED)
+	pthread_t Thread[AUDIT_MAX_THREADS];
+	INT32 nStarted = 0;
+
+	// The calling thread is one of the scanners
+	while (nStarted < nThreads - 1) {
+		if (pthread_create(&Thread[nStarted], NULL, AuditScanThread, NULL)) {
+			break;
+		}
+		nStarted++;
+	}
+
+	AuditScanThread(NULL);
+
+	for (INT32 i = 0; i < nStarted; i++) {
+		pthread_join(Thread[i], NULL);
+	}
+#else
+	AuditScanThread(NULL);
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Matching
+
+static char* GetFilename(char* szFull)
+{
+	for (INT32 i = strlen(szFull) - 1; i >= 0; i--) {
+		if (szFull[i] == '\\' || szFull[i] == '/') {
+			return szFull + i + 1;
+		}
+	}
+
+	return szFull;
+}
+
+// Find rom i of the active driver in its archives, crc first, then by name like bzip.cpp does
+static INT32 AuditFindRom(INT32* pArchives, struct BurnRomInfo* pri, INT32 i)
+{
+	struct ZipEntry* pe = NULL;
+
+	if (pri->nCrc) {
+		for (INT32 z = 0; z < BZIP_MAX && pArchives[z] >= 0 && pe == NULL; z++) {
+			struct AuditArchive* pa = &Archive[pArchives[z]];
+
+			for (INT32 j = 0; j < pa->nListCount; j++) {
+				if (pa->List[j].nCrc == pri->nCrc) {
+					pe = &pa->List[j];
+					break;
+				}
+			}
+		}
+	}
+
+	for (INT32 nAka = 0; nAka < 0x10000 && pe == NULL; nAka++) {
+		char* szPossibleName = NULL;
+
+		if (BurnDrvGetRomName(&szPossibleName, i, nAka)) {
+			break;
+		}
+
+		for (INT32 z = 0; z < BZIP_MAX && pArchives[z] >= 0 && pe == NULL; z++) {
+			struct AuditArchive* pa = &Archive[pArchives[z]];
+
+			for (INT32 j = 0; j < pa->nListCount; j++) {
+				if (strcasecmp(szPossibleName, GetFilename(pa->List[j].szName)) == 0) {
+					pe = &pa->List[j];
+					break;
+				}
+			}
+		}
+	}
+
+	if (pe == NULL) {
+		return AUDIT_ROM_MISSING;
+	}
+
+	if (pe->nLen != pri->nLen) {
+		return AUDIT_ROM_BADSIZE;
+	}
+
+	if (pri->nCrc && pe->nCrc != pri->nCrc) {
+		return AUDIT_ROM_BADCRC;
+	}
+
+	return AUDIT_ROM_OK;
+}
+
+static void AuditWriteString(FILE* fp, const char* szString)
+{
+	fputc('\"', fp);
+
+	for (; *szString; szString++) {
+		if (*szString == '\"' || *szString == '\\') {
+			fputc('\\', fp);
+			fputc(*szString, fp);
+		} else if ((UINT8)*szString < 0x20) {
+			fprintf(fp, "\\u%04x", (UINT8)*szString);
+		} else {
+			fputc(*szString, fp);
+		}
+	}
+
+	fputc('\"', fp);
+}
+
+// Audit the active driver and write its entry; returns 0 (good), 1 (bad) or 2 (missing)
+static INT32 AuditWriteSet(FILE* fp, INT32* pArchives)
+{
+	INT32 nStatus = 0;
+	INT32 nRoms = 0;
+
+	fprintf(fp, "\t\t{ \"name\": ");
+	AuditWriteString(fp, BurnDrvGetTextA(DRV_NAME));
+
+	fprintf(fp, ", \"archives\": [");
+	for (INT32 z = 0; z < BZIP_MAX && pArchives[z] >= 0; z++) {
+		struct AuditArchive* pa = &Archive[pArchives[z]];
+
+		fprintf(fp, "%s{ \"name\": ", z ? ", " : " ");
+		AuditWriteString(fp, pa->szName);
+		fprintf(fp, ", \"path\": ");
+		if (pa->szPath) {
+			AuditWriteString(fp, pa->szPath);
+		} else {
+			fprintf(fp, "null");
+		}
+		fprintf(fp, " }");
+	}
+	fprintf(fp, " ],\n\t\t  \"roms\": [");
+
+	for (INT32 i = 0; ; i++) {
+		struct BurnRomInfo ri;
+		char* szName = NULL;
+
+		memset(&ri, 0, sizeof(ri));
+		if (BurnDrvGetRomInfo(&ri, i)) {
+			break;
+		}
+
+		if (ri.nLen == 0 && ri.nCrc == 0) {						// empty entry
+			continue;
+		}
+
+		INT32 nRomStatus = (ri.nType & BRF_NODUMP) ? AUDIT_ROM_NODUMP : AuditFindRom(pArchives, &ri, i);
+
+		if (nRomStatus == AUDIT_ROM_OK || nRomStatus == AUDIT_ROM_NODUMP) {
+			continue;
+		}
+
+		if ((ri.nType & BRF_OPT) == 0) {
+			nStatus = 1;
+		}
+
+		BurnDrvGetRomName(&szName, i, 0);
+
+		fprintf(fp, "%s\n\t\t\t{ \"name\": ", nRoms++ ? "," : "");
+		AuditWriteString(fp, szName ? szName : "");
+		fprintf(fp, ", \"size\": %d, \"crc\": \"%08x\", \"status\": \"%s\", \"optional\": %s }", ri.nLen, ri.nCrc, szRomStatus[nRomStatus], (ri.nType & BRF_OPT) ? "true" : "false");
+	}
+
+	// Bad sets without any archive of their own are just missing
+	if (nStatus && Archive[pArchives[0]].szPath == NULL) {
+		nStatus = 2;
+	}
+
+	fprintf(fp, "%s],\n\t\t  \"status\": \"%s\" }", nRoms ? "\n\t\t  " : " ", nStatus == 0 ? "good" : (nStatus == 1 ? "bad" : "missing"));
+
+	return nStatus;
+}
+
+static void AuditExit()
+{
+	for (INT32 i = 0; i < nArchiveCount; i++) {
+		free(Archive[i].szName);
+		free(Archive[i].szPath);
+		ZipFreeList(Archive[i].List, Archive[i].nListCount);
+	}
+
+	free(Archive);
+	Archive = NULL;
+	nArchiveCount = 0;
+	nArchiveSize = 0;
+
+	free(pDrvArchive);
+	pDrvArchive = NULL;
+}
+
+// Audit every driver, writing the report to szReport. nThreads <= 0 picks one per cpu.
+INT32 AuditRomSets(char* szReport, INT32 nThreads)
+{
+	UINT64 nStartTicks = BurnGetTicks();
+	UINT32 nOldDrvSelect = nBurnDrvActive;
+
+	FILE* fp = fopen(szReport, "wt");
+	if (fp == NULL) {
+		return 1;
+	}
+
+#if defined (AUDIT_THREADED)
+	if (nThreads <= 0) {
+		nThreads = sysconf(_SC_NPROCESSORS_ONLN);
+	}
+#endif
+	if (nThreads < 1) nThreads = 1;
+	if (nThreads > AUDIT_MAX_THREADS) nThreads = AUDIT_MAX_THREADS;
+
+	memset(nArchiveHash, 0xff, sizeof(nArchiveHash));
+
+	pDrvArchive = (INT32*)malloc(nBurnDrvCount * BZIP_MAX * sizeof(INT32));
+	if (pDrvArchive == NULL) {
+		fclose(fp);
+		return 1;
+	}
+
+	// Collect the archives each set needs (its own, the parent's and the board rom)
+	for (UINT32 i = 0; i < nBurnDrvCount; i++) {
+		INT32* pArchives = pDrvArchive + i * BZIP_MAX;
+
+		nBurnDrvActive = i;
+
+		for (INT32 z = 0; z < BZIP_MAX; z++) {
+			char* szName = NULL;
+
+			pArchives[z] = -1;
+			if (BurnDrvGetZipName(&szName, z) == 0) {
+				pArchives[z] = AuditAddArchive(szName);
+			}
+			if (pArchives[z] < 0) {
+				break;
+			}
+		}
+	}
+
+	AuditScanArchives(nThreads);
+
+	INT32 nSetStatus[3] = { 0, 0, 0 };
+	INT32 nArchivesFound = 0;
+
+	fprintf(fp, "{\n\t\"sets\": [\n");
+
+	for (UINT32 i = 0; i < nBurnDrvCount; i++) {
+		nBurnDrvActive = i;
+
+		if (i) {
+			fprintf(fp, ",\n");
+		}
+		nSetStatus[AuditWriteSet(fp, pDrvArchive + i * BZIP_MAX)]++;
+	}
+
+	for (INT32 i = 0; i < nArchiveCount; i++) {
+		if (Archive[i].szPath) {
+			nArchivesFound++;
+		}
+	}
+
+	UINT32 nTime = (UINT32)((BurnGetTicks() - nStartTicks) / 1000);
+
+	fprintf(fp, "\n\t],\n");
+	fprintf(fp, "\t\"summary\": { \"sets\": %d, \"good\": %d, \"bad\": %d, \"missing\": %d, \"archives\": %d, \"archives_found\": %d, \"threads\": %d, \"milliseconds\": %d }\n}\n",
+		nBurnDrvCount, nSetStatus[0], nSetStatus[1], nSetStatus[2], nArchiveCount, nArchivesFound, nThreads, nTime);
+
+	fclose(fp);
+
+	printf("Audited %d sets (%d good, %d bad, %d missing) from %d archives in %d ms\n",
+		nBurnDrvCount, nSetStatus[0], nSetStatus[1], nSetStatus[2], nArchivesFound, nTime);
+
+	AuditExit();
+
+	nBurnDrvActive = nOldDrvSelect;
+
+	return 0;
+}
@@ -199,6 +199,26 @@ INT32 ZipClose();
 INT32 ZipGetList(struct ZipEntry** pList, INT32* pnListCount);
 INT32 ZipLoadFile(UINT8* Dest, INT32 nLen, INT32* pnWrote, INT32 nEntry);
 INT32 __cdecl ZipLoadOneFile(char* arcName, const char* fileName, void** Dest, INT32* pnWrote);
+INT32 ZipReadList(char* szArchive, struct ZipEntry** pList, INT32* pnListCount);
+void ZipFreeList(struct ZipEntry* List, INT32 nListCount);
+
+// audit.cpp
+INT32 AuditRomSets(char* szReport, INT32 nThreads);
+
+// golden.cpp
+INT32 GoldenCheck(char* szList, char* szDir, INT32 nFrames, INT32 nProcs);
+
+// movie.cpp
+#define MOVIE_NONE		(0)
+#define MOVIE_RECORD	(1)
+#define MOVIE_PLAY		(2)
+
+extern INT32 nMovieStatus;
+INT32 MovieRecordStart(char* szFile, INT32 bFromState);
+INT32 MoviePlayStart(char* szFile);
+void MovieFrame();
+void MovieStop();
+INT32 MoviePlayHeadless(char* szFile);
 
 // bzip.cpp
 
@@ -0,0 +1,580 @@
+// Burner golden output checker
+//
+// Runs a list of drivers headless for a number of frames with scripted inputs and hashes
+// the image and sound of every frame. The hashes are checked against the ones stored in
+// the golden directory, or stored there if a driver doesn't have any yet. The first frame
+// that differs is reported and its image is written out as <name>-<frame>-new.png next to
+// the golden file. A <name>.dump file is left as well, so that running the build the
+// golden hashes came from over the same directory writes <name>-<frame>-golden.png to
+// compare it with. Each driver runs in a process of its own, a few at a time, so one
+// that crashes only fails itself.
+
+#include "burner.h"
+#include "burn_trace.h"
+
+#if !defined (_WIN32)
+ #include <unistd.h>
+ #include <sys/wait.h>
+ #define GOLDEN_FORK
+#endif
+
+#define GOLDEN_MAX_PROCS	32
+#define GOLDEN_EXIT_NOPIPE	2			// child couldn't send its result back
+#define GOLDEN_SOUND_RATE	44100
+
+#define GOLDEN_OK			0
+#define GOLDEN_RECORDED		1
+#define GOLDEN_MISMATCH		2
+#define GOLDEN_NOROMS		3
+#define GOLDEN_ERROR		4
+#define GOLDEN_CRASHED		5
+
+static const char* szGoldenStatus[] = { "ok", "recorded", "MISMATCH", "no roms", "error", "CRASHED" };
+
+struct GoldenHash { UINT64 nImage; UINT64 nSound; };
+
+#define GOLDEN_INPUT_NONE	0
+#define GOLDEN_INPUT_COIN	1
+#define GOLDEN_INPUT_START	2
+#define GOLDEN_INPUT_PLAY	3
+
+static UINT8* pGoldenInputKind = NULL;
+static UINT32 nGoldenInputCount = 0;
+
+// FNV-1a, a word at a time
+static UINT64 GoldenHashData(const UINT8* pData, INT32 nLen)
+{
+	UINT64 nHash = 14695981039346656037ULL;
+
+	for (; nLen >= 8; nLen -= 8, pData += 8) {
+		UINT64 n;
+		memcpy(&n, pData, 8);
+		nHash = (nHash ^ n) * 1099511628211ULL;
+	}
+	for (; nLen > 0; nLen--) {
+		nHash = (nHash ^ *pData++) * 1099511628211ULL;
+	}
+
+	return nHash;
+}
+
+// ---------------------------------------------------------------------------
+// Scripted inputs: two coins, a start, then every play input is pressed or released at
+// random every few frames. The sequence only depends on the frame and input number.
+
+static void GoldenInputInit()
+{
+	struct BurnInputInfo bii;
+
+	for (nGoldenInputCount = 0; BurnDrvGetInputInfo(&bii, nGoldenInputCount) == 0; nGoldenInputCount++) {}
+
+	pGoldenInputKind = (UINT8*)malloc(nGoldenInputCount + 1);
+	if (pGoldenInputKind == NULL) {
+		nGoldenInputCount = 0;
+		return;
+	}
+
+	for (UINT32 i = 0; i < nGoldenInputCount; i++) {
+		BurnDrvGetInputInfo(&bii, i);
+
+		pGoldenInputKind[i] = GOLDEN_INPUT_NONE;
+
+		if (bii.nType != BIT_DIGITAL || bii.szInfo == NULL) {
+			continue;
+		}
+		if (strstr(bii.szInfo, "coin")) {
+			pGoldenInputKind[i] = GOLDEN_INPUT_COIN;
+		} else if (strstr(bii.szInfo, "start")) {
+			pGoldenInputKind[i] = GOLDEN_INPUT_START;
+		} else if (bii.szInfo[0] == 'p' && bii.szInfo[1] >= '1' && bii.szInfo[1] <= '4' && bii.szInfo[2] == ' ') {
+			pGoldenInputKind[i] = GOLDEN_INPUT_PLAY;
+		}
+	}
+
+	// Dip switches start at their defaults
+	struct BurnDIPInfo bdi;
+	INT32 nOffset = 0;
+
+	for (INT32 i = 0; BurnDrvGetDIPInfo(&bdi, i) == 0; i++) {
+		if (bdi.nFlags == 0xF0) {
+			nOffset = bdi.nInput;
+		}
+		if (bdi.nFlags == 0xFF && BurnDrvGetInputInfo(&bii, bdi.nInput + nOffset) == 0 && bii.pVal) {
+			*bii.pVal = (*bii.pVal & ~bdi.nMask) | (bdi.nSetting & bdi.nMask);
+		}
+	}
+}
+
+static void GoldenInputExit()
+{
+	free(pGoldenInputKind);
+	pGoldenInputKind = NULL;
+	nGoldenInputCount = 0;
+}
+
+static void GoldenInputFrame(INT32 nFrame)
+{
+	struct BurnInputInfo bii;
+
+	for (UINT32 i = 0; i < nGoldenInputCount; i++) {
+		INT32 nState = 0;
+
+		switch (pGoldenInputKind[i]) {
+			case GOLDEN_INPUT_NONE:
+				continue;
+			case GOLDEN_INPUT_COIN:
+				nState = (nFrame >= 60 && nFrame < 66) || (nFrame >= 90 && nFrame < 96);
+				break;
+			case GOLDEN_INPUT_START:
+				nState = (nFrame >= 150 && nFrame < 156);
+				break;
+			case GOLDEN_INPUT_PLAY: {
+				UINT32 n = ((nFrame >> 3) * 2654435761U) ^ (i * 40503U);
+				n = (n ^ (n >> 15)) * 2246822519U;
+				nState = (nFrame >= 180) && ((n >> 13) & 3) == 0;
+				break;
+			}
+		}
+
+		if (BurnDrvGetInputInfo(&bii, i) == 0 && bii.pVal) {
+			*bii.pVal = nState;
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------
+
+static INT32 GoldenWritePng(const char* szFile, UINT8* pImage, INT32 nWidth, INT32 nHeight, INT32 nPitch, INT32 nBpp)
+{
+	FILE* fp = fopen(szFile, "wb");
+	if (fp == NULL) {
+		return 1;
+	}
+
+	UINT8* pRow = (UINT8*)malloc(nWidth * 3);
+	png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+	png_infop info_ptr = png_ptr ? png_create_info_struct(png_ptr) : NULL;
+
+	if (pRow == NULL || info_ptr == NULL || setjmp(png_jmpbuf(png_ptr))) {
+		png_destroy_write_struct(&png_ptr, info_ptr ? &info_ptr : NULL);
+		free(pRow);
+		fclose(fp);
+		return 1;
+	}
+
+	png_init_io(png_ptr, fp);
+	png_set_IHDR(png_ptr, info_ptr, nWidth, nHeight, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	png_write_info(png_ptr, info_ptr);
+
+	for (INT32 y = 0; y < nHeight; y++) {
+		UINT8* ps = pImage + y * nPitch;
+
+		for (INT32 x = 0; x < nWidth; x++) {
+			UINT32 c;
+
+			if (nBpp == 2) {
+				c = ((UINT16*)ps)[x];
+				pRow[x * 3 + 0] = ((c >> 11) << 3) | (c >> 13);
+				pRow[x * 3 + 1] = (((c >> 5) & 0x3f) << 2) | ((c >> 9) & 3);
+				pRow[x * 3 + 2] = ((c & 0x1f) << 3) | ((c >> 2) & 7);
+			} else {
+				c = ((UINT32*)ps)[x];
+				pRow[x * 3 + 0] = c >> 16;
+				pRow[x * 3 + 1] = c >> 8;
+				pRow[x * 3 + 2] = c;
+			}
+		}
+
+		png_write_row(png_ptr, pRow);
+	}
+
+	png_write_end(png_ptr, info_ptr);
+	png_destroy_write_struct(&png_ptr, &info_ptr);
+
+	free(pRow);
+	fclose(fp);
+
+	return 0;
+}
+
+static INT32 GoldenLoad(const char* szFile, struct GoldenHash* pHash, INT32 nFrames)
+{
+	FILE* fp = fopen(szFile, "rt");
+	if (fp == NULL) {
+		return -1;
+	}
+
+	char szLine[128];
+	INT32 nCount = 0;
+
+	while (nCount < nFrames && fgets(szLine, sizeof(szLine), fp)) {
+		unsigned long long nImage, nSound;
+		INT32 nFrame;
+
+		if (szLine[0] == '#') {
+			continue;
+		}
+		if (sscanf(szLine, "%d %llx %llx", &nFrame, &nImage, &nSound) != 3 || nFrame != nCount) {
+			break;
+		}
+
+		pHash[nCount].nImage = nImage;
+		pHash[nCount].nSound = nSound;
+		nCount++;
+	}
+
+	fclose(fp);
+
+	return nCount;
+}
+
+static INT32 GoldenSave(const char* szFile, struct GoldenHash* pHash, INT32 nFrames, INT32 nWidth, INT32 nHeight)
+{
+	FILE* fp = fopen(szFile, "wt");
+	if (fp == NULL) {
+		return 1;
+	}
+
+	fprintf(fp, "# %s, %d frames, %dx%d, sound %d Hz\n", BurnDrvGetTextA(DRV_NAME), nFrames, nWidth, nHeight, GOLDEN_SOUND_RATE);
+	for (INT32 i = 0; i < nFrames; i++) {
+		fprintf(fp, "%d %016llx %016llx\n", i, (unsigned long long)pHash[i].nImage, (unsigned long long)pHash[i].nSound);
+	}
+
+	fclose(fp);
+
+	return 0;
+}
+
+// Run the active driver. pnFrame gets the first frame that differs, or the frames run.
+static INT32 GoldenRunDriver(const char* szDir, INT32 nFrames, INT32* pnFrame)
+{
+	char szFile[MAX_PATH];
+	INT32 nWidth, nHeight;
+	INT32 nStatus = GOLDEN_OK;
+
+	*pnFrame = 0;
+
+	snprintf(szFile, MAX_PATH, "%s/%s.golden", szDir, BurnDrvGetTextA(DRV_NAME));
+
+	struct GoldenHash* pGolden = (struct GoldenHash*)malloc(nFrames * sizeof(struct GoldenHash));
+	struct GoldenHash* pHash = (struct GoldenHash*)malloc(nFrames * sizeof(struct GoldenHash));
+	if (pGolden == NULL || pHash == NULL) {
+		free(pGolden);
+		free(pHash);
+		return GOLDEN_ERROR;
+	}
+
+	INT32 nGoldenFrames = GoldenLoad(szFile, pGolden, nFrames);
+
+	// A frame a newer build got wrong, wanted as this build draws it
+	char szDump[MAX_PATH];
+	INT32 nDumpFrame = -1;
+
+	snprintf(szDump, MAX_PATH, "%s/%s.dump", szDir, BurnDrvGetTextA(DRV_NAME));
+	FILE* fp = fopen(szDump, "rt");
+	if (fp) {
+		if (fscanf(fp, "%d", &nDumpFrame) != 1) {
+			nDumpFrame = -1;
+		}
+		fclose(fp);
+	}
+
+	BurnDrvGetFullSize(&nWidth, &nHeight);
+	nBurnBpp = (BurnDrvGetFlags() & BDF_16BIT_ONLY) ? 2 : 4;
+	nBurnPitch = nWidth * nBurnBpp;
+	nBurnLayer = 0xFF;
+
+	bDrvOkay = 1;
+	SetBurnHighCol(nBurnBpp == 2 ? 16 : 32);
+
+	nBurnSoundRate = GOLDEN_SOUND_RATE;
+	nBurnSoundLen = (GOLDEN_SOUND_RATE * 100 + 3000) / 6000;
+	nBurnDrvSelect[0] = nBurnDrvActive;
+
+	BzipOpen(false);
+	INT32 nRet = BurnDrvInit();
+	BzipClose();
+
+	if (nRet) {
+		BurnDrvExit();
+		bDrvOkay = 0;
+		free(pGolden);
+		free(pHash);
+		return GOLDEN_NOROMS;
+	}
+
+	nBurnSoundLen = (GOLDEN_SOUND_RATE * 100 + (nBurnFPS >> 1)) / nBurnFPS;
+
+	UINT8* pImage = (UINT8*)calloc(nBurnPitch * nHeight, 1);
+	INT16* pSound = (INT16*)calloc(nBurnSoundLen * 2, sizeof(INT16));
+
+	if (pImage && pSound) {
+		GoldenInputInit();
+
+		for (INT32 i = 0; i < nFrames; i++) {
+#if defined (BURN_TRACE)
+			BurnTraceFrame();
+#endif
+			BURN_TRACE_SCOPE("RunFrame", "frame");
+
+			GoldenInputFrame(i);
+
+			pBurnDraw = pImage;
+			pBurnSoundOut = pSound;
+			BurnDrvFrame();
+
+			pHash[i].nImage = GoldenHashData(pImage, nBurnPitch * nHeight);
+			pHash[i].nSound = GoldenHashData((UINT8*)pSound, nBurnSoundLen * 2 * sizeof(INT16));
+
+			char szPng[MAX_PATH];
+
+			if (i < nGoldenFrames && (pHash[i].nImage != pGolden[i].nImage || pHash[i].nSound != pGolden[i].nSound)) {
+				snprintf(szPng, MAX_PATH, "%s/%s-%d-new.png", szDir, BurnDrvGetTextA(DRV_NAME), i);
+				GoldenWritePng(szPng, pImage, nWidth, nHeight, nBurnPitch, nBurnBpp);
+
+				fp = fopen(szDump, "wt");
+				if (fp) {
+					fprintf(fp, "%d\n", i);
+					fclose(fp);
+				}
+
+				*pnFrame = i;
+				nStatus = GOLDEN_MISMATCH;
+				break;
+			}
+
+			if (i == nDumpFrame) {
+				snprintf(szPng, MAX_PATH, "%s/%s-%d-golden.png", szDir, BurnDrvGetTextA(DRV_NAME), i);
+				GoldenWritePng(szPng, pImage, nWidth, nHeight, nBurnPitch, nBurnBpp);
+				remove(szDump);
+			}
+
+			*pnFrame = i + 1;
+		}
+
+		GoldenInputExit();
+
+		// Anything past the end of the golden file (or no file at all) gets recorded
+		if (nStatus == GOLDEN_OK && nGoldenFrames < nFrames) {
+			nStatus = GoldenSave(szFile, pHash, nFrames, nWidth, nHeight) ? GOLDEN_ERROR : GOLDEN_RECORDED;
+		}
+	} else {
+		nStatus = GOLDEN_ERROR;
+	}
+
+	pBurnDraw = NULL;
+	pBurnSoundOut = NULL;
+
+#if defined (BURN_TRACE)
+	// Write this driver's trace while its name is still known. Each forked
+	// driver has its own copy of the trace; without fork only the first is traced.
+	BurnTraceStop();
+#endif
+
+	BurnDrvExit();
+	bDrvOkay = 0;
+
+	free(pImage);
+	free(pSound);
+	free(pGolden);
+	free(pHash);
+
+	return nStatus;
+}
+
+// ---------------------------------------------------------------------------
+
+static INT32 GoldenReadList(const char* szList, INT32* pDrivers)
+{
+	INT32 nCount = 0;
+
+	if (strcmp(szList, "all") == 0) {
+		for (UINT32 i = 0; i < nBurnDrvCount; i++) {
+			pDrivers[nCount++] = i;
+		}
+		return nCount;
+	}
+
+	FILE* fp = fopen(szList, "rt");
+	if (fp == NULL) {
+		return -1;
+	}
+
+	char szLine[256];
+	while (fgets(szLine, sizeof(szLine), fp)) {
+		char* s = szLine;
+		while (*s == ' ' || *s == '\t') s++;
+
+		INT32 nLen = strcspn(s, " \t\r\n#");
+		if (nLen == 0) {
+			continue;
+		}
+		s[nLen] = 0;
+
+		UINT32 i;
+		for (i = 0; i < nBurnDrvCount; i++) {
+			nBurnDrvActive = i;
+			if (strcmp(BurnDrvGetTextA(DRV_NAME), s) == 0) {
+				pDrivers[nCount++] = i;
+				break;
+			}
+		}
+		if (i == nBurnDrvCount) {
+			fprintf(stderr, "Golden: %s is not a driver, skipped\n", s);
+		}
+	}
+
+	fclose(fp);
+
+	return nCount;
+}
+
+static void GoldenReport(INT32 nDriver, INT32 nStatus, INT32 nFrame, UINT32 nTime, INT32* pnStatusCount)
+{
+	nBurnDrvActive = nDriver;
+
+	if (nStatus == GOLDEN_MISMATCH) {
+		printf("%-16s %-9s at frame %d\n", BurnDrvGetTextA(DRV_NAME), szGoldenStatus[nStatus], nFrame);
+	} else if (nStatus == GOLDEN_OK || nStatus == GOLDEN_RECORDED) {
+		printf("%-16s %-9s %d frames in %d ms\n", BurnDrvGetTextA(DRV_NAME), szGoldenStatus[nStatus], nFrame, nTime);
+	} else {
+		printf("%-16s %s\n", BurnDrvGetTextA(DRV_NAME), szGoldenStatus[nStatus]);
+	}
+	fflush(stdout);
+
+	pnStatusCount[nStatus]++;
+}
+
+// Check (or record) szList ("all" or a file of driver names) for nFrames each, against the
+// golden files in szDir. nProcs <= 0 picks one process per cpu. Returns 1 if anything
+// didn't match or crashed.
+INT32 GoldenCheck(char* szList, char* szDir, INT32 nFrames, INT32 nProcs)
+{
+	UINT64 nStartTicks = BurnGetTicks();
+	UINT32 nOldDrvSelect = nBurnDrvActive;
+	INT32 nStatusCount[6] = { 0, 0, 0, 0, 0, 0 };
+
+	if (nFrames <= 0) {
+		return 1;
+	}
+
+	INT32* pDrivers = (INT32*)malloc(nBurnDrvCount * sizeof(INT32));
+	if (pDrivers == NULL) {
+		return 1;
+	}
+
+	INT32 nDrivers = GoldenReadList(szList, pDrivers);
+	if (nDrivers < 0) {
+		fprintf(stderr, "Golden: can't read %s\n", szList);
+		free(pDrivers);
+		return 1;
+	}
+
+	bBurnUseASMCPUEmulation = 0;
+
+#if defined (GOLDEN_FORK)
+	if (nProcs <= 0) {
+		nProcs = sysconf(_SC_NPROCESSORS_ONLN);
+	}
+	if (nProcs < 1) nProcs = 1;
+	if (nProcs > GOLDEN_MAX_PROCS) nProcs = GOLDEN_MAX_PROCS;
+
+	// One process per driver, the result comes back through a pipe
+	struct { pid_t nPid; INT32 nDriver; INT32 nFd; UINT64 nTicks; } Proc[GOLDEN_MAX_PROCS];
+	INT32 nRunning = 0;
+	INT32 nNext = 0;
+
+	fflush(stdout);
+	fflush(stderr);
+
+	while (nNext < nDrivers || nRunning) {
+		if (nNext < nDrivers && nRunning < nProcs) {
+			INT32 fd[2];
+			if (pipe(fd)) {
+				break;
+			}
+
+			pid_t nPid = fork();
+			if (nPid == 0) {
+				INT32 nFrame;
+
+				close(fd[0]);
+				nBurnDrvActive = pDrivers[nNext];
+
+				INT32 nResult[2];
+				nResult[0] = GoldenRunDriver(szDir, nFrames, &nFrame);
+				nResult[1] = nFrame;
+				if (write(fd[1], nResult, sizeof(nResult)) != sizeof(nResult)) {
+					_exit(GOLDEN_EXIT_NOPIPE);
+				}
+
+				_exit(0);
+			}
+
+			close(fd[1]);
+			if (nPid < 0) {
+				close(fd[0]);
+				break;
+			}
+
+			Proc[nRunning].nPid = nPid;
+			Proc[nRunning].nDriver = pDrivers[nNext];
+			Proc[nRunning].nFd = fd[0];
+			Proc[nRunning].nTicks = BurnGetTicks();
+			nRunning++;
+			nNext++;
+			continue;
+		}
+
+		INT32 nWait;
+		pid_t nPid = wait(&nWait);
+		if (nPid < 0) {
+			break;
+		}
+
+		for (INT32 i = 0; i < nRunning; i++) {
+			if (Proc[i].nPid != nPid) {
+				continue;
+			}
+
+			INT32 nResult[2] = { GOLDEN_CRASHED, 0 };
+			if (!WIFEXITED(nWait)) {
+				nResult[0] = GOLDEN_CRASHED;
+			} else if (WEXITSTATUS(nWait) != 0) {
+				fprintf(stderr, "Golden: driver process exited with %d\n", WEXITSTATUS(nWait));
+				nResult[0] = GOLDEN_ERROR;
+			} else if (read(Proc[i].nFd, nResult, sizeof(nResult)) != sizeof(nResult) || nResult[0] < GOLDEN_OK || nResult[0] > GOLDEN_CRASHED) {
+				nResult[0] = GOLDEN_CRASHED;
+			}
+			close(Proc[i].nFd);
+
+			GoldenReport(Proc[i].nDriver, nResult[0], nResult[1], (UINT32)((BurnGetTicks() - Proc[i].nTicks) / 1000), nStatusCount);
+
+			Proc[i] = Proc[--nRunning];
+			break;
+		}
+	}
+#else
+	nProcs = 1;
+
+	for (INT32 i = 0; i < nDrivers; i++) {
+		INT32 nFrame;
+		UINT64 nTicks = BurnGetTicks();
+
+		nBurnDrvActive = pDrivers[i];
+		INT32 nStatus = GoldenRunDriver(szDir, nFrames, &nFrame);
+
+		GoldenReport(pDrivers[i], nStatus, nFrame, (UINT32)((BurnGetTicks() - nTicks) / 1000), nStatusCount);
+	}
+#endif
+
+	printf("Golden: %d drivers, %d ok, %d recorded, %d mismatched, %d crashed, %d without roms, %d errors, %d processes, %d ms\n",
+		nDrivers, nStatusCount[GOLDEN_OK], nStatusCount[GOLDEN_RECORDED], nStatusCount[GOLDEN_MISMATCH], nStatusCount[GOLDEN_CRASHED],
+		nStatusCount[GOLDEN_NOROMS], nStatusCount[GOLDEN_ERROR], nProcs, (UINT32)((BurnGetTicks() - nStartTicks) / 1000));
+
+	free(pDrivers);
+
+	nBurnDrvActive = nOldDrvSelect;
+
+	return (nStatusCount[GOLDEN_MISMATCH] || nStatusCount[GOLDEN_CRASHED]) ? 1 : 0;
+}
@@ -0,0 +1,492 @@
+// Burner input movies
+//
+// A movie holds the values every driver input (dip switches included) had on every
+// frame, from either power-on or an embedded savestate. A hash of the machine state is
+// stored every few frames so playback can tell when it has drifted from the recording.
+// Inputs are taken from, and put back into, the driver's own input variables after
+// InputMake(), so playback doesn't depend on the front end's input mapping.
+//
+// File layout (little endian):
+//   "FBM1", version, driver name[32], flags, sound rate, input count, bytes per frame,
+//   hash interval, frame count, offset of the frame data, [savestate chunk], frames.
+// Each frame is its input values (one byte, or two for analog inputs), followed by an
+// 8 byte state hash when the frame number is a multiple of the hash interval.
+
+#include "burner.h"
+#include "burn_trace.h"
+
+#define MOVIE_VERSION			1
+#define MOVIE_FLAG_FROM_STATE	1
+#define MOVIE_HASH_INTERVAL		60
+
+#define MOVIE_HEADER_SIZE		(4 + 4 + 32 + 4 * 7)
+
+INT32 nMovieStatus = MOVIE_NONE;
+
+static FILE* MovieFile = NULL;
+static char szMovieFile[MAX_PATH];
+
+static INT32 nMovieInputCount = 0;
+static INT32 nMovieFrameBytes = 0;
+static INT32 nMovieHashInterval = MOVIE_HASH_INTERVAL;
+static INT32 nMovieFrames = 0;				// frames in the movie (playback) or recorded so far
+static INT32 nMovieFrame = 0;				// next frame to record or play
+static INT32 nMovieDataOffset = 0;
+static INT32 nMovieDesyncs = 0;
+
+static UINT8* pMovieData = NULL;			// all the frame data when playing back, one frame when recording
+static INT32 nMovieDataLen = 0;
+
+// ---------------------------------------------------------------------------
+// State hash
+
+static UINT64 nMovieHash;
+
+static INT32 __cdecl MovieHashAcb(struct BurnArea* pba)
+{
+	UINT8* pData = (UINT8*)pba->Data;
+
+	for (UINT32 i = 0; i < pba->nLen; i++) {
+		nMovieHash = (nMovieHash ^ pData[i]) * 1099511628211ULL;
+	}
+
+	return 0;
+}
+
+static UINT64 MovieStateHash()
+{
+	INT32 (__cdecl *pOldAcb)(struct BurnArea* pba) = BurnAcb;
+
+	nMovieHash = 14695981039346656037ULL;
+
+	BurnAcb = MovieHashAcb;
+	BurnAreaScan(ACB_FULLSCAN | ACB_READ, NULL);
+	BurnAcb = pOldAcb;
+
+	return nMovieHash;
+}
+
+// ---------------------------------------------------------------------------
+
+static INT32 MovieFrameBytes(INT32* pnInputCount)
+{
+	struct BurnInputInfo bii;
+	INT32 nBytes = 0;
+	INT32 i;
+
+	for (i = 0; BurnDrvGetInputInfo(&bii, i) == 0; i++) {
+		nBytes += (bii.nType & BIT_GROUP_ANALOG) ? 2 : 1;
+	}
+
+	*pnInputCount = i;
+
+	return nBytes;
+}
+
+static void MovieGetInputs(UINT8* pDest)
+{
+	struct BurnInputInfo bii;
+
+	for (INT32 i = 0; i < nMovieInputCount; i++) {
+		BurnDrvGetInputInfo(&bii, i);
+
+		if (bii.nType & BIT_GROUP_ANALOG) {
+			UINT16 n = bii.pShortVal ? *bii.pShortVal : 0;
+			*pDest++ = n & 0xff;
+			*pDest++ = n >> 8;
+		} else {
+			*pDest++ = bii.pVal ? *bii.pVal : 0;
+		}
+	}
+}
+
+static void MovieSetInputs(UINT8* pSrc)
+{
+	struct BurnInputInfo bii;
+
+	for (INT32 i = 0; i < nMovieInputCount; i++) {
+		BurnDrvGetInputInfo(&bii, i);
+
+		if (bii.nType & BIT_GROUP_ANALOG) {
+			if (bii.pShortVal) {
+				*bii.pShortVal = pSrc[0] | (pSrc[1] << 8);
+			}
+			pSrc += 2;
+		} else {
+			if (bii.pVal) {
+				*bii.pVal = *pSrc;
+			}
+			pSrc++;
+		}
+	}
+}
+
+static void MovieWriteInt(INT32 n)
+{
+	UINT8 b[4] = { (UINT8)n, (UINT8)(n >> 8), (UINT8)(n >> 16), (UINT8)(n >> 24) };
+	fwrite(b, 1, 4, MovieFile);
+}
+
+// Returns 1 if the file ends first
+static INT32 MovieReadInt(FILE* fp, INT32* pnValue)
+{
+	UINT8 b[4];
+
+	if (fread(b, 1, 4, fp) != 4) {
+		return 1;
+	}
+
+	*pnValue = b[0] | (b[1] << 8) | (b[2] << 16) | (b[3] << 24);
+
+	return 0;
+}
+
+// ---------------------------------------------------------------------------
+
+// Start recording the running driver. With bFromState the current machine state is stored
+// in the movie, otherwise the movie starts from power-on, so call this straight after
+// the driver is initialised (and before any nvram is loaded).
+INT32 MovieRecordStart(char* szFile, INT32 bFromState)
+{
+	char szDriver[32];
+
+	MovieStop();
+
+	MovieFile = fopen(szFile, "w+b");
+	if (MovieFile == NULL) {
+		fprintf(stderr, "Movie: can't create %s\n", szFile);
+		return 1;
+	}
+
+	strncpy(szMovieFile, szFile, MAX_PATH - 1);
+	szMovieFile[MAX_PATH - 1] = 0;
+
+	nMovieFrameBytes = MovieFrameBytes(&nMovieInputCount);
+	nMovieHashInterval = MOVIE_HASH_INTERVAL;
+
+	pMovieData = (UINT8*)malloc(nMovieFrameBytes + 1);
+	if (pMovieData == NULL) {
+		MovieStop();
+		return 1;
+	}
+	nMovieFrames = 0;
+	nMovieFrame = 0;
+
+	memset(szDriver, 0, sizeof(szDriver));
+	strncpy(szDriver, BurnDrvGetTextA(DRV_NAME), sizeof(szDriver) - 1);
+
+	fwrite("FBM1", 1, 4, MovieFile);
+	MovieWriteInt(MOVIE_VERSION);
+	fwrite(szDriver, 1, 32, MovieFile);
+	MovieWriteInt(bFromState ? MOVIE_FLAG_FROM_STATE : 0);
+	MovieWriteInt(nBurnSoundRate);
+	MovieWriteInt(nMovieInputCount);
+	MovieWriteInt(nMovieFrameBytes);
+	MovieWriteInt(nMovieHashInterval);
+	MovieWriteInt(0);									// frame count, filled in by MovieStop()
+	MovieWriteInt(0);									// frame data offset
+
+	if (bFromState) {
+		if (BurnStateSaveEmbed(MovieFile, -1, 1) < 0) {
+			fprintf(stderr, "Movie: can't store the starting state\n");
+			MovieStop();
+			return 1;
+		}
+	}
+
+	nMovieDataOffset = ftell(MovieFile);
+	fseek(MovieFile, MOVIE_HEADER_SIZE - 4, SEEK_SET);
+	MovieWriteInt(nMovieDataOffset);
+	fseek(MovieFile, nMovieDataOffset, SEEK_SET);
+
+	nMovieStatus = MOVIE_RECORD;
+
+	printf("Movie: recording %s from %s\n", szFile, bFromState ? "a savestate" : "power-on");
+
+	return 0;
+}
+
+// Start playing back a movie of the running driver, straight after it is initialised
+INT32 MoviePlayStart(char* szFile)
+{
+	char szDriver[33];
+	char szMagic[4];
+	INT32 nVersion, nFlags, nSoundRate, nInputCount, nFrameBytes;
+
+	MovieStop();
+
+	MovieFile = fopen(szFile, "rb");
+	if (MovieFile == NULL) {
+		fprintf(stderr, "Movie: can't open %s\n", szFile);
+		return 1;
+	}
+
+	strncpy(szMovieFile, szFile, MAX_PATH - 1);
+	szMovieFile[MAX_PATH - 1] = 0;
+
+	memset(szDriver, 0, sizeof(szDriver));
+
+	if (fread(szMagic, 1, 4, MovieFile) != 4 || memcmp(szMagic, "FBM1", 4) || MovieReadInt(MovieFile, &nVersion) || nVersion != MOVIE_VERSION) {
+		fprintf(stderr, "Movie: %s isn't a movie\n", szFile);
+		MovieStop();
+		return 1;
+	}
+
+	if (fread(szDriver, 1, 32, MovieFile) != 32
+	 || MovieReadInt(MovieFile, &nFlags) || MovieReadInt(MovieFile, &nSoundRate) || MovieReadInt(MovieFile, &nInputCount) || MovieReadInt(MovieFile, &nFrameBytes)
+	 || MovieReadInt(MovieFile, &nMovieHashInterval) || MovieReadInt(MovieFile, &nMovieFrames) || MovieReadInt(MovieFile, &nMovieDataOffset)) {
+		fprintf(stderr, "Movie: %s is cut short\n", szFile);
+		MovieStop();
+		return 1;
+	}
+
+	nMovieFrameBytes = MovieFrameBytes(&nMovieInputCount);
+
+	if (strcmp(szDriver, BurnDrvGetTextA(DRV_NAME)) || nInputCount != nMovieInputCount || nFrameBytes != nMovieFrameBytes || nMovieHashInterval <= 0) {
+		fprintf(stderr, "Movie: %s was recorded with %s, not %s\n", szFile, szDriver, BurnDrvGetTextA(DRV_NAME));
+		MovieStop();
+		return 1;
+	}
+
+	if (nSoundRate != nBurnSoundRate) {
+		fprintf(stderr, "Movie: recorded with sound at %d Hz, playing at %d Hz, it may not play back the same\n", nSoundRate, nBurnSoundRate);
+	}
+
+	// Every frame's inputs, plus a hash every nMovieHashInterval frames. The header can't
+	// be trusted, so the frame data must fit in the file before anything is allocated.
+	fseek(MovieFile, 0, SEEK_END);
+	INT64 nFileLen = ftell(MovieFile);
+	INT64 nDataLen = (INT64)nMovieFrames * nMovieFrameBytes + (((INT64)nMovieFrames + nMovieHashInterval - 1) / nMovieHashInterval) * 8;
+
+	if (nMovieFrames < 0 || nMovieDataOffset < MOVIE_HEADER_SIZE || nDataLen >= 0x7fffffff || nMovieDataOffset + nDataLen > nFileLen) {
+		fprintf(stderr, "Movie: %s is damaged or cut short\n", szFile);
+		MovieStop();
+		return 1;
+	}
+
+	fseek(MovieFile, MOVIE_HEADER_SIZE, SEEK_SET);
+
+	nMovieDataLen = (INT32)nDataLen;
+	pMovieData = (UINT8*)malloc(nMovieDataLen + 1);
+	if (pMovieData == NULL) {
+		MovieStop();
+		return 1;
+	}
+
+	if (nFlags & MOVIE_FLAG_FROM_STATE) {
+		if (BurnStateLoadEmbed(MovieFile, -1, 1, NULL)) {
+			fprintf(stderr, "Movie: can't load the starting state\n");
+			MovieStop();
+			return 1;
+		}
+		BurnRecalcPal();
+	}
+
+	fseek(MovieFile, nMovieDataOffset, SEEK_SET);
+	if ((INT32)fread(pMovieData, 1, nMovieDataLen, MovieFile) != nMovieDataLen) {
+		fprintf(stderr, "Movie: %s is cut short\n", szFile);
+		MovieStop();
+		return 1;
+	}
+
+	fclose(MovieFile);
+	MovieFile = NULL;
+
+	nMovieFrame = 0;
+	nMovieDesyncs = 0;
+	nMovieStatus = MOVIE_PLAY;
+
+	printf("Movie: playing %s, %d frames from %s\n", szFile, nMovieFrames, (nFlags & MOVIE_FLAG_FROM_STATE) ? "a savestate" : "power-on");
+
+	return 0;
+}
+
+// Call once a frame, after InputMake() and before the frame is run
+void MovieFrame()
+{
+	if (nMovieStatus == MOVIE_RECORD) {
+		MovieGetInputs(pMovieData);
+		fwrite(pMovieData, 1, nMovieFrameBytes, MovieFile);
+
+		if (nMovieFrame % nMovieHashInterval == 0) {
+			UINT64 nHash = MovieStateHash();
+			for (INT32 i = 0; i < 8; i++) {
+				fputc((UINT8)(nHash >> (i * 8)), MovieFile);
+			}
+		}
+
+		nMovieFrame++;
+		nMovieFrames = nMovieFrame;
+		return;
+	}
+
+	if (nMovieStatus == MOVIE_PLAY) {
+		if (nMovieFrame >= nMovieFrames) {
+			MovieStop();
+			return;
+		}
+
+		// Position of this frame in the data
+		INT32 nPos = nMovieFrame * nMovieFrameBytes + ((nMovieFrame + nMovieHashInterval - 1) / nMovieHashInterval) * 8;
+
+		MovieSetInputs(pMovieData + nPos);
+
+		if (nMovieFrame % nMovieHashInterval == 0) {
+			UINT64 nHash = 0;
+			for (INT32 i = 0; i < 8; i++) {
+				nHash |= (UINT64)pMovieData[nPos + nMovieFrameBytes + i] << (i * 8);
+			}
+
+			if (MovieStateHash() != nHash) {
+				if (nMovieDesyncs == 0) {
+					fprintf(stderr, "Movie: desync at frame %d\n", nMovieFrame);
+				}
+				nMovieDesyncs++;
+			}
+		}
+
+		nMovieFrame++;
+	}
+}
+
+void MovieStop()
+{
+	if (nMovieStatus == MOVIE_RECORD && MovieFile) {
+		fseek(MovieFile, MOVIE_HEADER_SIZE - 8, SEEK_SET);
+		MovieWriteInt(nMovieFrames);
+
+		printf("Movie: recorded %d frames to %s\n", nMovieFrames, szMovieFile);
+	}
+
+	if (nMovieStatus == MOVIE_PLAY) {
+		if (nMovieDesyncs) {
+			printf("Movie: played %d frames, %d of %d state checks didn't match\n", nMovieFrame, nMovieDesyncs, (nMovieFrame + nMovieHashInterval - 1) / nMovieHashInterval);
+		} else {
+			printf("Movie: played %d frames in sync\n", nMovieFrame);
+		}
+	}
+
+	if (MovieFile) {
+		fclose(MovieFile);
+		MovieFile = NULL;
+	}
+
+	free(pMovieData);
+	pMovieData = NULL;
+	nMovieDataLen = 0;
+
+	nMovieStatus = MOVIE_NONE;
+}
+
+// ---------------------------------------------------------------------------
+
+// Play a movie through with no front end, drawing and rendering sound into memory.
+// Returns 1 if it couldn't be played or went out of sync.
+INT32 MoviePlayHeadless(char* szFile)
+{
+	char szDriver[33];
+	char szMagic[4];
+	INT32 nSoundRate;
+
+	// Find out which driver the movie needs
+	FILE* fp = fopen(szFile, "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "Movie: can't open %s\n", szFile);
+		return 1;
+	}
+
+	memset(szDriver, 0, sizeof(szDriver));
+	INT32 nBad = fread(szMagic, 1, 4, fp) != 4 || memcmp(szMagic, "FBM1", 4);
+	fseek(fp, 8, SEEK_SET);
+	nBad |= fread(szDriver, 1, 32, fp) != 32;
+	fseek(fp, 4 + 4 + 32 + 4, SEEK_SET);
+	nBad |= MovieReadInt(fp, &nSoundRate) || nSoundRate < 0 || nSoundRate > 192000;
+	fclose(fp);
+
+	if (nBad) {
+		fprintf(stderr, "Movie: %s isn't a movie\n", szFile);
+		return 1;
+	}
+
+	UINT32 i;
+	for (i = 0; i < nBurnDrvCount; i++) {
+		nBurnDrvActive = i;
+		if (strcmp(BurnDrvGetTextA(DRV_NAME), szDriver) == 0) {
+			break;
+		}
+	}
+	if (i == nBurnDrvCount) {
+		fprintf(stderr, "Movie: %s needs %s, which isn't a driver\n", szFile, szDriver);
+		return 1;
+	}
+
+	INT32 nWidth, nHeight;
+
+	BurnDrvGetFullSize(&nWidth, &nHeight);
+	nBurnBpp = (BurnDrvGetFlags() & BDF_16BIT_ONLY) ? 2 : 4;
+	nBurnPitch = nWidth * nBurnBpp;
+	nBurnLayer = 0xFF;
+	bBurnUseASMCPUEmulation = 0;
+
+	bDrvOkay = 1;
+	SetBurnHighCol(nBurnBpp == 2 ? 16 : 32);
+
+	nBurnSoundRate = nSoundRate;
+	nBurnSoundLen = (nSoundRate * 100 + 3000) / 6000;
+	nBurnDrvSelect[0] = nBurnDrvActive;
+
+	BzipOpen(false);
+	INT32 nRet = BurnDrvInit();
+	BzipClose();
+
+	if (nRet) {
+		fprintf(stderr, "Movie: couldn't start %s\n", szDriver);
+		BurnDrvExit();
+		bDrvOkay = 0;
+		return 1;
+	}
+
+	nBurnSoundLen = (nSoundRate * 100 + (nBurnFPS >> 1)) / nBurnFPS;
+
+	UINT8* pImage = (UINT8*)calloc(nBurnPitch * nHeight, 1);
+	INT16* pSound = (INT16*)calloc(nBurnSoundLen * 2 + 2, sizeof(INT16));
+
+	nRet = 1;
+	if (pImage && pSound && MoviePlayStart(szFile) == 0) {
+		UINT64 nStartTicks = BurnGetTicks();
+		INT32 nFrames = nMovieFrames;
+
+		while (nMovieStatus == MOVIE_PLAY && nMovieFrame < nMovieFrames) {
+#if defined (BURN_TRACE)
+			BurnTraceFrame();
+#endif
+			BURN_TRACE_SCOPE("RunFrame", "frame");
+
+			// Same order as the front end's RunFrame(), some drivers look at nCurrentFrame
+			nCurrentFrame++;
+			MovieFrame();
+
+			pBurnDraw = pImage;
+			pBurnSoundOut = nSoundRate ? pSound : NULL;
+			BurnDrvFrame();
+		}
+
+		UINT32 nTicks = (UINT32)((BurnGetTicks() - nStartTicks) / 1000);
+		nRet = nMovieDesyncs ? 1 : 0;
+
+		MovieStop();
+
+		printf("Movie: %d frames in %d ms (%d.%02d ms/frame)\n", nFrames, nTicks, nFrames ? nTicks / nFrames : 0, nFrames ? (nTicks * 100 / nFrames) % 100 : 0);
+	}
+
+	pBurnDraw = NULL;
+	pBurnSoundOut = NULL;
+
+	BurnDrvExit();
+	bDrvOkay = 0;
+
+	free(pImage);
+	free(pSound);
+
+	return nRet;
+}
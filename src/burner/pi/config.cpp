@@ -25,6 +25,13 @@ int piLoadConfig()
 		}
 
 		VAR(bVidScanlines);
+		VAR(nBurnBandThreads);
+		VAR(nSh2BlockCacheMode);
+		VAR(nZetDecodeCacheMode);
+		VAR(nArm7DecodeCacheMode);
+		VAR(nBurnSchedMode);
+		VAR(nSnesSpcCatchUp);
+		VAR(nSknsSpriteCacheSize);
 
 		// Other
 		STR(szAppRomPaths[0]);
@@ -73,6 +80,27 @@ int piSaveConfig()
 	fprintf(f,"\n// If non-zero, enable scanlines\n");
 	VAR(bVidScanlines);
 
+	fprintf(f,"\n// Threads used to render video in bands (0 or 1 to render on one core)\n");
+	VAR(nBurnBandThreads);
+
+	fprintf(f,"\n// SH-2 block cache (0 = off, 1 = on, 2 = on and verified each opcode)\n");
+	VAR(nSh2BlockCacheMode);
+
+	fprintf(f,"\n// Z80 decode cache (0 = off, 1 = on, 2 = on and verified each instruction)\n");
+	VAR(nZetDecodeCacheMode);
+
+	fprintf(f,"\n// ARM7 decode cache (0 = off, 1 = on, 2 = on and verified each instruction)\n");
+	VAR(nArm7DecodeCacheMode);
+
+	fprintf(f,"\n// Cpu scheduler for converted drivers (0 = fixed interleave, 1 = event driven)\n");
+	VAR(nBurnSchedMode);
+
+	fprintf(f,"\n// SNES sound cpu (0 = lockstep with the main cpu, 1 = caught up when the main cpu talks to it)\n");
+	VAR(nSnesSpcCatchUp);
+
+	fprintf(f,"\n// Super Kaneko Nova decoded sprite cache in KB (0 = off)\n");
+	VAR(nSknsSpriteCacheSize);
+
 	fprintf(f,"// ROM paths (include trailing slash)\n");
 	STR(szAppRomPaths[0]);
 	STR(szAppRomPaths[1]);
@@ -1,5 +1,6 @@
 #include "burner.h"
 #include "config.h"
+#include "burn_trace.h"
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -167,9 +168,122 @@ int parseSwitches(int argc, char *argv[])
 int main(int argc, char *argv[])
 {
 	const char *romname = NULL;
+	char *recordMovie = NULL;
+	char *playMovie = NULL;
+	char *startState = NULL;
 	nEnableFreeplayHack = 0;
 
+#if defined (BURN_TRACE)
+	// Start the trace before the headless modes below run and return
 	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-trace") == 0) {
+			// Record a Chrome trace of a range of frames
+			if (i + 3 >= argc) {
+				fprintf(stderr, "-trace needs a filename, the first frame and a frame count\n");
+				return 1;
+			}
+
+			if (BurnTraceStart(argv[i + 1], atoi(argv[i + 2]), atoi(argv[i + 3]))) {
+				fprintf(stderr, "Couldn't start the trace\n");
+				return 1;
+			}
+
+			break;
+		}
+	}
+#endif
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-audit") == 0) {
+			// Audit every set instead of running one
+			if (++i >= argc) {
+				fprintf(stderr, "-audit needs a report filename\n");
+				return 1;
+			}
+
+			int threads = (i + 1 < argc) ? atoi(argv[i + 1]) : 0;
+
+			piLoadConfig();
+			BurnLibInit();
+
+			int ret = AuditRomSets(argv[i], threads);
+			if (ret) {
+				fprintf(stderr, "Couldn't write the audit report to %s\n", argv[i]);
+			}
+
+			BurnLibExit();
+
+			return ret;
+		}
+
+		if (strcmp(argv[i], "-golden") == 0) {
+			// Check a list of drivers against their golden frame and sound hashes
+			if (i + 3 >= argc) {
+				fprintf(stderr, "-golden needs a driver list (or \"all\"), a golden directory and a frame count\n");
+				return 1;
+			}
+
+			int procs = (i + 4 < argc) ? atoi(argv[i + 4]) : 0;
+
+			piLoadConfig();
+			BurnLibInit();
+
+			int ret = GoldenCheck(argv[i + 1], argv[i + 2], atoi(argv[i + 3]), procs);
+
+#if defined (BURN_TRACE)
+			BurnTraceStop();
+#endif
+			BurnLibExit();
+
+			return ret;
+		}
+
+		if (strcmp(argv[i], "-playheadless") == 0) {
+			// Play a movie back as fast as possible and check it stays in sync
+			if (++i >= argc) {
+				fprintf(stderr, "-playheadless needs a movie filename\n");
+				return 1;
+			}
+
+			piLoadConfig();
+			BurnLibInit();
+
+			int ret = MoviePlayHeadless(argv[i]);
+
+#if defined (BURN_TRACE)
+			BurnTraceStop();
+#endif
+			BurnLibExit();
+
+			return ret;
+		}
+
+		if (strcmp(argv[i], "-record") == 0 || strcmp(argv[i], "-play") == 0 || strcmp(argv[i], "-state") == 0) {
+			if (i + 1 >= argc) {
+				fprintf(stderr, "%s needs a filename\n", argv[i]);
+				return 1;
+			}
+
+			if (strcmp(argv[i], "-record") == 0) {
+				recordMovie = argv[i + 1];
+			} else if (strcmp(argv[i], "-play") == 0) {
+				playMovie = argv[i + 1];
+			} else {
+				startState = argv[i + 1];
+			}
+
+			i++;
+			continue;
+		}
+
+#if defined (BURN_TRACE)
+		if (strcmp(argv[i], "-trace") == 0) {
+			// Already started above
+			i += 3;
+			continue;
+		}
+#endif
+
 		if (*argv[i] != '-') {
 			romname = argv[i];
 		}
@@ -177,6 +291,14 @@ int main(int argc, char *argv[])
 
 	if (romname == NULL) {
 		printf("Usage: %s [-f] [-F] [-dumpswitches] [-k seconds] <romname>\n", argv[0]);
+		printf("       %s -audit <report.json> [threads]\n", argv[0]);
+		printf("       %s -golden <driver list|all> <golden dir> <frames> [processes]\n", argv[0]);
+		printf("       %s -record <movie> [-state <savestate>] <romname>\n", argv[0]);
+		printf("       %s -play <movie> <romname>\n", argv[0]);
+		printf("       %s -playheadless <movie>\n", argv[0]);
+#if defined (BURN_TRACE)
+		printf("       %s -trace <trace.json> <first frame> <frames> <romname | -golden ... | -playheadless ...>\n", argv[0]);
+#endif
 		printf("e.g.: %s mslug\n", argv[0]);
 
 		return 0;
@@ -214,8 +336,25 @@ int main(int argc, char *argv[])
 
 	DrvInit(driverId, 0);
 	parseSwitches(argc, argv);
+
+	if (recordMovie) {
+		if (startState && BurnStateLoad(startState, 1, NULL)) {
+			fprintf(stderr, "Couldn't load %s to record from\n", startState);
+		} else {
+			MovieRecordStart(recordMovie, startState != NULL);
+		}
+	} else if (playMovie) {
+		MoviePlayStart(playMovie);
+	}
+
 	RunMessageLoop();
 
+	MovieStop();
+
+#if defined (BURN_TRACE)
+	BurnTraceStop();
+#endif
+
 	DrvExit();
 	MediaExit();
 
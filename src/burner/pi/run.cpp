@@ -1,5 +1,6 @@
 // Run module
 #include "burner.h"
+#include "burn_trace.h"
 
 bool bAltPause = 0;
 
@@ -17,6 +18,8 @@ static bool bAppDoStep = 0;
 static bool bAppDoFast = 0;
 static int nFastSpeed = 6;
 
+static bool bRunNVRAM = 0;				// Session loads and saves nvram (not started with a movie)
+
 int SaveNVRAM();
 int ReadNVRAM();
 
@@ -42,6 +45,13 @@ static int RunFrame(int bDraw, int bPause)
 		return 1;
 	}
 
+#if defined (BURN_TRACE)
+	if (!bPause) {
+		BurnTraceFrame();
+	}
+#endif
+	BURN_TRACE_SCOPE("RunFrame", "frame");
+
 	if (bPause) {
 		InputMake(false);
 		if (bPause != bPrevPause) {
@@ -51,6 +61,7 @@ static int RunFrame(int bDraw, int bPause)
 		nFramesEmulated++;
 		nCurrentFrame++;
 		InputMake(true);
+		MovieFrame();
 	}
 
 	if (bDraw) {
@@ -172,7 +183,12 @@ static int RunInit()
 
 	RunReset();
 
-	ReadNVRAM();
+	// A movie starts from power-on or its own savestate, not from whatever is in nvram.
+	// Remember that here, a played movie stops by itself before the session ends.
+	bRunNVRAM = (nMovieStatus == MOVIE_NONE);
+	if (bRunNVRAM) {
+		ReadNVRAM();
+	}
 
 	return 0;
 }
@@ -180,7 +196,9 @@ static int RunInit()
 static int RunExit()
 {
 	nNormalLast = 0;
-	SaveNVRAM();
+	if (bRunNVRAM) {
+		SaveNVRAM();
+	}
 
 	return 0;
 }
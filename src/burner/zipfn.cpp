@@ -397,3 +397,120 @@ INT32 __cdecl ZipLoadOneFile(char* arcName, const char* fileName, void** Dest, I
 
 	return 0;
 }
+
+// Read the directory of an archive (szArchive includes the .zip/.7z extension) without
+// inflating anything. This doesn't touch the archive opened with ZipOpen(), so zip files
+// can be listed from several threads at once. 7z files go through un7z's file cache,
+// callers must serialise those themselves.
+INT32 ZipReadList(char* szArchive, struct ZipEntry** pList, INT32* pnListCount)
+{
+	if (szArchive == NULL || pList == NULL) return 1;
+
+	*pList = NULL;
+	if (pnListCount != NULL) *pnListCount = 0;
+
+#ifdef INCLUDE_7Z_SUPPORT
+	INT32 nNameLen = strlen(szArchive);
+
+	if (nNameLen > 3 && strcmp(szArchive + nNameLen - 3, ".7z") == 0) {
+		_7z_file* _7z = NULL;
+		if (_7z_file_open(szArchive, &_7z) != _7ZERR_NONE) return 1;
+
+		INT32 nListLen = _7z->db.db.NumFiles;
+
+		struct ZipEntry* List = (struct ZipEntry *)malloc((nListLen + 1) * sizeof(struct ZipEntry));
+		if (List == NULL) { _7z_file_close(_7z); return 1; }
+		memset(List, 0, (nListLen + 1) * sizeof(struct ZipEntry));
+
+		UInt16 *temp = NULL;
+		size_t tempSize = 0;
+		INT32 nCount = 0;
+
+		for (INT32 i = 0; i < nListLen; i++) {
+			const CSzFileItem *f = _7z->db.db.Files + i;
+
+			if (f->IsDir) continue;
+
+			size_t len = SzArEx_GetFileNameUtf16(&_7z->db, i, NULL);
+			if (len > tempSize) {
+				SZipFree(NULL, temp);
+				tempSize = len;
+				temp = (UInt16 *)SZipAlloc(NULL, tempSize * sizeof(temp[0]));
+				if (temp == NULL) break;
+			}
+
+			SzArEx_GetFileNameUtf16(&_7z->db, i, temp);
+
+			char* szName = (char *)malloc(len + 1);
+			if (szName == NULL) continue;
+
+			// rom names are plain ascii, keep the low byte
+			for (UINT32 j = 0; j < len; j++) {
+				szName[j] = temp[j] & 0xff;
+			}
+			szName[len] = 0;
+
+			List[nCount].szName = szName;
+			List[nCount].nLen = f->Size;
+			List[nCount].nCrc = f->Crc;
+			nCount++;
+		}
+
+		SZipFree(NULL, temp);
+		_7z_file_close(_7z);
+
+		*pList = List;
+		if (pnListCount != NULL) *pnListCount = nCount;
+
+		return 0;
+	}
+#endif
+
+	unzFile ListZip = unzOpen(szArchive);
+	if (ListZip == NULL) return 1;
+
+	unz_global_info ZipGlobalInfo;
+	memset(&ZipGlobalInfo, 0, sizeof(ZipGlobalInfo));
+	unzGetGlobalInfo(ListZip, &ZipGlobalInfo);
+
+	INT32 nListLen = ZipGlobalInfo.number_entry;
+
+	struct ZipEntry* List = (struct ZipEntry *)malloc((nListLen + 1) * sizeof(struct ZipEntry));
+	if (List == NULL) { unzClose(ListZip); return 1; }
+	memset(List, 0, (nListLen + 1) * sizeof(struct ZipEntry));
+
+	INT32 nCount = 0;
+	INT32 nRet = unzGoToFirstFile(ListZip);
+
+	while (nRet == UNZ_OK && nCount < nListLen) {
+		unz_file_info FileInfo;
+		char szName[MAX_PATH];
+
+		if (unzGetCurrentFileInfo(ListZip, &FileInfo, szName, MAX_PATH, NULL, 0, NULL, 0) == UNZ_OK) {
+			List[nCount].szName = strdup(szName);
+			List[nCount].nLen = FileInfo.uncompressed_size;
+			List[nCount].nCrc = FileInfo.crc;
+			if (List[nCount].szName) nCount++;
+		}
+
+		nRet = unzGoToNextFile(ListZip);
+	}
+
+	unzClose(ListZip);
+
+	*pList = List;
+	if (pnListCount != NULL) *pnListCount = nCount;
+
+	return 0;
+}
+
+void ZipFreeList(struct ZipEntry* List, INT32 nListCount)
+{
+	if (List == NULL) return;
+
+	for (INT32 i = 0; i < nListCount; i++) {
+		free(List[i].szName);
+	}
+
+	free(List);
+}
@@ -91,6 +91,16 @@ static int ARM7_ICOUNT;
 static int total_cycles = 0;
 static int curr_cycles = 0;
 
+/* Pre-decoded ARM state code, NULL = decode every fetch */
+static struct Arm7DecodePage **arm7_decode_map = NULL;
+static int arm7_decode_lockstep = 0;
+
+void Arm7SetDecodeMap(struct Arm7DecodePage **map, int lockstep)
+{
+	arm7_decode_map = map;
+	arm7_decode_lockstep = lockstep;
+}
+
 void Arm7Open(int ) 
 {
 
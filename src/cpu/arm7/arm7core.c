@@ -221,6 +221,113 @@ ARM7_INLINE UINT32 cpu_readop16(UINT32 addr)
     return result;
 }
 
+/***************************************************************************
+ * ARM state decode cache (arm7_intf.cpp owns the pages)
+ ***************************************************************************/
+
+/* bit n is set when the condition passes with NZCV == n */
+static const UINT16 arm7_cond_pass[16] = {
+    0xf0f0, 0x0f0f, 0xcccc, 0x3333, 0xff00, 0x00ff, 0xaaaa, 0x5555,
+    0x0c0c, 0xf3f3, 0xaa55, 0x55aa, 0x0a05, 0xf5fa, 0xffff, 0x0000
+};
+
+#define ARM7_COND_PASSED(insn)  (arm7_cond_pass[(insn) >> INSN_COND_SHIFT] & (1 << (GET_CPSR >> 28)))
+
+/* Must classify exactly like the decode in arm7exec.c used to */
+ARM7_INLINE UINT32 arm7_decode_type(UINT32 insn)
+{
+    switch ((insn & 0xF000000) >> 24)
+    {
+        case 0:
+        case 1:
+        case 2:
+        case 3:
+            if ((insn & 0x0ffffff0) == 0x012fff10)
+                return ARM7_DEC_BX;
+            if ((insn & 0x0e000000) == 0 && (insn & 0x80) && (insn & 0x10))
+            {
+                if (insn & 0x60)
+                    return ARM7_DEC_HALFWORD;
+                if (insn & 0x01000000)
+                    return ARM7_DEC_SWAP;
+                if (insn & 0x800000)
+                    return (insn & 0x00400000) ? ARM7_DEC_SMULL : ARM7_DEC_UMULL;
+                return ARM7_DEC_MUL;
+            }
+            if (((insn & 0x00100000) == 0) && ((insn & 0x01800000) == 0x01000000))
+                return ARM7_DEC_PSR;
+            return ARM7_DEC_ALU;
+        case 4:
+        case 5:
+        case 6:
+        case 7:
+            return ARM7_DEC_MEMSINGLE;
+        case 8:
+        case 9:
+            return ARM7_DEC_MEMBLOCK;
+        case 0xa:
+        case 0xb:
+            return ARM7_DEC_BRANCH;
+        case 0xc:
+        case 0xd:
+            return ARM7_DEC_CODT;
+        case 0xe:
+            return (insn & 0x10) ? ARM7_DEC_CORT : ARM7_DEC_CODO;
+    }
+
+    return ARM7_DEC_SWI;
+}
+
+/* Fill the entry for pc, NULL if that word has to be fetched as usual */
+static struct Arm7Decoded *arm7_decode_slow(UINT32 pc)
+{
+    struct Arm7Decoded *op = Arm7DecodeEntry(pc);
+
+    if (op)
+    {
+        op->insn = cpu_readop32(pc);
+        op->type = arm7_decode_type(op->insn);
+    }
+
+    return op;
+}
+
+static void arm7_decode_verify(UINT32 pc, struct Arm7Decoded *op)
+{
+    UINT32 insn = cpu_readop32(pc);
+    UINT32 type = arm7_decode_type(insn);
+
+    if (insn != op->insn || type != op->type)
+    {
+        bprintf(PRINT_ERROR, _T("ARM7 decode cache: stale entry at %08x (%08x/%d, memory has %08x/%d)\n"), pc, op->insn, op->type, insn, type);
+
+        op->insn = insn;
+        op->type = type;
+    }
+}
+
+ARM7_INLINE struct Arm7Decoded *arm7_decode_fetch(UINT32 pc)
+{
+    /* same 4k paging as the memory maps */
+    struct Arm7DecodePage *page = arm7_decode_map[(pc & 0x7fffffff) >> 12];
+
+    if (pc & 3)
+        return NULL;
+
+    if (page == NULL)
+        return arm7_decode_slow(pc);
+
+    struct Arm7Decoded *op = &page->op[(pc & 0xfff) >> 2];
+
+    if (op->type == ARM7_DEC_EMPTY || (page->verify && op->insn != *((UINT32*)(page->mem + (pc & 0xffc)))))
+        return arm7_decode_slow(pc);
+
+    if (arm7_decode_lockstep)
+        arm7_decode_verify(pc, op);
+
+    return op;
+}
+
 /***************
  * helper funcs
  ***************/
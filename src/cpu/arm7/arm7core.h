@@ -368,6 +368,27 @@ enum
     COND_NV               /*  0           never                   */
 };
 
+/* Instruction classes for the ARM state decode cache, in the order arm7exec.c tests for them */
+enum
+{
+    ARM7_DEC_EMPTY = 0,   /* not decoded yet                      */
+    ARM7_DEC_BX,
+    ARM7_DEC_HALFWORD,
+    ARM7_DEC_SWAP,
+    ARM7_DEC_SMULL,
+    ARM7_DEC_UMULL,
+    ARM7_DEC_MUL,
+    ARM7_DEC_PSR,
+    ARM7_DEC_ALU,
+    ARM7_DEC_MEMSINGLE,
+    ARM7_DEC_MEMBLOCK,
+    ARM7_DEC_BRANCH,
+    ARM7_DEC_CODT,
+    ARM7_DEC_CORT,
+    ARM7_DEC_CODO,
+    ARM7_DEC_SWI
+};
+
 #define LSL(v, s) ((v) << (s))
 #define LSR(v, s) ((v) >> (s))
 #define ROL(v, s) (LSL((v), (s)) | (LSR((v), 32u - (s))))
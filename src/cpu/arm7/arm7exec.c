@@ -43,6 +43,7 @@
 {
     UINT32 pc;
     UINT32 insn;
+    struct Arm7Decoded *op;
 
     ARM7_ICOUNT = cycles;
     curr_cycles = total_cycles;
@@ -1163,6 +1164,79 @@
                     break;
             }
         }
+        else if (arm7_decode_map && (op = arm7_decode_fetch(R15)) != NULL)
+        {
+            /* pre-decoded 32 bit instruction, same handlers as below */
+            pc = R15;
+            insn = op->insn;
+
+            if (!ARM7_COND_PASSED(insn))
+                goto L_Next;
+
+            switch (op->type)
+            {
+                case ARM7_DEC_BX:
+                    R15 = GET_REGISTER(insn & 0x0f);
+                    if (R15 & 1) {
+                        SET_CPSR(GET_CPSR|T_MASK);
+                        R15--;
+                    }
+                    break;
+                case ARM7_DEC_HALFWORD:
+                    HandleHalfWordDT(insn);
+                    break;
+                case ARM7_DEC_SWAP:
+                    HandleSwap(insn);
+                    break;
+                case ARM7_DEC_SMULL:
+                    HandleSMulLong(insn);
+                    R15 += 4;
+                    break;
+                case ARM7_DEC_UMULL:
+                    HandleUMulLong(insn);
+                    R15 += 4;
+                    break;
+                case ARM7_DEC_MUL:
+                    HandleMul(insn);
+                    R15 += 4;
+                    break;
+                case ARM7_DEC_PSR:
+                    HandlePSRTransfer(insn);
+                    ARM7_ICOUNT += 2;
+                    R15 += 4;
+                    break;
+                case ARM7_DEC_ALU:
+                    HandleALU(insn);
+                    break;
+                case ARM7_DEC_MEMSINGLE:
+                    HandleMemSingle(insn);
+                    R15 += 4;
+                    break;
+                case ARM7_DEC_MEMBLOCK:
+                    HandleMemBlock(insn);
+                    R15 += 4;
+                    break;
+                case ARM7_DEC_BRANCH:
+                    HandleBranch(insn);
+                    break;
+                case ARM7_DEC_CODT:
+                    HandleCoProcDT(insn);
+                    R15 += 4;
+                    break;
+                case ARM7_DEC_CORT:
+                    HandleCoProcRT(insn);
+                    R15 += 4;
+                    break;
+                case ARM7_DEC_CODO:
+                    HandleCoProcDO(insn);
+                    R15 += 4;
+                    break;
+                default: /* ARM7_DEC_SWI */
+                    ARM7.pendingSwi = 1;
+                    ARM7_CHECKIRQ;
+                    break;
+            }
+        }
         else
         {
 
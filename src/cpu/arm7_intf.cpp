@@ -28,8 +28,126 @@ static UINT8  (*pReadByteHandler)(UINT32) = NULL;
 
 static UINT32 Arm7IdleLoop = ~0;
 
+INT32 nArm7DecodeCacheMode = ARM7_DECODECACHE_OFF;
+
+static struct Arm7DecodePage **DecodeMap = NULL; // one per fetch page, allocated the first time code runs from it
+
 extern void arm7_set_irq_line(INT32 irqline, INT32 state);
 
+// Decode cache -- the core looks words up in DecodeMap itself and only calls Arm7DecodeEntry()
+// for ones it hasn't decoded yet. Entries on rom pages are trusted once decoded. Pages the arm7
+// can write are checked against memory on every fetch instead, which also catches code that the
+// 68k patches through shared ram.
+struct Arm7Decoded *Arm7DecodeEntry(UINT32 addr)
+{
+	addr &= MAX_MEMORY_AND;
+
+	UINT32 page = addr >> PAGE_SHIFT;
+
+	// the idle loop hack lives in the fetch handlers, so that word always goes through them
+	if (DecodeMap == NULL || membase[FETCH][page] == NULL || addr == Arm7IdleLoop) {
+		return NULL;
+	}
+
+	struct Arm7DecodePage *p = DecodeMap[page];
+
+	if (p == NULL) {
+		p = (struct Arm7DecodePage*)malloc(sizeof(struct Arm7DecodePage));
+		if (p == NULL) {
+			return NULL;
+		}
+
+		memset(p->op, 0, sizeof(p->op));
+		p->mem = membase[FETCH][page];
+		p->verify = (membase[WRITE][page] != NULL);
+
+		DecodeMap[page] = p;
+	}
+
+	return &p->op[(addr & PAGE_LONG_AND) >> 2];
+}
+
+static void Arm7DecodeUpdate(UINT32 page)
+{
+	struct Arm7DecodePage *p = DecodeMap[page];
+
+	if (p == NULL) return;
+
+	UINT8 *mem = membase[FETCH][page];
+	INT32 verify = (membase[WRITE][page] != NULL);
+
+	// remapping a bank that's already there keeps what has been decoded
+	if (mem == p->mem && verify == p->verify) return;
+
+	if (mem == NULL) {
+		free (p);
+		DecodeMap[page] = NULL;
+		return;
+	}
+
+	// unverified entries are only good for the memory they were decoded from
+	if (!verify) {
+		memset(p->op, 0, sizeof(p->op));
+	}
+
+	p->mem = mem;
+	p->verify = verify;
+}
+
+static void Arm7DecodeInvalidate(UINT32 addr)
+{
+	if (DecodeMap == NULL) return;
+
+	addr &= MAX_MEMORY_AND;
+
+	struct Arm7DecodePage *p = DecodeMap[addr >> PAGE_SHIFT];
+
+	if (p) {
+		p->op[(addr & PAGE_LONG_AND) >> 2].type = 0;
+	}
+}
+
+static void Arm7DecodeExit()
+{
+	Arm7SetDecodeMap(NULL, 0);
+
+	if (DecodeMap) {
+		for (UINT32 i = 0; i < PAGE_COUNT; i++) {
+			if (DecodeMap[i]) {
+				free (DecodeMap[i]);
+			}
+		}
+
+		free (DecodeMap);
+		DecodeMap = NULL;
+	}
+}
+
+static void Arm7DecodeInit()
+{
+	Arm7DecodeExit();
+
+	if (nArm7DecodeCacheMode == ARM7_DECODECACHE_OFF) return;
+
+	DecodeMap = (struct Arm7DecodePage**)calloc(PAGE_COUNT, sizeof(struct Arm7DecodePage*));
+
+	if (DecodeMap == NULL) {
+		bprintf(PRINT_ERROR, _T("ARM7 decode cache: out of memory, fetching as usual\n"));
+		return;
+	}
+
+	Arm7SetDecodeMap(DecodeMap, nArm7DecodeCacheMode == ARM7_DECODECACHE_LOCKSTEP);
+}
+
+void Arm7SetDecodeCache(INT32 nMode)
+{
+	nArm7DecodeCacheMode = nMode;
+
+	if (membase[FETCH]) {
+		Arm7DecodeInit();
+	}
+}
+
 INT32 Arm7GetActive()
 {
 	return 0;
@@ -41,6 +159,8 @@ void Arm7Exit() // only one cpu supported
 	if (!DebugCPU_ARM7Initted) bprintf(PRINT_ERROR, _T("Arm7Exit called without init\n"));
 #endif
 
+	Arm7DecodeExit();
+
 	for (INT32 i = 0; i < 3; i++) {
 		if (membase[i]) {
 			free (membase[i]);
@@ -68,6 +188,8 @@ void Arm7MapMemory(UINT8 *src, UINT32 start, UINT32 finish, INT32 type)
 		if (type & (1 <<  READ)) membase[ READ][offset] = src + (i << PAGE_SHIFT);
 		if (type & (1 << WRITE)) membase[WRITE][offset] = src + (i << PAGE_SHIFT);
 		if (type & (1 << FETCH)) membase[FETCH][offset] = src + (i << PAGE_SHIFT);
+
+		if (DecodeMap) Arm7DecodeUpdate(offset);
 	}
 }
 
@@ -342,6 +464,9 @@ void Arm7SetIdleLoopAddress(UINT32 address)
 	if (!DebugCPU_ARM7Initted) bprintf(PRINT_ERROR, _T("Arm7SetIdleLoopAddress called without init\n"));
 #endif
 
+	Arm7DecodeInvalidate(Arm7IdleLoop);
+	Arm7DecodeInvalidate(address);
+
 	Arm7IdleLoop = address;
 }
 
@@ -364,6 +489,8 @@ static void Arm7_write_rom_byte(UINT32 addr, UINT8 data)
 		membase[READ][addr >> PAGE_SHIFT][addr & PAGE_BYTE_AND] = data;
 	}
 
+	Arm7DecodeInvalidate(addr);
+
 	if (pWriteByteHandler) {
 		pWriteByteHandler(addr, data);
 	}
@@ -391,7 +518,10 @@ void Arm7Init( INT32 nCPU ) // only one cpu supported
 	
 	for (INT32 i = 0; i < 3; i++) {
 		membase[i] = (UINT8**)malloc(PAGE_COUNT * sizeof(UINT8*));
+		memset (membase[i], 0, PAGE_COUNT * sizeof(UINT8*));
 	}
 
+	Arm7DecodeInit();
+
 	CpuCheatRegister(nCPU, &Arm7CheatCpuConfig);
 }
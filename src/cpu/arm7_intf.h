@@ -1,3 +1,5 @@
+#ifndef _ARM7_INTF_H_
+#define _ARM7_INTF_H_
 
 void Arm7WriteByte(UINT32 addr, UINT8 data);
 void Arm7WriteWord(UINT32 addr, UINT16 data);
@@ -39,3 +41,28 @@ void Arm7SetReadLongHandler(UINT32 (*read)(UINT32));
 // speed hack function
 void Arm7SetIdleLoopAddress(UINT32 address);
 
+// Optional pre-decoded instruction cache for ARM state code (see arm7_intf.cpp), off by default
+#define ARM7_DECODECACHE_OFF		0
+#define ARM7_DECODECACHE_ON			1
+#define ARM7_DECODECACHE_LOCKSTEP	2	// also checks each cached instruction against a fresh fetch
+
+void Arm7SetDecodeCache(INT32 nMode);
+
+// One entry per word of a fetch page, filled the first time the core executes it
+#define ARM7_DECODE_PAGE_OPS		0x400
+
+struct Arm7Decoded {
+	UINT32 insn;
+	UINT32 type;					// ARM7_DEC_* class (arm7core.h), 0 until decoded
+};
+
+struct Arm7DecodePage {
+	UINT8 *mem;						// fetch memory the entries were decoded from
+	INT32 verify;					// memory is writable, so check each entry still matches it
+	struct Arm7Decoded op[ARM7_DECODE_PAGE_OPS];
+};
+
+struct Arm7Decoded *Arm7DecodeEntry(UINT32 addr);
+void Arm7SetDecodeMap(struct Arm7DecodePage **map, INT32 lockstep);
+
+#endif // _ARM7_INTF_H_
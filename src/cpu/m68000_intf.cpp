@@ -2,6 +2,7 @@
 #include "burnint.h"
 #include "m68000_intf.h"
 #include "m68000_debug.h"
+#include "burn_trace.h"
 
 INT32 nSekCpuCore = SEK_CORE_M68K;  // 0 - c68k, 1 - m68k, 2 - a68k
 INT32 DebugStep = 0; // 0 - off, 1 - on
@@ -595,6 +596,44 @@ void SekWriteByteROM(UINT32 a, UINT8 d) { WriteByteROM(a, d); }
 void SekWriteWordROM(UINT32 a, UINT16 d) { WriteWordROM(a, d); }
 void SekWriteLongROM(UINT32 a, UINT32 d) { WriteLongROM(a, d); }
 
+// ----------------------------------------------------------------------------
+// Cheat support
+
+static UINT8 SekCheatReadByte(UINT32 a)
+{
+	return ReadByte(a);
+}
+
+// The byte WriteByteROM() would store to, if it isn't behind a handler
+static UINT8* SekCheatMemMap(UINT32 a)
+{
+	UINT8* pr;
+
+	a &= 0xFFFFFF;
+
+	pr = FIND_R(a);
+	if ((uintptr_t)pr < SEK_MAXHANDLER) return NULL;
+
+	return pr + ((a ^ 1) & SEK_PAGEM);
+}
+
+static cpu_core_config SekCheatCpuConfig =
+{
+	SekOpen,
+	SekClose,
+	SekCheatReadByte,
+	SekWriteByteROM,
+	SekGetActive,
+	SekTotalCycles,
+	SekNewFrame,
+	SekRun,
+	SekRunEnd,
+	SekReset,
+	0x1000000,
+	0,
+	SekCheatMemMap
+};
+
 
 // ----------------------------------------------------------------------------
 // Callbacks for A68K
@@ -959,6 +998,9 @@ INT32 SekInit(INT32 nCount, INT32 nCPUType)
 
 	nSekCyclesTotal = 0;
 	nSekCyclesScanline = 0;
+
+	CpuCheatRegister(nCount, &SekCheatCpuConfig);
+
 	return 0;
 }
 
@@ -1233,6 +1275,8 @@ void SekRunEnd()
 // Run the active CPU
 INT32 SekRun(const INT32 nCycles)
 {
+	BURN_TRACE_SCOPE("SekRun", "cpu");
+
 #ifdef EMU_A68K
 	if(nSekCpuCore == SEK_CORE_A68K) {
 		nSekCyclesDone = 0;
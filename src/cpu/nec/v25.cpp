@@ -558,8 +558,9 @@ int v25_execute(int cycles)
 		}
 	}
 
-	nec_state->stop_run = 0;
 	nec_state->cycles_total += cycles - nec_state->icount;
+	nec_state->cycles_remaining = 0;
+	nec_state->stop_run = 0;
 
 	return cycles - nec_state->icount;
 }
@@ -5,6 +5,7 @@
 
 #include "burnint.h"
 #include "nec_intf.h"
+#include "burn_trace.h"
 
 #define MAX_VEZ		4
 
@@ -569,6 +570,8 @@ void VezReset()
 
 INT32 VezRun(INT32 nCycles)
 {
+	BURN_TRACE_SCOPE("VezRun", "cpu");
+
 #if defined FBA_DEBUG
 	if (!DebugCPU_VezInitted) bprintf(PRINT_ERROR, _T("VezRun called without init\n"));
 	if (nOpenedCPU == -1) bprintf(PRINT_ERROR, _T("VezRun called when no CPU open\n"));
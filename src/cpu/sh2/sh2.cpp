@@ -199,6 +199,26 @@ typedef struct
 static SH2EXT * pSh2Ext;
 static SH2EXT * Sh2Ext = NULL;
 
+// Block cache - see Sh2BlockLookup()
+int nSh2BlockCacheMode = SH2_BLOCKCACHE_OFF;
+
+static UINT32 * pSh2CodeMap = NULL;		// 1 bit per 256 bytes of code that has been cached
+
+static void Sh2InvalidateCode(UINT32 A);
+static void Sh2InvalidateCodeRange(UINT32 nStart, UINT32 nEnd);
+static void Sh2BlockFlush();
+static int Sh2BlockInit();
+static void Sh2BlockExit();
+static int Sh2ShadowWrite(unsigned char * pr, UINT32 A);
+
+static INT32 nSh2Shadow = 0;			// lockstep: a cached block is being replayed, see Sh2BlockReplay()
+static INT32 nSh2ShadowFault = 0;		// the replay touched a handler or cached code
+static INT32 nSh2ExpectOps = 0;			// opcodes left before the lockstep compare, 0 = none pending
+static INT32 nSh2LockstepHalt = 0;		// set on a lockstep mismatch, Sh2Run() stops executing
+
+#define SH2_CODE_INDEX(A)	((((A) & AM) >> 30 << 19) | (((A) >> 8) & 0x7ffff))
+#define SH2_CODE_TEST(A)	(pSh2CodeMap && (pSh2CodeMap[SH2_CODE_INDEX(A) >> 5] & (1 << (SH2_CODE_INDEX(A) & 31))))
+
 /* SH-2 Memory Map:
  * 0x00000000 ~ 0x07ffffff : user
  * 0x08000000 ~ 0x0fffffff : user ( mirror )
@@ -219,6 +239,8 @@ int Sh2MapMemory(unsigned char* pMemory, unsigned int nStart, unsigned int nEnd,
 	if (!DebugCPU_SH2Initted) bprintf(PRINT_ERROR, _T("Sh2MapMemory called without init\n"));
 #endif
 
+	if (nType & 0x04 /*SM_FETCH*/) Sh2InvalidateCodeRange(nStart, nEnd);
+
 	unsigned char* Ptr = pMemory - nStart;
 	unsigned char** pMemMap = pSh2Ext->MemMap + (nStart >> SH2_SHIFT);
 	int need_mirror = (nStart < 0x08000000) ? 1 : 0;
@@ -267,6 +289,8 @@ int Sh2MapHandler(uintptr_t nHandler, unsigned int nStart, unsigned int nEnd, in
 	if (!DebugCPU_SH2Initted) bprintf(PRINT_ERROR, _T("Sh2MapHandler called without init\n"));
 #endif
 
+	if (nType & 0x04 /*SM_FETCH*/) Sh2InvalidateCodeRange(nStart, nEnd);
+
 	unsigned char** pMemMap = pSh2Ext->MemMap + (nStart >> SH2_SHIFT);
 	int need_mirror = (nStart < 0x08000000) ? 1 : 0;
 	
@@ -451,6 +475,8 @@ int Sh2Exit()
 
 	has_sh2 = 0;
 
+	Sh2BlockExit();
+
 	if (Sh2Ext) {
 		free(Sh2Ext);
 		Sh2Ext = NULL;
@@ -472,6 +498,20 @@ static UINT8 Sh2CheatReadByte(UINT32 a)
 	return Sh2ReadByte(a);
 }
 
+static UINT8* Sh2CheatMemMap(UINT32 a)
+{
+	unsigned char* pr = pSh2Ext->MemMap[(a >> SH2_SHIFT) + SH2_WADD];
+
+	// handlers and cached code have to go through Sh2WriteByte()
+	if ((uintptr_t)pr < SH2_MAXHANDLER || SH2_CODE_TEST(a)) return NULL;
+
+#ifdef LSB_FIRST
+	a ^= 3;
+#endif
+
+	return pr + (a & SH2_PAGEM);
+}
+
 static cpu_core_config Sh2CheatCpuConfig =
 {
 	Sh2Open,
@@ -485,7 +525,8 @@ static cpu_core_config Sh2CheatCpuConfig =
 	Sh2StopRun,
 	Sh2Reset,
 	0xffffffff,
-	0
+	0,
+	Sh2CheatMemMap
 };
 
 int Sh2Init(int nCount)
@@ -527,6 +568,8 @@ int Sh2Init(int nCount)
 		CpuCheatRegister(i, &Sh2CheatCpuConfig);
 	}
 
+	Sh2BlockInit();
+
 	return 0;
 }
 
@@ -536,6 +579,10 @@ void Sh2Open(const int i)
 	if (!DebugCPU_SH2Initted) bprintf(PRINT_ERROR, _T("Sh2Open called without init\n"));
 #endif
 
+	if (pSh2Ext != Sh2Ext + i) {
+		Sh2BlockFlush();				// blocks are shared between cpus
+	}
+
 	pSh2Ext = Sh2Ext + i;
 	sh2 = & (pSh2Ext->sh2);
 }
@@ -571,6 +618,8 @@ void Sh2Reset(unsigned int pc, unsigned r15)
 	change_pc(sh2->pc & AM);
 
 	sh2->internal_irq_level = -1;
+
+	Sh2BlockFlush();
 }
 
 //----------------------------------------------------------------
@@ -646,6 +695,10 @@ SH2_INLINE UINT8 RB(UINT32 A)
 #endif
 		return pr[A & SH2_PAGEM];
 	}
+	if (nSh2Shadow) {
+		nSh2ShadowFault = 1;
+		return 0;
+	}
 	return pSh2Ext->ReadByte[(uintptr_t)pr](A);
 }
 
@@ -665,6 +718,10 @@ SH2_INLINE UINT16 RW(UINT32 A)
 		//return (pr[A & SH2_PAGEM] << 8) | pr[(A & SH2_PAGEM) + 1];
 		return *((unsigned short *)(pr + (A & SH2_PAGEM)));
 	}
+	if (nSh2Shadow) {
+		nSh2ShadowFault = 1;
+		return 0;
+	}
 	return pSh2Ext->ReadWord[(uintptr_t)pr](A);
 }
 
@@ -696,6 +753,10 @@ SH2_INLINE UINT32 RL(UINT32 A)
 		//return (pr[(A & SH2_PAGEM) + 0] << 24) | (pr[(A & SH2_PAGEM) + 1] << 16) | (pr[(A & SH2_PAGEM) + 2] <<  8) | (pr[(A & SH2_PAGEM) + 3] <<  0);
 		return *((unsigned int *)(pr + (A & SH2_PAGEM)));
 	}
+	if (nSh2Shadow) {
+		nSh2ShadowFault = 1;
+		return 0;
+	}
 	return pSh2Ext->ReadLong[(uintptr_t)pr](A);
 }
 
@@ -708,6 +769,8 @@ SH2_INLINE void WB(UINT32 A, UINT8 V)
 	
 	unsigned char* pr;
 	pr = pSh2Ext->MemMap[(A >> SH2_SHIFT) + SH2_WADD];
+	if (nSh2Shadow && !Sh2ShadowWrite(pr, A)) return;
+	if (SH2_CODE_TEST(A)) Sh2InvalidateCode(A);
 	if ((uintptr_t)pr >= SH2_MAXHANDLER) {
 #ifdef LSB_FIRST
 		A ^= 3;
@@ -727,6 +790,8 @@ SH2_INLINE void WW(UINT32 A, UINT16 V)
 
 	unsigned char * pr;
 	pr = pSh2Ext->MemMap[(A >> SH2_SHIFT) + SH2_WADD];
+	if (nSh2Shadow && !Sh2ShadowWrite(pr, A)) return;
+	if (SH2_CODE_TEST(A)) Sh2InvalidateCode(A);
 	if ((uintptr_t)pr >= SH2_MAXHANDLER) {
 #ifdef LSB_FIRST
 		A ^= 2;
@@ -745,6 +810,8 @@ SH2_INLINE void WL(UINT32 A, UINT32 V)
 	program_write_dword_32be(A & AM,V); */
 	unsigned char * pr;
 	pr = pSh2Ext->MemMap[(A >> SH2_SHIFT) + SH2_WADD];
+	if (nSh2Shadow && !Sh2ShadowWrite(pr, A)) return;
+	if (SH2_CODE_TEST(A)) Sh2InvalidateCode(A);
 	if ((uintptr_t)pr >= SH2_MAXHANDLER) {
 		*((unsigned int *)(pr + (A & SH2_PAGEM))) = (unsigned int)V;
 		return;
@@ -2762,6 +2829,414 @@ SH2_INLINE void op1111(UINT16 /*opcode*/)
 
 #endif	// USE_JUMPTABLE
 
+/*****************************************************************************
+ *  BLOCK CACHE
+ *
+ *  Runs of opcodes from directly mapped fetch pages are decoded once into
+ *  (handler, opcode) pairs and replayed from the cache, skipping the memory
+ *  map lookup and the first-level decode. The handlers, cycle counting, irq
+ *  and timer checks are the interpreter's own, so results (and savestates)
+ *  match it exactly. Cached code is tracked in 256 byte regions; any write
+ *  into a tracked region, or a remap of a fetch page, drops the blocks there.
+ *
+ *  In lockstep mode the interpreter does the real work. Each block is first
+ *  replayed from the cache on the side (writes are undone afterwards) and
+ *  the register file it produced is compared with the interpreter's once
+ *  that has run the same opcodes. A mismatch is reported and stops the cpu.
+ *****************************************************************************/
+
+#define SH2_BLOCK_COUNT		2048				// direct-mapped on pc
+#define SH2_BLOCK_OPS		32
+#define SH2_BLOCK_BUCKETS	4096				// per 256 byte region lists, see Sh2InvalidateCode()
+
+typedef void (*Sh2OpHandler)(UINT16 opcode);
+
+typedef struct
+{
+	Sh2OpHandler handler;
+	UINT16 opcode;
+} Sh2BlockOp;
+
+typedef struct
+{
+	UINT32 pc;									// ~0 = empty
+	INT32 nOps;
+	UINT32 nRegion[2];							// code regions covered, [1] = ~0 if only one
+	INT32 nNext[2], nPrev[2];					// bucket list links (block * 2 + n), -1 = end
+	Sh2BlockOp op[SH2_BLOCK_OPS];
+} Sh2Block;
+
+static Sh2Block * pSh2Blocks = NULL;
+static INT32 * pSh2BlockBucket = NULL;			// first link in each bucket, -1 = empty
+static UINT32 nSh2BlockGeneration = 0;			// bumped whenever blocks are dropped
+
+static const Sh2OpHandler Sh2OpGroup[16] = {
+	op0000, op0001, op0010, op0011, op0100, op0101, op0110, op0111,
+	op1000, op1001, op1010, op1011, op1100, op1101, op1110, op1111
+};
+
+// Opcodes after which execution (usually) continues somewhere else
+static inline int Sh2BlockEnds(UINT16 opcode)
+{
+	switch (opcode >> 12) {
+		case 0x0: {
+			switch (opcode & 0xff) {
+				case 0x03: case 0x0b: case 0x1b: case 0x23: case 0x2b: return 1;	// BSRF RTS SLEEP BRAF RTE
+			}
+			return 0;
+		}
+		case 0x4: return ((opcode & 0xff) == 0x0b || (opcode & 0xff) == 0x2b);		// JSR JMP
+		case 0x8: return ((opcode & 0x0900) == 0x0900);							// BT BF BT/S BF/S
+		case 0xa:
+		case 0xb: return 1;															// BRA BSR
+		case 0xc: return ((opcode & 0x0f00) == 0x0300);							// TRAPA
+	}
+
+	return 0;
+}
+
+static void Sh2BlockFlush()
+{
+	if (pSh2Blocks) {
+		for (int i = 0; i < SH2_BLOCK_COUNT; i++) {
+			pSh2Blocks[i].pc = ~0;
+		}
+		for (int i = 0; i < SH2_BLOCK_BUCKETS; i++) {
+			pSh2BlockBucket[i] = -1;
+		}
+	}
+	if (pSh2CodeMap) {
+		memset(pSh2CodeMap, 0, (1 << 21) / 8);
+	}
+
+	nSh2BlockGeneration++;
+}
+
+static void Sh2BlockExit()
+{
+	if (pSh2Blocks) {
+		free(pSh2Blocks);
+		pSh2Blocks = NULL;
+	}
+	if (pSh2BlockBucket) {
+		free(pSh2BlockBucket);
+		pSh2BlockBucket = NULL;
+	}
+	if (pSh2CodeMap) {
+		free(pSh2CodeMap);
+		pSh2CodeMap = NULL;
+	}
+}
+
+static int Sh2BlockInit()
+{
+	Sh2BlockExit();
+
+	nSh2ExpectOps = 0;
+	nSh2LockstepHalt = 0;
+
+	if (nSh2BlockCacheMode == SH2_BLOCKCACHE_OFF) {
+		return 0;
+	}
+
+	pSh2Blocks = (Sh2Block *)malloc(sizeof(Sh2Block) * SH2_BLOCK_COUNT);
+	pSh2BlockBucket = (INT32 *)malloc(sizeof(INT32) * SH2_BLOCK_BUCKETS);
+	pSh2CodeMap = (UINT32 *)malloc((1 << 21) / 8);
+
+	if (pSh2Blocks == NULL || pSh2BlockBucket == NULL || pSh2CodeMap == NULL) {
+		bprintf(PRINT_ERROR, _T("SH2 block cache: out of memory, using the interpreter\n"));
+		Sh2BlockExit();
+		return 1;
+	}
+
+	Sh2BlockFlush();
+
+	return 0;
+}
+
+// Each block is listed in the bucket of every code region it covers (at most two,
+// a block is shorter than a region). Neighbouring regions never share a bucket.
+static void Sh2BlockLink(INT32 nBlock)
+{
+	Sh2Block * b = &pSh2Blocks[nBlock];
+
+	for (INT32 n = 0; n < 2 && b->nRegion[n] != ~0U; n++) {
+		INT32 * pHead = &pSh2BlockBucket[b->nRegion[n] & (SH2_BLOCK_BUCKETS - 1)];
+		INT32 nLink = nBlock * 2 + n;
+
+		b->nPrev[n] = -1;
+		b->nNext[n] = *pHead;
+		if (*pHead >= 0) {
+			pSh2Blocks[*pHead >> 1].nPrev[*pHead & 1] = nLink;
+		}
+		*pHead = nLink;
+	}
+}
+
+static void Sh2BlockUnlink(INT32 nBlock)
+{
+	Sh2Block * b = &pSh2Blocks[nBlock];
+
+	for (INT32 n = 0; n < 2 && b->nRegion[n] != ~0U; n++) {
+		if (b->nPrev[n] >= 0) {
+			pSh2Blocks[b->nPrev[n] >> 1].nNext[b->nPrev[n] & 1] = b->nNext[n];
+		} else {
+			pSh2BlockBucket[b->nRegion[n] & (SH2_BLOCK_BUCKETS - 1)] = b->nNext[n];
+		}
+		if (b->nNext[n] >= 0) {
+			pSh2Blocks[b->nNext[n] >> 1].nPrev[b->nNext[n] & 1] = b->nPrev[n];
+		}
+	}
+
+	b->pc = ~0;
+}
+
+// Drop every block that has code in the 256 byte region containing A
+static void Sh2InvalidateCode(UINT32 A)
+{
+	UINT32 nRegion = SH2_CODE_INDEX(A);
+
+	pSh2CodeMap[nRegion >> 5] &= ~(1 << (nRegion & 31));
+
+	INT32 nLink = pSh2BlockBucket[nRegion & (SH2_BLOCK_BUCKETS - 1)];
+
+	while (nLink >= 0) {
+		Sh2Block * b = &pSh2Blocks[nLink >> 1];
+		INT32 nNext = b->nNext[nLink & 1];
+
+		// the block's other link is in another bucket, so nNext stays valid
+		if (b->nRegion[nLink & 1] == nRegion) {
+			Sh2BlockUnlink(nLink >> 1);
+		}
+
+		nLink = nNext;
+	}
+
+	nSh2BlockGeneration++;
+}
+
+static void Sh2InvalidateCodeRange(UINT32 nStart, UINT32 nEnd)
+{
+	if (pSh2CodeMap == NULL) {
+		return;
+	}
+
+	for (unsigned long long a = nStart & ~0xff; a <= nEnd; a += 0x100) {
+		if (SH2_CODE_TEST((UINT32)a)) {
+			Sh2InvalidateCode((UINT32)a);
+		}
+	}
+}
+
+// Find (or build) the block starting at pc, NULL if pc isn't in a direct fetch page
+static Sh2BlockOp * Sh2BlockLookup(UINT32 pc, INT32 * pnOps)
+{
+	INT32 nBlock = (pc >> 1) & (SH2_BLOCK_COUNT - 1);
+	Sh2Block * b = &pSh2Blocks[nBlock];
+
+	if (b->pc != pc) {
+		unsigned char * pr = pSh2Ext->MemMap[(pc >> SH2_SHIFT) + SH2_WADD * 2];
+
+		if ((uintptr_t)pr < SH2_MAXHANDLER) {
+			return NULL;
+		}
+
+		if (b->pc != ~0U) {
+			Sh2BlockUnlink(nBlock);
+		}
+
+		UINT32 A = pc;
+		INT32 nOps = 0;
+
+		// Stop at the end of the page, the next one may be mapped elsewhere
+		while (nOps < SH2_BLOCK_OPS && (A >> SH2_SHIFT) == (pc >> SH2_SHIFT)) {
+#ifdef LSB_FIRST
+			UINT16 opcode = *((unsigned short *)(pr + ((A ^ 2) & SH2_PAGEM)));
+#else
+			UINT16 opcode = *((unsigned short *)(pr + (A & SH2_PAGEM)));
+#endif
+			b->op[nOps].handler = Sh2OpGroup[opcode >> 12];
+			b->op[nOps].opcode = opcode;
+			nOps++;
+
+			UINT32 nRegion = SH2_CODE_INDEX(A);
+			pSh2CodeMap[nRegion >> 5] |= 1 << (nRegion & 31);
+
+			A += 2;
+
+			if (Sh2BlockEnds(opcode)) {
+				break;
+			}
+		}
+
+		b->pc = pc;
+		b->nOps = nOps;
+		b->nRegion[0] = SH2_CODE_INDEX(pc);
+		b->nRegion[1] = SH2_CODE_INDEX(A - 2);
+		if (b->nRegion[1] == b->nRegion[0]) {
+			b->nRegion[1] = ~0;
+		}
+
+		Sh2BlockLink(nBlock);
+	}
+
+	*pnOps = b->nOps;
+
+	return b->op;
+}
+
+// Lockstep mode - see the notes at the top of this section
+#define SH2_UNDO_COUNT		64
+#define SH2_REGFILE_COUNT	24
+
+static const TCHAR * Sh2RegName[SH2_REGFILE_COUNT] = {
+	_T("r0"), _T("r1"), _T("r2"), _T("r3"), _T("r4"), _T("r5"), _T("r6"), _T("r7"),
+	_T("r8"), _T("r9"), _T("r10"), _T("r11"), _T("r12"), _T("r13"), _T("r14"), _T("r15"),
+	_T("pc"), _T("pr"), _T("sr"), _T("gbr"), _T("vbr"), _T("mach"), _T("macl"), _T("delay")
+};
+
+static struct {
+	UINT32 * p;
+	UINT32 v;
+} Sh2Undo[SH2_UNDO_COUNT];
+static INT32 nSh2UndoCount;
+
+static SH2 Sh2Saved;
+static UINT32 nSh2Expect[SH2_REGFILE_COUNT];	// register file the cached block produced
+static UINT32 nSh2ExpectPc;
+static INT32 nSh2ExpectTotal;
+
+static void Sh2GetRegFile(UINT32 * pReg)
+{
+	for (INT32 i = 0; i < 16; i++) {
+		pReg[i] = sh2->r[i];
+	}
+
+	pReg[16] = sh2->pc;
+	pReg[17] = sh2->pr;
+	pReg[18] = sh2->sr;
+	pReg[19] = sh2->gbr;
+	pReg[20] = sh2->vbr;
+	pReg[21] = sh2->mach;
+	pReg[22] = sh2->macl;
+	pReg[23] = sh2->delay;
+}
+
+// Called for every write while replaying: returns 0 to drop it (and end the replay)
+static int Sh2ShadowWrite(unsigned char * pr, UINT32 A)
+{
+	if ((uintptr_t)pr < SH2_MAXHANDLER || SH2_CODE_TEST(A) || nSh2UndoCount == SH2_UNDO_COUNT) {
+		nSh2ShadowFault = 1;
+		return 0;
+	}
+
+	UINT32 * p = (UINT32 *)(pr + (A & SH2_PAGEM & ~3));
+
+	Sh2Undo[nSh2UndoCount].p = p;
+	Sh2Undo[nSh2UndoCount].v = *p;
+	nSh2UndoCount++;
+
+	return 1;
+}
+
+// Run the cached block at pc the way Sh2Run() would, then put everything back.
+// Opcodes that read or write through a handler (or write cached code) can't be
+// replayed without side effects, so the compare covers the opcodes before them.
+static void Sh2BlockReplay(UINT32 pc)
+{
+	INT32 nOps;
+	Sh2BlockOp * pOp = Sh2BlockLookup(pc & AM, &nOps);
+
+	if (pOp == NULL) {
+		return;
+	}
+
+	Sh2Saved = *sh2;
+#if FAST_OP_FETCH
+	unsigned char * pSavedPr = readop_pr;
+	unsigned char * pSavedBase = pSh2Ext->opbase;
+#endif
+
+	nSh2Shadow = 1;
+	nSh2ShadowFault = 0;
+	nSh2UndoCount = 0;
+
+	INT32 nDone = 0;
+
+	while (nDone < nOps) {
+		UINT32 nRegs[SH2_REGFILE_COUNT];
+		UINT32 nNextPc = sh2->pc + 2;
+
+		Sh2GetRegFile(nRegs);
+
+		sh2->pc += 2;
+		sh2->ppc = sh2->pc;
+		pOp[nDone].handler(pOp[nDone].opcode);
+
+		if (nSh2ShadowFault) {
+			memcpy(nSh2Expect, nRegs, sizeof(nRegs));
+			break;
+		}
+
+		nDone++;
+		Sh2GetRegFile(nSh2Expect);
+
+		// Sh2Run() leaves the block here too
+		if (sh2->delay || sh2->pc != nNextPc) {
+			break;
+		}
+	}
+
+	while (nSh2UndoCount > 0) {
+		nSh2UndoCount--;
+		*Sh2Undo[nSh2UndoCount].p = Sh2Undo[nSh2UndoCount].v;
+	}
+
+	nSh2Shadow = 0;
+
+	*sh2 = Sh2Saved;
+#if FAST_OP_FETCH
+	readop_pr = pSavedPr;
+	pSh2Ext->opbase = pSavedBase;
+#endif
+
+	nSh2ExpectPc = pc;
+	nSh2ExpectOps = nDone;
+	nSh2ExpectTotal = nDone;
+}
+
+// The interpreter has run the replayed opcodes, compare the register files
+static void Sh2BlockCompare()
+{
+	UINT32 nRegs[SH2_REGFILE_COUNT];
+
+	Sh2GetRegFile(nRegs);
+
+	if (memcmp(nRegs, nSh2Expect, sizeof(nRegs)) == 0) {
+		return;
+	}
+
+	bprintf(PRINT_ERROR, _T("SH2 lockstep: block at %08x differs from the interpreter after %d opcodes, cpu stopped\n"), nSh2ExpectPc, nSh2ExpectTotal);
+
+	for (INT32 i = 0; i < SH2_REGFILE_COUNT; i++) {
+		if (nRegs[i] != nSh2Expect[i]) {
+			bprintf(PRINT_ERROR, _T("    %s: interpreter %08x, cache %08x\n"), Sh2RegName[i], nRegs[i], nSh2Expect[i]);
+		}
+	}
+
+	nSh2LockstepHalt = 1;
+	sh2->sh2_icount = 0;
+}
+
+void Sh2SetBlockCache(int nMode)
+{
+	nSh2BlockCacheMode = nMode;
+
+	if (Sh2Ext) {
+		Sh2BlockInit();
+	}
+}
+
 /*****************************************************************************
  *  MAME CPU INTERFACE
  *****************************************************************************/
@@ -3310,14 +3785,47 @@ int Sh2Run(int cycles)
 
 #else
 
+SH2_INLINE void sh2_dispatch(UINT16 opcode)
+{
+		switch (opcode & ( 15 << 12))
+		{
+		case  0<<12: op0000(opcode); break;
+		case  1<<12: op0001(opcode); break;
+		case  2<<12: op0010(opcode); break;
+		case  3<<12: op0011(opcode); break;
+		case  4<<12: op0100(opcode); break;
+		case  5<<12: op0101(opcode); break;
+		case  6<<12: op0110(opcode); break;
+		case  7<<12: op0111(opcode); break;
+		case  8<<12: op1000(opcode); break;
+		case  9<<12: op1001(opcode); break;
+		case 10<<12: op1010(opcode); break;
+		case 11<<12: op1011(opcode); break;
+		case 12<<12: op1100(opcode); break;
+		case 13<<12: op1101(opcode); break;
+		case 14<<12: op1110(opcode); break;
+		default: op1111(opcode); break;
+		}
+}
+
 int Sh2Run(int cycles)
 {
 #if defined FBA_DEBUG
 	if (!DebugCPU_SH2Initted) bprintf(PRINT_ERROR, _T("Sh2Run called without init\n"));
 #endif
 
+	if (nSh2LockstepHalt) {
+		sh2->cycle_counts += cycles;
+		return cycles;
+	}
+
 	sh2->sh2_icount = cycles;
 	sh2->sh2_cycles_to_run = cycles;
+
+	// Block cache position; only followed while pc runs on sequentially
+	Sh2BlockOp * pOp = NULL;
+	INT32 nOpsLeft = 0;
+	UINT32 nOpPc = 0, nOpGeneration = 0;
 	
 	do
 	{
@@ -3329,40 +3837,47 @@ int Sh2Run(int cycles)
 			opcode = cpu_readop16(sh2->delay & AM);
 			change_pc(sh2->pc & AM);
 			sh2->delay = 0;
+
+			sh2->ppc = sh2->pc;
+			sh2_dispatch(opcode);
 		} else {
-			//opcode = cpu_readop16(WORD_XOR_BE((UINT32)(sh2->pc & AM)));
-			opcode = cpu_readop16(sh2->pc & AM);
-			sh2->pc += 2;
-		}
+			if (pSh2Blocks && nSh2BlockCacheMode == SH2_BLOCKCACHE_LOCKSTEP) {
+				if (nSh2ExpectOps == 0) Sh2BlockReplay(sh2->pc);
+			} else if (pSh2Blocks && (nOpsLeft == 0 || sh2->pc != nOpPc || nOpGeneration != nSh2BlockGeneration)) {
+				pOp = Sh2BlockLookup(sh2->pc & AM, &nOpsLeft);
+				nOpPc = sh2->pc;
+				nOpGeneration = nSh2BlockGeneration;
+				if (pOp == NULL) nOpsLeft = 0;
+			}
 
-		sh2->ppc = sh2->pc;
+			if (nOpsLeft) {
+				Sh2BlockOp * op = pOp++;
+				nOpsLeft--;
+				nOpPc += 2;
 
-		switch (opcode & ( 15 << 12))
-		{
-		case  0<<12: op0000(opcode); break;
-		case  1<<12: op0001(opcode); break;
-		case  2<<12: op0010(opcode); break;
-		case  3<<12: op0011(opcode); break;
-		case  4<<12: op0100(opcode); break;
-		case  5<<12: op0101(opcode); break;
-		case  6<<12: op0110(opcode); break;
-		case  7<<12: op0111(opcode); break;
-		case  8<<12: op1000(opcode); break;
-		case  9<<12: op1001(opcode); break;
-		case 10<<12: op1010(opcode); break;
-		case 11<<12: op1011(opcode); break;
-		case 12<<12: op1100(opcode); break;
-		case 13<<12: op1101(opcode); break;
-		case 14<<12: op1110(opcode); break;
-		default: op1111(opcode); break;
+				sh2->pc += 2;
+				sh2->ppc = sh2->pc;
+				op->handler(op->opcode);
+			} else {
+				//opcode = cpu_readop16(WORD_XOR_BE((UINT32)(sh2->pc & AM)));
+				opcode = cpu_readop16(sh2->pc & AM);
+				sh2->pc += 2;
+
+				sh2->ppc = sh2->pc;
+				sh2_dispatch(opcode);
+
+				if (nSh2ExpectOps && --nSh2ExpectOps == 0) Sh2BlockCompare();
+			}
 		}
             }
 #endif
 
 		if(sh2->test_irq && !sh2->delay)
 		{
+			UINT32 pc = sh2->pc;
 			CHECK_PENDING_IRQ(/*"mame_sh2_execute"*/);
 			sh2->test_irq = 0;
+			if (sh2->pc != pc) nSh2ExpectOps = 0;	// lockstep: an irq was taken mid-block
 		}
 
 		sh2->sh2_total_cycles++;
@@ -3390,6 +3905,8 @@ int Sh2Run(int cycles)
 		
 	} while( sh2->sh2_icount > 0 );
 	
+	nSh2ExpectOps = 0;		// the driver may touch memory before the next run
+	
 	sh2->cycle_counts += cycles - (UINT32)sh2->sh2_icount;
 	
 	sh2->sh2_cycles_to_run = sh2->sh2_icount;
@@ -3537,6 +4054,9 @@ int Sh2Scan(int nAction)
 				change_pc(sh2->pc & AM);
 			}
 #endif
+			if (nAction & ACB_WRITE) {
+				Sh2BlockFlush();
+			}
 		}
 
 	}
@@ -50,3 +50,10 @@ void Sh2BurnCycles(int cycles);
 
 int Sh2Scan(int);
 
+// Optional block cache (see sh2.cpp), off by default
+#define SH2_BLOCKCACHE_OFF			0
+#define SH2_BLOCKCACHE_ON			1
+#define SH2_BLOCKCACHE_LOCKSTEP		2	// interpreter, checked against each cached block
+
+void Sh2SetBlockCache(int nMode);
+
@@ -111,6 +111,11 @@ static Z80ReadOpArgHandler Z80CPUReadOpArg;
 
 unsigned char Z80Vector = 0xff;
 
+/* pre-decoded instruction cache, see Z80SetDecodeMap() */
+static Z80_DECODED **Z80DecodeMap = NULL;
+static int Z80DecodeLockstep = 0;
+static const UINT8 *Z80ArgCache = NULL;	/* operands of the cached instruction running now */
+
 #define VERBOSE 0
 
 #define LOG(x)	//do { if (VERBOSE) logerror x; } while (0)
@@ -314,6 +319,25 @@ static const UINT8 cc_ex[0x100] = {
  6, 0, 0, 0, 7, 0, 0, 2, 6, 0, 0, 0, 7, 0, 0, 2,
  6, 0, 0, 0, 7, 0, 0, 2, 6, 0, 0, 0, 7, 0, 0, 2};
 
+/* operand bytes read by ARG()/ARG16() for each unprefixed opcode */
+static const UINT8 z80_arglen[0x100] = {
+ 0, 2, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0,
+ 1, 2, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 1, 0,
+ 1, 2, 2, 0, 0, 0, 1, 0, 1, 0, 2, 0, 0, 0, 1, 0,
+ 1, 2, 2, 0, 0, 0, 1, 0, 1, 0, 2, 0, 0, 0, 1, 0,
+ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+ 0, 0, 2, 2, 2, 0, 1, 0, 0, 0, 2, 0, 2, 2, 1, 0,
+ 0, 0, 2, 1, 2, 0, 1, 0, 0, 0, 2, 1, 2, 0, 1, 0,
+ 0, 0, 2, 0, 2, 0, 1, 0, 0, 0, 2, 0, 2, 0, 1, 0,
+ 0, 0, 2, 0, 2, 0, 1, 0, 0, 0, 2, 0, 2, 0, 1, 0};
+
 static const UINT8 *cc[6];
 #define Z80_TABLE_dd	Z80_TABLE_xy
 #define Z80_TABLE_fd	Z80_TABLE_xy
@@ -625,6 +649,7 @@ Z80_INLINE UINT8 ARG(void)
 {
 	unsigned pc = PCD;
 	PC++;
+	if (Z80ArgCache) return *Z80ArgCache++;
 	return cpu_readop_arg(pc);
 }
 
@@ -632,9 +657,87 @@ Z80_INLINE UINT32 ARG16(void)
 {
 	unsigned pc = PCD;
 	PC += 2;
+	if (Z80ArgCache) {
+		UINT32 r = Z80ArgCache[0] | (Z80ArgCache[1] << 8);
+		Z80ArgCache += 2;
+		return r;
+	}
 	return cpu_readop_arg(pc) | (cpu_readop_arg((pc+1)&0xffff) << 8);
 }
 
+/****************************************************************
+ * Decode the instruction at pc into its cache entry. Only the
+ * unprefixed opcode and its operands are kept; prefixed opcodes
+ * fetch the rest of themselves as usual. Operands that run into
+ * the next page are never cached, that page may be mapped
+ * differently.
+ ***************************************************************/
+static void Z80Decode(Z80_DECODED *d, unsigned pc)
+{
+	UINT8 op = cpu_readop(pc);
+	UINT8 len = z80_arglen[op];
+
+	if ((pc & 0xff) + len > 0xff) {
+		d->len = Z80_DECODE_SKIP;
+		return;
+	}
+
+	d->op = op;
+	d->arg[0] = (len > 0) ? cpu_readop_arg((pc+1)&0xffff) : 0;
+	d->arg[1] = (len > 1) ? cpu_readop_arg((pc+2)&0xffff) : 0;
+	d->len = len;
+}
+
+/* lockstep mode: check a cached instruction against a fresh fetch */
+static void Z80DecodeVerify(Z80_DECODED *d, unsigned pc)
+{
+	Z80_DECODED f;
+
+	Z80Decode(&f, pc);
+
+	if (f.op != d->op || f.len != d->len || f.arg[0] != d->arg[0] || f.arg[1] != d->arg[1]) {
+		bprintf(PRINT_ERROR, _T("Z80 decode cache: stale entry at %04x (%02x %02x %02x, memory has %02x %02x %02x)\n"),
+			pc, d->op, d->arg[0], d->arg[1], f.op, f.arg[0], f.arg[1]);
+		*d = f;
+	}
+}
+
+static UINT8 ROP_DECODED_SLOW(Z80_DECODED *d)
+{
+	if (d->len == Z80_DECODE_EMPTY) {
+		Z80Decode(d, PCD);
+	} else if (d->len != Z80_DECODE_SKIP) {
+		Z80DecodeVerify(d, PCD);
+	}
+
+	if (d->len == Z80_DECODE_SKIP) {
+		return ROP();
+	}
+
+	PC++;
+	Z80ArgCache = d->len ? d->arg : NULL;
+
+	return d->op;
+}
+
+/****************************************************************
+ * Fetch the next opcode from the decode cache, setting up its
+ * operands for ARG()/ARG16(). Every instruction reads all of
+ * its operands before it can touch memory (and so clear its
+ * own page), so they are used in place.
+ ***************************************************************/
+Z80_INLINE UINT8 ROP_DECODED(Z80_DECODED *d)
+{
+	if (d->len >= Z80_DECODE_SKIP || Z80DecodeLockstep) {
+		return ROP_DECODED_SLOW(d);
+	}
+
+	PC++;
+	Z80ArgCache = d->len ? d->arg : NULL;
+
+	return d->op;
+}
+
 /***************************************************************
  * Calculate the effective address EA of an opcode using
  * IX+offset resp. IY+offset addressing.
@@ -3534,18 +3637,40 @@ int Z80Execute(int cycles)
 		Z80.nmi_pending = FALSE;
 	}
 
-	do
+	/* the decode cache only ever changes between runs, so pick the loop once */
+	if (Z80DecodeMap)
 	{
-		/* check for IRQs before each instruction */
-		if (Z80.irq_state != Z80_CLEAR_LINE && IFF1 && !Z80.after_ei)
-			take_interrupt();
-		Z80.after_ei = FALSE;
-
-		PRVPC = PCD;
-//		CALL_DEBUGGER(PCD);
-		R++;
-		EXEC_INLINE(op,ROP());
-	} while( z80_ICount > 0 );
+		do
+		{
+			/* check for IRQs before each instruction */
+			if (Z80.irq_state != Z80_CLEAR_LINE && IFF1 && !Z80.after_ei)
+				take_interrupt();
+			Z80.after_ei = FALSE;
+
+			PRVPC = PCD;
+//			CALL_DEBUGGER(PCD);
+			R++;
+			Z80_DECODED *page = Z80DecodeMap[PCD >> 8];
+			unsigned opcode = page ? ROP_DECODED(page + (PCD & 0xff)) : ROP();
+			EXEC_INLINE(op,opcode);
+			Z80ArgCache = NULL;
+		} while( z80_ICount > 0 );
+	}
+	else
+	{
+		do
+		{
+			/* check for IRQs before each instruction */
+			if (Z80.irq_state != Z80_CLEAR_LINE && IFF1 && !Z80.after_ei)
+				take_interrupt();
+			Z80.after_ei = FALSE;
+
+			PRVPC = PCD;
+//			CALL_DEBUGGER(PCD);
+			R++;
+			EXEC_INLINE(op,ROP());
+		} while( z80_ICount > 0 );
+	}
 
 	Z80.cycles_left = 0;
 	
@@ -3642,6 +3767,12 @@ void Z80SetCPUOpArgReadHandler(Z80ReadOpArgHandler handler)
 	Z80CPUReadOpArg = handler;
 }
 
+void Z80SetDecodeMap(Z80_DECODED **map, int lockstep)
+{
+	Z80DecodeMap = map;
+	Z80DecodeLockstep = lockstep;
+}
+
 int ActiveZ80GetPC()
 {
 	return Z80.pc.w.l;
@@ -86,6 +86,21 @@ void Z80SetProgramWriteHandler(Z80WriteProgHandler handler);
 void Z80SetCPUOpReadHandler(Z80ReadOpHandler handler);
 void Z80SetCPUOpArgReadHandler(Z80ReadOpArgHandler handler);
 
+/* Pre-decoded instruction cache: map points to 256 pages (NULL = fetch as
+   usual) of one entry per address, filled in as code runs. Whoever owns the
+   map clears a page (len = Z80_DECODE_EMPTY) whenever its memory changes. */
+typedef struct
+{
+	UINT8	op;			/* unprefixed opcode */
+	UINT8	len;		/* operand bytes in arg[], or Z80_DECODE_* */
+	UINT8	arg[2];
+} Z80_DECODED;
+
+#define Z80_DECODE_EMPTY	0xff	/* not decoded yet */
+#define Z80_DECODE_SKIP		0xfe	/* operands cross a page, always fetch */
+
+void Z80SetDecodeMap(Z80_DECODED **map, int lockstep);
+
 int ActiveZ80GetPC();
 int ActiveZ80GetBC();
 int ActiveZ80GetDE();
@@ -1,6 +1,7 @@
 // Z80 (Zed Eight-Ty) Interface
 #include "burnint.h"
 #include "z80_intf.h"
+#include "burn_trace.h"
 
 #define MAX_Z80		8
 static struct ZetExt * ZetCPUContext[MAX_Z80] = { NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL };
@@ -21,6 +22,11 @@ struct ZetExt {
 	pZetWriteHandler ZetWrite;
 	
 	UINT8 BusReq;
+
+	Z80_DECODED* pDecodeMap[0x100];		// pre-decoded pages handed to the core, NULL = fetch as usual
+	UINT8* pDecodeOp[0x100];			// fetch maps each decoded page was filled from
+	UINT8* pDecodeArg[0x100];
+	Z80_DECODED* pDecodePages;
 };
  
 static INT32 nZetCyclesDone[MAX_Z80];
@@ -32,6 +38,8 @@ static INT32 nOpenedCPU = -1;
 static INT32 nCPUCount = 0;
 INT32 nHasZet = -1;
 
+INT32 nZetDecodeCacheMode = ZET_DECODECACHE_OFF;
+
 UINT8 __fastcall ZetDummyReadHandler(UINT16) { return 0; }
 void __fastcall ZetDummyWriteHandler(UINT16, UINT8) { }
 UINT8 __fastcall ZetDummyInHandler(UINT16) { return 0; }
@@ -111,6 +119,81 @@ UINT8 __fastcall ZetReadOpArg(UINT32 a)
 	return 0;
 }
 
+// A fetch page is decoded only when its opcodes and operands come from memory the driver loaded
+// roms into (see BurnRomRegionCheck()), and the write map doesn't point at it. Ram mapped as rom,
+// shared ram and ram written through a mirror or by another cpu are all fetched as usual, so
+// writes never have to be checked against the cache. A driver that patches rom while running
+// must do it through ZetWriteRom().
+static void ZetDecodeUpdate(struct ZetExt *pExt, INT32 nPage, INT32 bFlush)
+{
+	if (pExt->pDecodePages == NULL) return;
+
+	UINT8 **pMemMap = pExt->pZetMemMap;
+	UINT8 *pOp = pMemMap[0x200 | nPage];
+	UINT8 *pArg = pMemMap[0x300 | nPage];
+	UINT8 *pWrite = pMemMap[0x100 | nPage];
+
+	if (pOp == NULL || pArg == NULL || pWrite == pOp || pWrite == pArg || !BurnRomRegionCheck(pOp, 0x100) || !BurnRomRegionCheck(pArg, 0x100)) {
+		pExt->pDecodeMap[nPage] = NULL;
+		pExt->pDecodeOp[nPage] = pExt->pDecodeArg[nPage] = NULL;
+		return;
+	}
+
+	// remapping a bank that's already there keeps what has been decoded
+	if (!bFlush && pExt->pDecodeMap[nPage] && pExt->pDecodeOp[nPage] == pOp && pExt->pDecodeArg[nPage] == pArg) return;
+
+	pExt->pDecodeMap[nPage] = pExt->pDecodePages + (nPage << 8);
+	pExt->pDecodeOp[nPage] = pOp;
+	pExt->pDecodeArg[nPage] = pArg;
+
+	memset(pExt->pDecodeMap[nPage], Z80_DECODE_EMPTY, 0x100 * sizeof(Z80_DECODED));
+}
+
+static void ZetDecodeInit(struct ZetExt *pExt)
+{
+	if (pExt->pDecodePages) {
+		free(pExt->pDecodePages);
+		pExt->pDecodePages = NULL;
+	}
+
+	memset(pExt->pDecodeMap, 0, sizeof(pExt->pDecodeMap));
+	memset(pExt->pDecodeOp, 0, sizeof(pExt->pDecodeOp));
+	memset(pExt->pDecodeArg, 0, sizeof(pExt->pDecodeArg));
+
+	if (nZetDecodeCacheMode == ZET_DECODECACHE_OFF) return;
+
+	pExt->pDecodePages = (Z80_DECODED*)malloc(0x10000 * sizeof(Z80_DECODED));
+
+	if (pExt->pDecodePages == NULL) {
+		bprintf(PRINT_ERROR, _T("Z80 decode cache: out of memory, fetching as usual\n"));
+		return;
+	}
+
+	for (INT32 i = 0; i < 0x100; i++) {
+		ZetDecodeUpdate(pExt, i, 1);
+	}
+}
+
+static void ZetDecodeSetCore(struct ZetExt *pExt)
+{
+	Z80SetDecodeMap(pExt->pDecodePages ? pExt->pDecodeMap : NULL, nZetDecodeCacheMode == ZET_DECODECACHE_LOCKSTEP);
+}
+
+void ZetSetDecodeCache(INT32 nMode)
+{
+	nZetDecodeCacheMode = nMode;
+
+	for (INT32 i = 0; i < MAX_Z80; i++) {
+		if (ZetCPUContext[i]) {
+			ZetDecodeInit(ZetCPUContext[i]);
+		}
+	}
+
+	if (nOpenedCPU >= 0) {
+		ZetDecodeSetCore(ZetCPUContext[nOpenedCPU]);
+	}
+}
+
 void ZetSetReadHandler(UINT8 (__fastcall *pHandler)(UINT16))
 {
 #if defined FBA_DEBUG
@@ -173,6 +256,23 @@ static UINT8 ZetCheatRead(UINT32 a)
 	return ZetReadByte(a);
 }
 
+static UINT8* ZetCheatMemMap(UINT32 a)
+{
+	if (nOpenedCPU < 0) return NULL;
+
+	UINT8 **pMemMap = ZetCPUContext[nOpenedCPU]->pZetMemMap;
+	UINT32 nPage = (a >> 8) & 0xff;
+	UINT8 *pw = pMemMap[0x100 | nPage];
+
+	// Only when every map that ZetWriteRom touches points at the same ram
+	if (pw == NULL) return NULL;
+	if (pMemMap[0x000 | nPage] != NULL && pMemMap[0x000 | nPage] != pw) return NULL;
+	if (pMemMap[0x200 | nPage] != NULL && pMemMap[0x200 | nPage] != pw) return NULL;
+	if (pMemMap[0x300 | nPage] != NULL && pMemMap[0x300 | nPage] != pw) return NULL;
+
+	return pw + (a & 0xff);
+}
+
 static cpu_core_config ZetCheatCpuConfig =
 {
 	ZetOpen,
@@ -186,7 +286,8 @@ static cpu_core_config ZetCheatCpuConfig =
 	ZetRunEnd,
 	ZetReset,
 	(1<<16),	// 0x10000
-	0
+	0,
+	ZetCheatMemMap
 };
 
 INT32 ZetInit(INT32 nCPU)
@@ -217,6 +318,8 @@ INT32 ZetInit(INT32 nCPU)
 		for (INT32 j = 0; j < (0x0100 * 4); j++) {
 			ZetCPUContext[nCPU]->pZetMemMap[j] = NULL;
 		}
+
+		ZetDecodeInit(ZetCPUContext[nCPU]);
 	}
 
 	nZetCyclesTotal = 0;
@@ -317,6 +420,10 @@ void ZetWriteRom(UINT16 address, UINT8 data)
 	if (ZetCPUContext[nOpenedCPU]->pZetMemMap[0x300 | (address >> 8)] != NULL) {
 		ZetCPUContext[nOpenedCPU]->pZetMemMap[0x300 | (address >> 8)][address & 0xff] = data;
 	}
+
+	// the byte may be an operand of an instruction starting on the page before
+	ZetDecodeUpdate(ZetCPUContext[nOpenedCPU], address >> 8, 1);
+	ZetDecodeUpdate(ZetCPUContext[nOpenedCPU], ((address >> 8) - 1) & 0xff, 1);
 	
 	ZetWriteProg(address, data);
 }
@@ -332,6 +439,7 @@ void ZetClose()
 	nZetCyclesDone[nOpenedCPU] = nZetCyclesTotal;
 	nZ80ICount[nOpenedCPU] = z80_ICount;
 	Z80EA[nOpenedCPU] = EA;
+	Z80SetDecodeMap(NULL, 0);
 
 	nOpenedCPU = -1;
 }
@@ -349,6 +457,7 @@ void ZetOpen(INT32 nCPU)
 	nZetCyclesTotal = nZetCyclesDone[nCPU];
 	z80_ICount = nZ80ICount[nCPU];
 	EA = Z80EA[nCPU];
+	ZetDecodeSetCore(ZetCPUContext[nCPU]);
 
 	nOpenedCPU = nCPU;
 }
@@ -365,6 +474,8 @@ INT32 ZetGetActive()
 
 INT32 ZetRun(INT32 nCycles)
 {
+	BURN_TRACE_SCOPE("ZetRun", "cpu");
+
 #if defined FBA_DEBUG
 	if (!DebugCPU_ZetInitted) bprintf(PRINT_ERROR, _T("ZetRun called without init\n"));
 	if (nOpenedCPU == -1) bprintf(PRINT_ERROR, _T("ZetRun called when no CPU open\n"));
@@ -424,6 +535,7 @@ INT32 ZetMemCallback(INT32 nStart, INT32 nEnd, INT32 nMode)
 				pMemMap[0x300 + i] = NULL;
 				break;
 		}
+		ZetDecodeUpdate(ZetCPUContext[nOpenedCPU], i, 0);
 	}
 
 	return 0;
@@ -437,8 +549,13 @@ void ZetExit()
 
 	Z80Exit();
 
+	Z80SetDecodeMap(NULL, 0);
+
 	for (INT32 i = 0; i < MAX_Z80; i++) {
 		if (ZetCPUContext[i]) {
+			if (ZetCPUContext[i]->pDecodePages) {
+				free(ZetCPUContext[i]->pDecodePages);
+			}
 			BurnFree (ZetCPUContext[i]);
 		}
 	}
@@ -466,6 +583,7 @@ INT32 ZetUnmapMemory(INT32 nStart, INT32 nEnd, INT32 nFlags)
 		if (nFlags & (1 << 1)) pMemMap[0x100 + i] = NULL; // WRITE
 		if (nFlags & (1 << 2)) pMemMap[0x200 + i] = NULL; // OP
 		if (nFlags & (1 << 3)) pMemMap[0x300 + i] = NULL; // ARG
+		ZetDecodeUpdate(ZetCPUContext[nOpenedCPU], i, 0);
 	}
 
 	return 0;
@@ -486,6 +604,7 @@ void ZetMapMemory(UINT8 *Mem, INT32 nStart, INT32 nEnd, INT32 nFlags)
 		if (nFlags & (1 << 1)) pMemMap[0x100 + i] = Mem + ((i - cStart) << 8); // WRITE
 		if (nFlags & (1 << 2)) pMemMap[0x200 + i] = Mem + ((i - cStart) << 8); // OP
 		if (nFlags & (1 << 3)) pMemMap[0x300 + i] = Mem + ((i - cStart) << 8); // ARG
+		ZetDecodeUpdate(ZetCPUContext[nOpenedCPU], i, 0);
 	}
 }
 
@@ -517,6 +636,7 @@ INT32 ZetMapArea(INT32 nStart, INT32 nEnd, INT32 nMode, UINT8 *Mem)
 				break;
 			}
 		}
+		ZetDecodeUpdate(ZetCPUContext[nOpenedCPU], i, 0);
 	}
 
 	return 0;
@@ -539,6 +659,7 @@ INT32 ZetMapArea(INT32 nStart, INT32 nEnd, INT32 nMode, UINT8 *Mem01, UINT8 *Mem
 	for (UINT16 i = cStart; i <= (nEnd >> 8); i++) {
 		pMemMap[0x200 + i] = Mem01 + ((i - cStart) << 8);
 		pMemMap[0x300 + i] = Mem02 + ((i - cStart) << 8);
+		ZetDecodeUpdate(ZetCPUContext[nOpenedCPU], i, 0);
 	}
 
 	return 0;
@@ -551,6 +672,13 @@ void ZetReset()
 	if (nOpenedCPU == -1) bprintf(PRINT_ERROR, _T("ZetReset called when no CPU open\n"));
 #endif
 
+	// drivers map memory before their roms are loaded or patched, look at every page again
+	if (nOpenedCPU >= 0) {
+		for (INT32 i = 0; i < 0x100; i++) {
+			ZetDecodeUpdate(ZetCPUContext[nOpenedCPU], i, 1);
+		}
+	}
+
 	Z80Reset();
 }
 
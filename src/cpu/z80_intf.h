@@ -61,3 +61,10 @@ void ZetSetInHandler(UINT8 (__fastcall *pHandler)(UINT16));
 void ZetSetOutHandler(void (__fastcall *pHandler)(UINT16, UINT8));
 
 void ZetSetBUSREQLine(INT32 nStatus);
+
+// Optional pre-decoded instruction cache for rom pages (see z80_intf.cpp), off by default
+#define ZET_DECODECACHE_OFF			0
+#define ZET_DECODECACHE_ON			1
+#define ZET_DECODECACHE_LOCKSTEP	2	// also checks each cached instruction against memory
+
+void ZetSetDecodeCache(INT32 nMode);
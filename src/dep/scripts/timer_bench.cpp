@@ -0,0 +1,119 @@
+// Stand-alone benchmark for src/burn/timer.cpp, not part of the build.
+//
+// Runs the timers against a fake Z80 that overshoots each slice by a few cycles, and
+// prints a hash of every timer callback (which timer, and the cycle it fired on) with
+// the average cost of one fired timer, fake cpu included. Two builds of timer.cpp give
+// the same hash if they fire the same timers at the same cycles.
+//
+//   g++ -O2 -DLSB_FIRST -Isrc/burn -Isrc/burn/devices -Isrc/burn/snd -Isrc/cpu [...the
+//       rest of the makefile's include paths] -o timer_bench src/dep/scripts/timer_bench.cpp
+//       src/burn/timer.cpp -Wl,--unresolved-symbols=ignore-all
+//
+//   timer_bench <restarts> <added timers> <frames>
+//
+// restarts 1 has the callback for timer 0 and 1 restart a oneshot a third of the time,
+// like a sound cpu reprogramming the chip. Added timers run at 1000 Hz, 1733 Hz, ...
+
+#include "burnint.h"
+#include "timer.h"
+#include <time.h>
+
+static INT32 nFakeCycles = 0;
+static UINT32 nRandom = 1;
+
+static UINT32 Random()
+{
+	nRandom = nRandom * 1103515245 + 12345;
+	return nRandom >> 8;
+}
+
+// The only cpu the timers are attached to, the other cores are left unresolved
+INT32 ZetRun(INT32 nCycles)
+{
+	if (nCycles <= 0) return 0;
+
+	nCycles += Random() % 4;
+	nFakeCycles += nCycles;
+
+	return nCycles;
+}
+
+INT32 ZetTotalCycles()
+{
+	return nFakeCycles;
+}
+
+void ZetRunEnd()
+{
+}
+
+static UINT64 nHash = 1469598103934665603ULL;
+static INT64 nEvents = 0;
+static INT32 bRestarts = 0;
+
+static void HashEvent(UINT64 v)
+{
+	nHash = (nHash ^ v) * 1099511628211ULL;
+	nEvents++;
+}
+
+static INT32 TimerOverCallback(INT32, INT32 c)
+{
+	HashEvent(nFakeCycles * 4 + c);
+
+	if (bRestarts && (Random() % 3) == 0) {
+		BurnTimerSetOneshot(c, (1 + Random() % 200) / 100000.0);
+	}
+
+	return 0;
+}
+
+static void TimerAddedCallback(INT32 nParam)
+{
+	HashEvent(nFakeCycles * 64 + nParam);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 4) {
+		printf("usage: timer_bench <restarts> <added timers> <frames>\n");
+		return 1;
+	}
+
+	bRestarts = atoi(argv[1]);
+	INT32 nAdded = atoi(argv[2]);
+	INT32 nFrames = atoi(argv[3]);
+
+	BurnTimerInit(TimerOverCallback, NULL);
+	BurnTimerAttachZet(4000000);
+
+	BurnTimerSetRetrig(0, 1.0 / 445);
+	BurnTimerSetOneshot(1, 1.0 / 1000);
+
+	for (INT32 i = 0; i < nAdded; i++) {
+		INT32 c = BurnTimerAdd(TimerAddedCallback, i);
+		if (c < 0) break;
+		BurnTimerSetRetrig(c, 1.0 / (1000 + i * 733));
+	}
+
+	struct timespec tStart, tEnd;
+	clock_gettime(CLOCK_MONOTONIC, &tStart);
+
+	INT32 nCyclesFrame = 4000000 / 60;
+	for (INT32 f = 0; f < nFrames; f++) {
+		for (INT32 i = 0; i < 4; i++) {
+			BurnTimerUpdate((i + 1) * nCyclesFrame / 4);
+		}
+		BurnTimerEndFrame(nCyclesFrame);
+		nFakeCycles = 0;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &tEnd);
+
+	double dNs = (tEnd.tv_sec - tStart.tv_sec) * 1e9 + (tEnd.tv_nsec - tStart.tv_nsec);
+	printf("hash %016llx, %lld timers fired, %.1f ns each\n", (unsigned long long)nHash, (long long)nEvents, nEvents ? dNs / nEvents : 0.0);
+
+	BurnTimerExit();
+
+	return 0;
+}
@@ -11,6 +11,7 @@
 #include <SDL/SDL.h>
 
 #include "burner.h"
+#include "burn_trace.h"
 
 extern "C" {
 #include "matrix.h"
@@ -166,6 +167,8 @@ static void piDestroyVideo()
 
 static void piUpdateEmuDisplay()
 {
+	BURN_TRACE_SCOPE("piUpdateEmuDisplay", "video");
+
 	if (!shader.program) {
 		fprintf(stderr, "Shader not initialized\n");
 		return;